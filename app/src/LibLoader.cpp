@@ -0,0 +1,166 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "LibLoader.h"
+
+#ifndef NO_GUI
+#include <mars/main_gui/MainGUI.h>
+#endif
+
+#include <lib_manager/LibManager.hpp>
+#include <mars/utils/misc.h>
+
+#include <algorithm>
+#include <cstdio>
+
+namespace mars {
+  namespace app {
+
+    // slower libraries are listed first in the report
+    static bool slowerFirst(const std::pair<long long, std::string> &a,
+                            const std::pair<long long, std::string> &b) {
+      return a.first > b.first;
+    }
+
+    LibLoader::LibLoader(lib_manager::LibManager *libManager)
+      : libManager(libManager), mainGui(NULL), lazy(false) {
+    }
+
+    void LibLoader::addDeferrable(const std::string &libName) {
+      deferrable.insert(libName);
+    }
+
+    void LibLoader::loadTimed(const std::string &libName, bool silent) {
+      Timing timing;
+      long long start = utils::getTime();
+      libManager->loadLibrary(libName, NULL, silent);
+      timing.name = libName;
+      timing.ms = utils::getTimeDiff(start);
+      timing.library = true;
+      timings.push_back(timing);
+    }
+
+    void LibLoader::load(const std::string &libName, bool silent) {
+      if(lazy && deferrable.count(libName)) {
+        if(std::find(deferred.begin(), deferred.end(), libName) == deferred.end()) {
+          deferred.push_back(libName);
+          deferredLoaded.push_back(false);
+        }
+        return;
+      }
+      loadTimed(libName, silent);
+    }
+
+    bool LibLoader::loadConfigFile(const std::string &filename) {
+      FILE *file = fopen(filename.c_str(), "r");
+      if(!file) return false;
+
+      char line[255];
+      while(fgets(line, sizeof(line), file)) {
+        std::string libName = utils::trim(line);
+        // ignore empty lines and comments
+        if(libName.empty() || libName[0] == '#') continue;
+        load(libName);
+      }
+      fclose(file);
+      return true;
+    }
+
+    bool LibLoader::loadDeferred(const std::string &libName) {
+      std::vector<std::string>::iterator it;
+      it = std::find(deferred.begin(), deferred.end(), libName);
+      if(it == deferred.end()) return false;
+      size_t index = it - deferred.begin();
+      if(deferredLoaded[index]) return true;
+
+      long long start = utils::getTime();
+      libManager->loadLibrary(libName);
+      deferredLoaded[index] = true;
+      fprintf(stderr, "LibLoader: loaded %s on demand in %lld ms\n",
+              libName.c_str(), utils::getTimeDiff(start));
+      return true;
+    }
+
+    void LibLoader::addMenuEntries(main_gui::MainGUI *mainGui) {
+#ifndef NO_GUI
+      this->mainGui = mainGui;
+      if(!mainGui) return;
+      for(size_t i=0; i<deferred.size(); ++i) {
+        mainGui->addGenericMenuAction("../Plugins/"+deferred[i], (int)i,
+                                      this, 0, "", false, 1);
+      }
+#else
+      (void)mainGui;
+#endif
+    }
+
+#ifndef NO_GUI
+    void LibLoader::menuAction(int action, bool checked) {
+      (void)checked;
+      if(action < 0 || action >= (int)deferred.size()) return;
+      loadDeferred(deferred[action]);
+      // the entry stays checked, a plugin can not be unloaded from here
+      if(mainGui) {
+        mainGui->setMenuActionSelected("../Plugins/"+deferred[action], true);
+      }
+    }
+#endif
+
+    void LibLoader::addTiming(const std::string &step, long long ms) {
+      Timing timing;
+      timing.name = step;
+      timing.ms = ms;
+      timing.library = false;
+      timings.push_back(timing);
+    }
+
+    void LibLoader::printReport(long long totalMs) const {
+      std::vector<std::pair<long long, std::string> > libs;
+      long long libMs = 0;
+
+      fprintf(stderr, "MARS startup took %lld ms\n", totalMs);
+      for(size_t i=0; i<timings.size(); ++i) {
+        if(timings[i].library) {
+          libs.push_back(std::make_pair(timings[i].ms, timings[i].name));
+          libMs += timings[i].ms;
+        }
+        else {
+          fprintf(stderr, "  %-28s %6lld ms\n", timings[i].name.c_str(),
+                  timings[i].ms);
+        }
+      }
+      fprintf(stderr, "  %-28s %6lld ms (%lu libraries)\n", "loading libraries",
+              libMs, (unsigned long)libs.size());
+      std::sort(libs.begin(), libs.end(), slowerFirst);
+      for(size_t i=0; i<libs.size() && i<10; ++i) {
+        fprintf(stderr, "    %-26s %6lld ms\n", libs[i].second.c_str(),
+                libs[i].first);
+      }
+      if(!deferred.empty()) {
+        fprintf(stderr, "  deferred until first use:");
+        for(size_t i=0; i<deferred.size(); ++i) {
+          fprintf(stderr, " %s", deferred[i].c_str());
+        }
+        fprintf(stderr, "\n");
+      }
+    }
+
+  } // end of namespace app
+} // end of namespace mars
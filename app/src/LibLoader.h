@@ -0,0 +1,116 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file LibLoader.h
+ * \brief Loads the libraries at startup, measures the time spent per
+ *        library and defers optional GUI plugins until they are used.
+ */
+
+#ifndef MARS_APP_LIB_LOADER_H
+#define MARS_APP_LIB_LOADER_H
+
+#ifdef _PRINT_HEADER_
+  #warning "LibLoader.h"
+#endif
+
+#ifndef NO_GUI
+#include <mars/main_gui/MenuInterface.h>
+#endif
+
+#include <set>
+#include <string>
+#include <vector>
+
+namespace lib_manager {
+  class LibManager;
+}
+
+namespace mars {
+
+  namespace main_gui {
+    class MainGUI;
+  }
+
+  namespace app {
+
+    /**
+     * In lazy mode the optional GUI plugins (plotters, consoles, property
+     * browsers, ...) are not loaded at startup. They get an entry in the
+     * "Plugins" menu instead and are loaded when the entry is selected for
+     * the first time.
+     */
+    class LibLoader
+#ifndef NO_GUI
+      : public main_gui::MenuInterface
+#endif
+    {
+    public:
+      explicit LibLoader(lib_manager::LibManager *libManager);
+
+      void setLazy(bool lazy) {this->lazy = lazy;}
+      bool isLazy() const {return lazy;}
+      /** \brief Marks \a libName as optional GUI plugin. */
+      void addDeferrable(const std::string &libName);
+
+      /**
+       * \brief Loads \a libName or, in lazy mode, defers it if it is an
+       *        optional GUI plugin.
+       */
+      void load(const std::string &libName, bool silent=false);
+      /** \brief Like LibManager::loadConfigFile but timed per library. */
+      bool loadConfigFile(const std::string &filename);
+      /** \brief Loads a deferred library now. */
+      bool loadDeferred(const std::string &libName);
+
+      /** \brief Adds the menu entries of the deferred libraries. */
+      void addMenuEntries(main_gui::MainGUI *mainGui);
+
+      /** \brief Records the duration of a startup step besides the libraries. */
+      void addTiming(const std::string &step, long long ms);
+      void printReport(long long totalMs) const;
+
+#ifndef NO_GUI
+      virtual void menuAction(int action, bool checked = false);
+#endif
+
+    private:
+      struct Timing {
+        std::string name;
+        long long ms;
+        bool library;
+      };
+
+      lib_manager::LibManager *libManager;
+      main_gui::MainGUI *mainGui;
+      bool lazy;
+      std::set<std::string> deferrable;
+      // deferred libraries, the index is the menu action
+      std::vector<std::string> deferred;
+      std::vector<bool> deferredLoaded;
+      std::vector<Timing> timings;
+
+      void loadTimed(const std::string &libName, bool silent);
+    };
+
+  } // end of namespace app
+} // end of namespace mars
+
+#endif // MARS_APP_LIB_LOADER_H
@@ -25,6 +25,7 @@
  */
 
 #include "MARS.h"
+#include "LibLoader.h"
 
 #ifndef NO_GUI
 #include "GraphicsTimer.h"
@@ -88,8 +89,10 @@ namespace mars {
 		   argConfDir(false) {
       needQApp = true;
       noGUI = false;
+      lazyPlugins = false;
       graphicsTimer = NULL;
       initialized = false;
+      setupLibLoader();
 #ifdef WIN32
       // request a scheduler of 1ms
       timeBeginPeriod(1);
@@ -125,8 +128,10 @@ namespace mars {
 		   argConfDir(false) {
       needQApp = true;
       noGUI = false;
+      lazyPlugins = false;
       graphicsTimer = NULL;
       initialized = false;
+      setupLibLoader();
 #ifdef WIN32
       // request a scheduler of 1ms
       timeBeginPeriod(1);
@@ -146,6 +151,7 @@ namespace mars {
       libManager->releaseLibrary("main_gui");
       libManager->releaseLibrary("cfg_manager");
       releaseEnvireLibs();
+      delete libLoader;
       if(ownLibManager) delete libManager;
 
 #ifdef WIN32
@@ -154,6 +160,19 @@ namespace mars {
 #endif //WIN32
     }
 
+    void MARS::setupLibLoader() {
+      startTime = utils::getTime();
+      libLoader = new LibLoader(libManager);
+      // optional GUI plugins that are deferred in lazy mode
+      libLoader->addDeferrable("log_console");
+      libLoader->addDeferrable("data_broker_gui");
+      libLoader->addDeferrable("data_broker_plotter");
+      libLoader->addDeferrable("data_broker_plotter2");
+      libLoader->addDeferrable("cfg_manager_gui");
+      libLoader->addDeferrable("lib_manager_gui");
+      libLoader->addDeferrable("CameraGUI");
+    }
+
     void MARS::init() {
       // then check locals
 #ifndef WIN32
@@ -209,20 +228,20 @@ namespace mars {
       if(plugin_config) {
         fprintf(stderr, "MARS::loadCoreLibs: load core libs from core_libs.txt\n");
         fclose(plugin_config);
-        libManager->loadConfigFile(coreConfigFile);
+        libLoader->loadConfigFile(coreConfigFile);
       } else {
         fprintf(stderr, "MARS::loadCoreLibs: Loading default core libraries...\n");
-        libManager->loadLibrary("data_broker");
-        libManager->loadLibrary("mars_sim");
-        libManager->loadLibrary("mars_scene_loader");
-        libManager->loadLibrary("mars_entity_factory");
-        libManager->loadLibrary("mars_smurf");
-        libManager->loadLibrary("mars_smurf_loader");
+        libLoader->load("data_broker");
+        libLoader->load("mars_sim");
+        libLoader->load("mars_scene_loader");
+        libLoader->load("mars_entity_factory");
+        libLoader->load("mars_smurf");
+        libLoader->load("mars_smurf_loader");
         if(!noGUI) {
-          libManager->loadLibrary("main_gui");
-          libManager->loadLibrary("mars_graphics");
-          libManager->loadLibrary("mars_gui");
-          libManager->loadLibrary("entity_view");
+          libLoader->load("main_gui");
+          libLoader->load("mars_graphics");
+          libLoader->load("mars_gui");
+          libLoader->load("entity_view");
         }
       }
     }
@@ -232,15 +251,15 @@ namespace mars {
         fprintf(stderr, "MARS::loadAdditionalLibs: Loading default additional libraries...\n");
         // loading errors will be silent for the following optional libraries
         if(!noGUI) {
-          libManager->loadLibrary("log_console", NULL, true);
-          libManager->loadLibrary("connexion_plugin", NULL, true);
-          libManager->loadLibrary("data_broker_gui", NULL, true);
-          libManager->loadLibrary("cfg_manager_gui", NULL, true);
-          libManager->loadLibrary("lib_manager_gui", NULL, true);
-          libManager->loadLibrary("SkyDomePlugin", NULL, true);
-          libManager->loadLibrary("CameraGUI", NULL, true);
-          libManager->loadLibrary("PythonMars", NULL, true);
-          libManager->loadLibrary("data_broker_plotter2", NULL, true);
+          libLoader->load("log_console", true);
+          libLoader->load("connexion_plugin", true);
+          libLoader->load("data_broker_gui", true);
+          libLoader->load("cfg_manager_gui", true);
+          libLoader->load("lib_manager_gui", true);
+          libLoader->load("SkyDomePlugin", true);
+          libLoader->load("CameraGUI", true);
+          libLoader->load("PythonMars", true);
+          libLoader->load("data_broker_plotter2", true);
         }
       }
     }
@@ -249,10 +268,12 @@ namespace mars {
                      bool handleLibraryLoading) {
 
       if(!initialized) init();
+      libLoader->setLazy(lazyPlugins && !noGUI);
 
       if(handleLibraryLoading) {
         loadCoreLibs();
       }
+      long long stepStart;
 
       // then get the simulation
       mars::interfaces::SimulatorInterface *marsSim;
@@ -267,7 +288,9 @@ namespace mars {
 
       marsGui = libManager->getLibraryAs<mars::interfaces::MarsGuiInterface>("mars_gui");
       if(marsGui) {
+        stepStart = utils::getTime();
         marsGui->setupGui();
+        libLoader->addTiming("setup gui", utils::getTimeDiff(stepStart));
       }
 
 #ifndef NO_GUI
@@ -280,6 +303,7 @@ namespace mars {
         if( (marsGraphics = dynamic_cast<mars::interfaces::GraphicsManagerInterface*>(lib)) ) {
           // init osg
           //initialize graphicsFactory
+          stepStart = utils::getTime();
           if(mainGui) {
             marsGraphics->initializeOSG(NULL);
             QWidget *widget = (QWidget*)marsGraphics->getQTWidget(1);
@@ -290,6 +314,8 @@ namespace mars {
           else {
             marsGraphics->initializeOSG(NULL, false);
           }
+          libLoader->addTiming("initialize graphics",
+                               utils::getTimeDiff(stepStart));
         }
       }
 #endif
@@ -300,18 +326,22 @@ namespace mars {
         FILE *plugin_config = fopen(otherConfigFile.c_str() , "r");
         if(plugin_config) {
           fclose(plugin_config);
-          libManager->loadConfigFile(otherConfigFile);
+          libLoader->loadConfigFile(otherConfigFile);
         } else {
           loadAdditionalLibs();
         }
       }
 
 #ifndef NO_GUI
+      libLoader->addMenuEntries(mainGui);
       // if we have a main gui, show it
       if(mainGui) mainGui->show();
 #endif
 
+      stepStart = utils::getTime();
       control->sim->runSimulation(startThread);
+      libLoader->addTiming("start simulation", utils::getTimeDiff(stepStart));
+      libLoader->printReport(utils::getTimeDiff(startTime));
 
 #ifndef NO_GUI
       if(needQApp) {
@@ -342,6 +372,7 @@ namespace mars {
         {"config_dir", required_argument, 0, 'C'},
         {"no-gui",no_argument,0,'G'},
         {"noQApp",no_argument,0,'Q'},
+        {"lazy-plugins",no_argument,0,'L'},
         {0, 0, 0, 0}
       };
 
@@ -359,9 +390,9 @@ namespace mars {
       while (1) {
 
 #ifdef __linux__
-        c = getopt_long(argc, argv, "GC:Q", long_options, &option_index);
+        c = getopt_long(argc, argv, "GC:QL", long_options, &option_index);
 #else
-        c = getopt_long(argc, argv_copy, "GC:Q", long_options, &option_index);
+        c = getopt_long(argc, argv_copy, "GC:QL", long_options, &option_index);
 #endif
         if (c == -1)
           break;
@@ -381,6 +412,9 @@ namespace mars {
         case 'G':
           noGUI = true;
           break;
+        case 'L':
+          lazyPlugins = true;
+          break;
         }
       }
 
@@ -57,6 +57,8 @@ namespace mars {
     class GraphicsTimer;
 #endif
 
+    class LibLoader;
+
     void exit_main(int signal);
     void handle_abort(int signal);
 
@@ -80,13 +82,18 @@ namespace mars {
       std::string configDir;
       std::string coreConfigFile;
       bool needQApp, noGUI;
+      // defer optional GUI plugins until they are opened from the menu
+      bool lazyPlugins;
 
     private:
       void releaseEnvireLibs();
+      void setupLibLoader();
 
       lib_manager::LibManager *libManager;
       app::GraphicsTimer *graphicsTimer;
       interfaces::MarsGuiInterface *marsGui;
+      LibLoader *libLoader;
+      long long startTime;
       bool ownLibManager;
       bool argConfDir;
       bool initialized;
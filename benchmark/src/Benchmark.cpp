@@ -0,0 +1,506 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Benchmark.h"
+#include "MemoryStats.h"
+
+#include <lib_manager/LibManager.hpp>
+#include <mars/cfg_manager/CFGManagerInterface.h>
+#include <mars/data_broker/DataBrokerInterface.h>
+#include <mars/data_broker/DataPackage.h>
+#include <mars/data_broker/ReceiverInterface.h>
+#include <mars/interfaces/sim/ControlCenter.h>
+#include <mars/interfaces/sim/JointManagerInterface.h>
+#include <mars/interfaces/sim/MotorManagerInterface.h>
+#include <mars/interfaces/sim/NodeManagerInterface.h>
+#include <mars/interfaces/sim/SensorManagerInterface.h>
+#include <mars/interfaces/sim/SimulatorInterface.h>
+#include <mars/interfaces/JointData.h>
+#include <mars/interfaces/NodeData.h>
+#include <mars/interfaces/terrainStruct.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+
+namespace mars {
+  namespace benchmark {
+
+    using namespace configmaps;
+    using namespace interfaces;
+    using utils::Vector;
+
+    typedef std::chrono::steady_clock Clock;
+
+    static double getElapsedMs(const Clock::time_point &start) {
+      return std::chrono::duration<double, std::milli>(Clock::now() -
+                                                       start).count();
+    }
+
+    /**
+     * Receives the simulation time. Every second receiver is registered
+     * to the sim timer instead of being called synchronously.
+     */
+    class FanOutReceiver : public data_broker::ReceiverInterface {
+    public:
+      explicit FanOutReceiver(bool timed) : timed(timed), value(0.0),
+                                            count(0) {}
+
+      void receiveData(const data_broker::DataInfo &info,
+                       const data_broker::DataPackage &package,
+                       int callbackParam) {
+        package.get(0, &value);
+        count.fetch_add(1, std::memory_order_relaxed);
+      }
+
+      bool timed;
+      double value;
+      std::atomic<unsigned long> count;
+    };
+
+    static const char *scenarioTypes[] = {
+      "box_stack", "chain", "lidar_rover", "heightfield", "data_broker",
+      "smurf", NULL
+    };
+
+    // loaded if available, the smurf scenario needs them
+    static const char *sceneLibs[] = {
+      "mars_scene_loader", "mars_entity_factory", "mars_smurf",
+      "mars_smurf_loader", NULL
+    };
+
+    Benchmark::Benchmark(lib_manager::LibManager *libManager)
+      : libManager(libManager), sim(NULL), control(NULL), simTimeId(0) {
+    }
+
+    Benchmark::~Benchmark() {
+      if(sim) {
+        clearScene();
+        sim->exitMars();
+      }
+      for(size_t i=loadedLibs.size(); i>0; --i) {
+        libManager->releaseLibrary(loadedLibs[i-1]);
+      }
+    }
+
+    bool Benchmark::init(const std::string &configDir) {
+      libManager->loadLibrary("cfg_manager");
+      cfg_manager::CFGManagerInterface *cfg;
+      cfg = libManager->getLibraryAs<cfg_manager::CFGManagerInterface>("cfg_manager");
+      if(!cfg) {
+        fprintf(stderr, "Benchmark: could not load cfg_manager\n");
+        return false;
+      }
+      loadedLibs.push_back("cfg_manager");
+      cfg->getOrCreateProperty("Config", "config_path", configDir);
+
+      libManager->loadLibrary("data_broker");
+      libManager->loadLibrary("mars_sim");
+      for(int i=0; sceneLibs[i]; ++i) {
+        libManager->loadLibrary(sceneLibs[i], NULL, true);
+      }
+      sim = libManager->getLibraryAs<SimulatorInterface>("mars_sim");
+      if(!sim) {
+        fprintf(stderr, "Benchmark: could not load mars_sim\n");
+        return false;
+      }
+      loadedLibs.push_back("mars_sim");
+      control = sim->getControlCenter();
+
+      // creates the managers and the world, the steps are driven by run
+      sim->runSimulation(false);
+      if(control->dataBroker) {
+        simTimeId = control->dataBroker->getDataID("mars_sim", "simTime");
+      }
+      return true;
+    }
+
+    void Benchmark::setStepSize(double calcMs, int substeps) {
+      if(calcMs > 0.0) {
+        control->cfg->setPropertyValue("Simulator", "calc_ms", "value",
+                                       calcMs);
+      }
+      if(substeps > 0) {
+        control->cfg->setPropertyValue("Simulator", "physics substeps",
+                                       "value", substeps);
+      }
+    }
+
+    double Benchmark::getCalcMs() const {
+      double calcMs = 10.0;
+      control->cfg->getPropertyValue("Simulator", "calc_ms", "value", &calcMs);
+      return calcMs;
+    }
+
+    void Benchmark::getSettings(ConfigMap *report) const {
+      int substeps = 1;
+      control->cfg->getPropertyValue("Simulator", "physics substeps", "value",
+                                     &substeps);
+      (*report)["calc_ms"] = getCalcMs();
+      (*report)["physics_substeps"] = substeps;
+    }
+
+    bool Benchmark::isScenarioType(const std::string &type) {
+      for(int i=0; scenarioTypes[i]; ++i) {
+        if(type == scenarioTypes[i]) return true;
+      }
+      return false;
+    }
+
+    bool Benchmark::run(const Scenario &scenario, ConfigMap *result) {
+      clearScene();
+      Clock::time_point start = Clock::now();
+      if(!createScene(scenario)) {
+        return false;
+      }
+      (*result)["type"] = scenario.type;
+      (*result)["size"] = scenario.size;
+      (*result)["setup_ms"] = getElapsedMs(start);
+      (*result)["nodes"] = control->nodes->getNodeCount();
+      (*result)["joints"] = control->joints->getJointCount();
+      (*result)["motors"] = control->motors->getMotorCount();
+      (*result)["warmup_steps"] = scenario.warmupSteps;
+      (*result)["steps"] = scenario.steps;
+
+      for(unsigned long i=0; i<scenario.warmupSteps; ++i) {
+        sim->step();
+      }
+
+      unsigned long callbacks = 0;
+      for(size_t i=0; i<receivers.size(); ++i) {
+        callbacks -= receivers[i]->count;
+      }
+      measureSteps(scenario.steps, result);
+      for(size_t i=0; i<receivers.size(); ++i) {
+        callbacks += receivers[i]->count;
+      }
+      if(!receivers.empty()) {
+        (*result)["callbacks_per_step"] = (double)callbacks / scenario.steps;
+      }
+      return true;
+    }
+
+    void Benchmark::measureSteps(unsigned long steps, ConfigMap *result) {
+      std::vector<double> stepMs(steps);
+      unsigned long allocations = getAllocationCount();
+      unsigned long bytes = getAllocatedBytes();
+      sim->resetStepPhaseTimes();
+      Clock::time_point start = Clock::now();
+      for(unsigned long i=0; i<steps; ++i) {
+        Clock::time_point stepStart = Clock::now();
+        sim->step();
+        stepMs[i] = getElapsedMs(stepStart);
+      }
+      double totalMs = getElapsedMs(start);
+      allocations = getAllocationCount() - allocations;
+      bytes = getAllocatedBytes() - bytes;
+
+      std::sort(stepMs.begin(), stepMs.end());
+      (*result)["steps_per_sec"] = steps*1000.0 / totalMs;
+      (*result)["realtime_factor"] = steps*getCalcMs() / totalMs;
+      ConfigMap &stepStats = (*result)["step_ms"];
+      stepStats["mean"] = totalMs / steps;
+      stepStats["min"] = stepMs.front();
+      stepStats["median"] = stepMs[steps/2];
+      stepStats["p95"] = stepMs[std::min(steps-1, steps*95/100)];
+      stepStats["max"] = stepMs.back();
+      (*result)["allocations_per_step"] = (double)allocations / steps;
+      (*result)["allocated_bytes_per_step"] = (double)bytes / steps;
+
+      // the phase timers live in Simulator::step, so they cover exactly
+      // the steps measured above
+      std::map<std::string, double> phaseMs;
+      unsigned long phaseSteps = 0;
+      sim->getStepPhaseTimes(&phaseMs, &phaseSteps);
+      if(phaseSteps) {
+        ConfigMap &phases = (*result)["phase_ms"];
+        std::map<std::string, double>::iterator it;
+        for(it=phaseMs.begin(); it!=phaseMs.end(); ++it) {
+          phases[it->first] = it->second / phaseSteps;
+        }
+      }
+    }
+
+    void Benchmark::clearScene() {
+      for(size_t i=0; i<receivers.size(); ++i) {
+        if(receivers[i]->timed) {
+          control->dataBroker->unregisterTimedReceiver(receivers[i], "mars_sim",
+                                                       "simTime",
+                                                       "mars_sim/simTimer");
+        }
+        else {
+          control->dataBroker->unregisterSyncReceiver(receivers[i], "mars_sim",
+                                                      "simTime");
+        }
+        delete receivers[i];
+      }
+      receivers.clear();
+      sim->newWorld(true);
+    }
+
+    bool Benchmark::createScene(const Scenario &scenario) {
+      if(scenario.type == "smurf") {
+        if(!sim->loadScene(scenario.file, false)) {
+          fprintf(stderr, "Benchmark: could not load %s\n",
+                  scenario.file.c_str());
+          return false;
+        }
+        return true;
+      }
+      if(scenario.size < 1) {
+        fprintf(stderr, "Benchmark: invalid size %d of %s\n", scenario.size,
+                scenario.name.c_str());
+        return false;
+      }
+      if(scenario.type == "box_stack") {
+        createBoxStack(scenario.size);
+      }
+      else if(scenario.type == "chain") {
+        createChain(scenario.size);
+      }
+      else if(scenario.type == "lidar_rover") {
+        createLidarRovers(scenario.size);
+      }
+      else if(scenario.type == "heightfield") {
+        if(scenario.size < 2) {
+          fprintf(stderr, "Benchmark: a heightfield needs at least two samples per edge\n");
+          return false;
+        }
+        createHeightfield(scenario.size);
+      }
+      else if(scenario.type == "data_broker") {
+        if(!control->dataBroker) {
+          fprintf(stderr, "Benchmark: the data_broker scenario needs the DataBroker\n");
+          return false;
+        }
+        createFanOut(scenario.size);
+      }
+      else {
+        fprintf(stderr, "Benchmark: unknown scenario type %s\n",
+                scenario.type.c_str());
+        return false;
+      }
+      return true;
+    }
+
+    unsigned long Benchmark::addGround(double size) {
+      NodeData ground("ground", Vector(0.0, 0.0, -0.05));
+      ground.initPrimitive(NODE_TYPE_BOX, Vector(size, size, 0.1), 0.0);
+      ground.movable = false;
+      return control->nodes->addNode(&ground);
+    }
+
+    unsigned long Benchmark::addBox(const std::string &name, double x,
+                                    double y, double z, double ext,
+                                    double mass) {
+      NodeData box(name, Vector(x, y, z));
+      box.initPrimitive(NODE_TYPE_BOX, Vector(ext, ext, ext), mass);
+      box.movable = mass > 0.0;
+      return control->nodes->addNode(&box);
+    }
+
+    /** Towers of ten boxes on a square grid. */
+    void Benchmark::createBoxStack(int numBoxes) {
+      const int height = 10;
+      const double ext = 0.1;
+      const double spacing = 3*ext;
+      int numTowers = (numBoxes+height-1) / height;
+      int perRow = (int)ceil(sqrt((double)numTowers));
+      addGround(perRow*spacing + 2.0);
+      for(int i=0; i<numBoxes; ++i) {
+        int tower = i / height;
+        double x = (tower%perRow - 0.5*(perRow-1))*spacing;
+        double y = (tower/perRow - 0.5*(perRow-1))*spacing;
+        double z = 0.5*ext + (i%height)*(ext+0.001);
+        addBox("box_" + std::to_string(i), x, y, z, ext, 0.1);
+      }
+    }
+
+    /**
+     * A horizontal chain of hinge joints fixed to the world at one end,
+     * the axes alternate to let it swing in three dimensions.
+     */
+    void Benchmark::createChain(int numLinks) {
+      const double length = 0.1;
+      const double width = 0.02;
+      const double z = numLinks*length + 0.5;
+      addGround(2*numLinks*length + 2.0);
+      unsigned long previous = 0;
+      for(int i=0; i<numLinks; ++i) {
+        NodeData link("link_" + std::to_string(i),
+                      Vector((i+0.5)*length, 0.0, z));
+        link.initPrimitive(NODE_TYPE_BOX, Vector(length, width, width), 0.05);
+        link.movable = true;
+        unsigned long id = control->nodes->addNode(&link);
+
+        // a node index of 0 connects the first link to the world
+        JointData joint("joint_" + std::to_string(i), JOINT_TYPE_HINGE, id,
+                        previous);
+        joint.anchorPos = ANCHOR_CUSTOM;
+        joint.anchor = Vector(i*length, 0.0, z);
+        joint.axis1 = (i%2) ? Vector(0.0, 0.0, 1.0) : Vector(0.0, 1.0, 0.0);
+        control->joints->addJoint(&joint);
+        previous = id;
+      }
+    }
+
+    /** Every rover carries two lidars and is surrounded by eight walls. */
+    void Benchmark::createLidarRovers(int numRovers) {
+      const double spacing = 8.0;
+      const double wallDistance = 3.0;
+      int perRow = (int)ceil(sqrt((double)numRovers));
+      addGround(perRow*spacing + 2.0);
+      for(int i=0; i<numRovers; ++i) {
+        double x = (i%perRow - 0.5*(perRow-1))*spacing;
+        double y = (i/perRow - 0.5*(perRow-1))*spacing;
+        std::string name = "rover_" + std::to_string(i);
+        NodeData rover(name, Vector(x, y, 0.15));
+        rover.initPrimitive(NODE_TYPE_BOX, Vector(0.6, 0.4, 0.2), 10.0);
+        rover.movable = true;
+        unsigned long id = control->nodes->addNode(&rover);
+
+        for(int k=0; k<8; ++k) {
+          double angle = k*M_PI/4;
+          addBox(name + "_wall_" + std::to_string(k),
+                 x + wallDistance*cos(angle), y + wallDistance*sin(angle),
+                 0.5, 1.0, 0.0);
+        }
+        for(int k=0; k<2; ++k) {
+          ConfigMap config;
+          config["type"] = std::string("RotatingRaySensor");
+          config["name"] = name + "_lidar_" + std::to_string(k);
+          config["attached_node"] = id;
+          config["mapIndex"] = 0;
+          config["bands"] = 16;
+          config["lasers"] = 32;
+          config["max_distance"] = 10.0;
+          config["draw_rays"] = false;
+          // interleave the bands of the two lidars
+          config["horizontal_offset"] = k*M_PI/16;
+          control->sensors->createAndAddSensor(&config);
+        }
+      }
+    }
+
+    /** A hilly terrain with spheres dropped onto it. */
+    void Benchmark::createHeightfield(int numSamples) {
+      const double resolution = 0.1;
+      terrainStruct terrain;
+      terrain.name = "heightfield";
+      terrain.width = terrain.height = numSamples;
+      terrain.targetWidth = terrain.targetHeight = (numSamples-1)*resolution;
+      terrain.scale = 1.0;
+      // freed with the node, no heightmap image has to be loaded
+      terrain.pixelData = (double*)calloc(numSamples*numSamples,
+                                          sizeof(double));
+      for(int x=0; x<numSamples; ++x) {
+        for(int y=0; y<numSamples; ++y) {
+          terrain.pixelData[x*numSamples+y] = 0.5 + 0.25*(sin(x*0.2) +
+                                                          cos(y*0.15));
+        }
+      }
+      control->nodes->addTerrain(&terrain);
+
+      const int perRow = 8;
+      double spacing = terrain.targetWidth / (2*perRow);
+      for(int i=0; i<perRow*perRow; ++i) {
+        NodeData sphere("sphere_" + std::to_string(i),
+                        Vector((i%perRow - 0.5*(perRow-1))*spacing,
+                               (i/perRow - 0.5*(perRow-1))*spacing, 2.0));
+        sphere.initPrimitive(NODE_TYPE_SPHERE, Vector(0.1, 0.0, 0.0), 0.5);
+        sphere.movable = true;
+        control->nodes->addNode(&sphere);
+      }
+    }
+
+    /** Receivers of the simulation time which is pushed every step. */
+    void Benchmark::createFanOut(int numReceivers) {
+      for(int i=0; i<numReceivers; ++i) {
+        FanOutReceiver *receiver = new FanOutReceiver(i%2);
+        if(receiver->timed) {
+          control->dataBroker->registerTimedReceiver(receiver, "mars_sim",
+                                                     "simTime",
+                                                     "mars_sim/simTimer", 0);
+        }
+        else {
+          control->dataBroker->registerSyncReceiver(receiver, "mars_sim",
+                                                    "simTime");
+        }
+        receivers.push_back(receiver);
+      }
+    }
+
+    int Benchmark::compare(ConfigMap *report, ConfigMap &baseline,
+                           double tolerance) {
+      if(!report->hasKey("scenarios") || !baseline.hasKey("scenarios")) {
+        return 0;
+      }
+      int regressions = 0;
+      ConfigMap &scenarios = (*report)["scenarios"];
+      ConfigMap &baseScenarios = baseline["scenarios"];
+      ConfigMap::iterator it;
+      for(it=scenarios.begin(); it!=scenarios.end(); ++it) {
+        if(!baseScenarios.hasKey(it->first)) continue;
+        ConfigMap &current = it->second;
+        ConfigMap &base = baseScenarios[it->first];
+        if(!base.hasKey("steps_per_sec") ||
+           !base.hasKey("allocations_per_step")) {
+          continue;
+        }
+
+        double speed = current["steps_per_sec"];
+        double baseSpeed = base["steps_per_sec"];
+        double allocations = current["allocations_per_step"];
+        double baseAllocations = base["allocations_per_step"];
+        double speedup = baseSpeed > 0.0 ? speed / baseSpeed : 1.0;
+        bool regressed = speedup < 1.0 - tolerance;
+        // a single additional allocation per step is always reported
+        if(allocations >= baseAllocations + 1.0 &&
+           allocations > baseAllocations*(1.0 + tolerance)) {
+          regressed = true;
+        }
+
+        ConfigMap &comparison = current["baseline"];
+        comparison["steps_per_sec"] = baseSpeed;
+        comparison["allocations_per_step"] = baseAllocations;
+        comparison["speedup"] = speedup;
+        if(regressed) {
+          comparison["status"] = std::string("regression");
+          fprintf(stderr, "Benchmark: %s regressed: %g steps/s (baseline %g), %g allocations per step (baseline %g)\n",
+                  it->first.c_str(), speed, baseSpeed, allocations,
+                  baseAllocations);
+          ++regressions;
+        }
+        else if(speedup > 1.0 + tolerance) {
+          comparison["status"] = std::string("improved");
+        }
+        else {
+          comparison["status"] = std::string("ok");
+        }
+      }
+      return regressions;
+    }
+
+  } // end of namespace benchmark
+} // end of namespace mars
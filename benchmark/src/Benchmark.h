@@ -0,0 +1,135 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file Benchmark.h
+ * \brief Runs synthetic scenes headless and measures the simulation steps.
+ *
+ * Every scenario builds its scene in a new world, runs some warm up steps
+ * and then measures the whole Simulator::step. The per-phase times that
+ * Simulator::step collects attribute the step time to the physics, the
+ * node, joint, motor and controller updates, the DataBroker and the plugins.
+ */
+
+#ifndef MARS_BENCHMARK_BENCHMARK_H
+#define MARS_BENCHMARK_BENCHMARK_H
+
+#include <configmaps/ConfigData.h>
+
+#include <string>
+#include <vector>
+
+namespace lib_manager {
+  class LibManager;
+}
+
+namespace mars {
+  namespace interfaces {
+    class ControlCenter;
+    class SimulatorInterface;
+  }
+
+  namespace benchmark {
+
+    class FanOutReceiver;
+
+    struct Scenario {
+      Scenario() : size(0), warmupSteps(100), steps(1000) {}
+
+      /** box_stack, chain, lidar_rover, heightfield, data_broker or smurf */
+      std::string type;
+      /** The key of the scenario in the report. */
+      std::string name;
+      /**
+       * The number of boxes, chain links, rovers or receivers, or the
+       * number of samples per edge of the heightfield.
+       */
+      int size;
+      /** The scene loaded by the smurf scenario. */
+      std::string file;
+      unsigned long warmupSteps;
+      unsigned long steps;
+    };
+
+    class Benchmark {
+    public:
+      explicit Benchmark(lib_manager::LibManager *libManager);
+      ~Benchmark();
+
+      /**
+       * \brief Loads the simulation libraries and creates the world
+       *        without starting the simulation thread.
+       * \param configDir The directory of mars_Simulator.yaml and
+       *                  mars_Physics.yaml.
+       */
+      bool init(const std::string &configDir);
+      /** \brief Overrides the step size and the physics sub-steps, a
+       *         value of 0 keeps the configured one. */
+      void setStepSize(double calcMs, int substeps);
+      /** \brief Writes the parameters of the simulation to \a report. */
+      void getSettings(configmaps::ConfigMap *report) const;
+
+      /** \brief Runs \a scenario and stores its measurements in \a result. */
+      bool run(const Scenario &scenario, configmaps::ConfigMap *result);
+
+      /**
+       * \brief Compares the scenarios of \a report with the ones of
+       *        \a baseline and adds the ratios to \a report.
+       *
+       * A scenario regressed if its steps per second dropped or its
+       * allocations per step grew by more than \a tolerance.
+       * \return The number of regressed scenarios.
+       */
+      static int compare(configmaps::ConfigMap *report,
+                         configmaps::ConfigMap &baseline, double tolerance);
+
+      static bool isScenarioType(const std::string &type);
+
+    private:
+      lib_manager::LibManager *libManager;
+      interfaces::SimulatorInterface *sim;
+      interfaces::ControlCenter *control;
+      std::vector<FanOutReceiver*> receivers;
+      std::vector<std::string> loadedLibs;
+      unsigned long simTimeId;
+
+      bool createScene(const Scenario &scenario);
+      void clearScene();
+      unsigned long addGround(double size);
+      unsigned long addBox(const std::string &name, double x, double y,
+                           double z, double ext, double mass);
+      void createBoxStack(int numBoxes);
+      void createChain(int numLinks);
+      void createLidarRovers(int numRovers);
+      void createHeightfield(int numSamples);
+      void createFanOut(int numReceivers);
+
+      double getCalcMs() const;
+      void measureSteps(unsigned long steps, configmaps::ConfigMap *result);
+
+      // disallow copying
+      Benchmark(const Benchmark &);
+      Benchmark &operator=(const Benchmark &);
+    }; // end of class Benchmark
+
+  } // end of namespace benchmark
+} // end of namespace mars
+
+#endif // MARS_BENCHMARK_BENCHMARK_H
@@ -0,0 +1,80 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "MemoryStats.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifndef WIN32
+#include <sys/resource.h>
+#endif
+
+namespace mars {
+  namespace benchmark {
+
+    static std::atomic<unsigned long> allocationCount(0);
+    static std::atomic<unsigned long> allocatedBytes(0);
+
+    unsigned long getAllocationCount() {
+      return allocationCount.load(std::memory_order_relaxed);
+    }
+
+    unsigned long getAllocatedBytes() {
+      return allocatedBytes.load(std::memory_order_relaxed);
+    }
+
+    long getPeakRSS() {
+#ifdef WIN32
+      return 0;
+#else
+      struct rusage usage;
+      if(getrusage(RUSAGE_SELF, &usage)) return 0;
+#ifdef __APPLE__
+      // reported in bytes instead of kB
+      return usage.ru_maxrss / 1024;
+#else
+      return usage.ru_maxrss;
+#endif
+#endif
+    }
+
+  } // end of namespace benchmark
+} // end of namespace mars
+
+// The default implementations of the array, nothrow and sized variants
+// forward to these two functions.
+void* operator new(std::size_t size) {
+  mars::benchmark::allocationCount.fetch_add(1, std::memory_order_relaxed);
+  mars::benchmark::allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+  if(size == 0) size = 1;
+  while(true) {
+    void *p = std::malloc(size);
+    if(p) return p;
+    std::new_handler handler = std::get_new_handler();
+    if(!handler) throw std::bad_alloc();
+    handler();
+  }
+}
+
+void operator delete(void *p) noexcept {
+  std::free(p);
+}
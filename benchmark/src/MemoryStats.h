@@ -0,0 +1,46 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file MemoryStats.h
+ * \brief Allocation counters and the peak memory usage of the process.
+ *
+ * The counters are maintained by the global operator new of the
+ * benchmark executable. They include the allocations of all loaded
+ * libraries and of all threads.
+ */
+
+#ifndef MARS_BENCHMARK_MEMORY_STATS_H
+#define MARS_BENCHMARK_MEMORY_STATS_H
+
+namespace mars {
+  namespace benchmark {
+
+    /** \brief The number of calls to operator new since the start. */
+    unsigned long getAllocationCount();
+    /** \brief The number of bytes requested by operator new since the start. */
+    unsigned long getAllocatedBytes();
+    /** \brief The peak resident set size of the process in kB, 0 if unknown. */
+    long getPeakRSS();
+
+  } // end of namespace benchmark
+} // end of namespace mars
+
+#endif // MARS_BENCHMARK_MEMORY_STATS_H
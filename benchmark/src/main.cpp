@@ -0,0 +1,216 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file main.cpp
+ * \brief Runs the benchmark scenarios and writes a YAML report.
+ *
+ * Example:
+ * \verbatim
+ mars_benchmark -s box_stack,chain -n 2000 -o current.yml -b baseline.yml
+ \endverbatim
+ * The report of one run can be used as the baseline of later runs. The
+ * exit code is 1 if a scenario regressed against the baseline.
+ */
+
+#include "Benchmark.h"
+#include "MemoryStats.h"
+
+#include <lib_manager/LibManager.hpp>
+#include <mars/utils/misc.h>
+
+#include <getopt.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace mars::benchmark;
+
+static void printUsage(const char *name) {
+  printf("usage: %s [options]\n"
+         "  -s, --scenarios LIST   comma separated scenario types\n"
+         "                         (default: box_stack,chain,lidar_rover,heightfield,data_broker)\n"
+         "  -n, --steps N          measured steps per scenario (default: 1000)\n"
+         "  -w, --warmup N         steps before the measurement (default: 100)\n"
+         "      --boxes N          boxes of box_stack (default: 200)\n"
+         "      --links N          links of chain (default: 50)\n"
+         "      --rovers N         rovers of lidar_rover (default: 4)\n"
+         "      --samples N        samples per edge of heightfield (default: 257)\n"
+         "      --receivers N      receivers of data_broker (default: 100)\n"
+         "      --smurf FILE       adds the smurf scenario loading FILE\n"
+         "      --calc_ms MS       overrides the simulation step size\n"
+         "      --substeps N       overrides the physics sub-steps\n"
+         "  -C, --config_dir DIR   directory of the simulator configuration (default: .)\n"
+         "  -o, --output FILE      the report (default: benchmark.yml)\n"
+         "  -b, --baseline FILE    compares the report with an earlier one\n"
+         "  -t, --tolerance X      relative change accepted by the comparison (default: 0.1)\n",
+         name);
+}
+
+int main(int argc, char *argv[]) {
+  enum {
+    OPT_BOXES = 256, OPT_LINKS, OPT_ROVERS, OPT_SAMPLES, OPT_RECEIVERS,
+    OPT_SMURF, OPT_CALC_MS, OPT_SUBSTEPS
+  };
+  static struct option long_options[] = {
+    {"scenarios", required_argument, 0, 's'},
+    {"steps", required_argument, 0, 'n'},
+    {"warmup", required_argument, 0, 'w'},
+    {"boxes", required_argument, 0, OPT_BOXES},
+    {"links", required_argument, 0, OPT_LINKS},
+    {"rovers", required_argument, 0, OPT_ROVERS},
+    {"samples", required_argument, 0, OPT_SAMPLES},
+    {"receivers", required_argument, 0, OPT_RECEIVERS},
+    {"smurf", required_argument, 0, OPT_SMURF},
+    {"calc_ms", required_argument, 0, OPT_CALC_MS},
+    {"substeps", required_argument, 0, OPT_SUBSTEPS},
+    {"config_dir", required_argument, 0, 'C'},
+    {"output", required_argument, 0, 'o'},
+    {"baseline", required_argument, 0, 'b'},
+    {"tolerance", required_argument, 0, 't'},
+    {"help", no_argument, 0, 'h'},
+    {0, 0, 0, 0}
+  };
+
+  std::string scenarioList = "box_stack,chain,lidar_rover,heightfield,data_broker";
+  std::string smurfFile, configDir = ".", outputFile = "benchmark.yml";
+  std::string baselineFile;
+  long steps = 1000, warmupSteps = 100;
+  int boxes = 200, links = 50, rovers = 4, samples = 257, receivers = 100;
+  int substeps = 0;
+  double calcMs = 0.0, tolerance = 0.1;
+
+  int c;
+  while((c = getopt_long(argc, argv, "s:n:w:C:o:b:t:h", long_options,
+                         NULL)) != -1) {
+    switch(c) {
+    case 's': scenarioList = optarg; break;
+    case 'n': steps = atol(optarg); break;
+    case 'w': warmupSteps = atol(optarg); break;
+    case OPT_BOXES: boxes = atoi(optarg); break;
+    case OPT_LINKS: links = atoi(optarg); break;
+    case OPT_ROVERS: rovers = atoi(optarg); break;
+    case OPT_SAMPLES: samples = atoi(optarg); break;
+    case OPT_RECEIVERS: receivers = atoi(optarg); break;
+    case OPT_SMURF: smurfFile = optarg; break;
+    case OPT_CALC_MS: calcMs = atof(optarg); break;
+    case OPT_SUBSTEPS: substeps = atoi(optarg); break;
+    case 'C': configDir = optarg; break;
+    case 'o': outputFile = optarg; break;
+    case 'b': baselineFile = optarg; break;
+    case 't': tolerance = atof(optarg); break;
+    case 'h':
+      printUsage(argv[0]);
+      return 0;
+    default:
+      printUsage(argv[0]);
+      return 2;
+    }
+  }
+  if(steps < 1 || warmupSteps < 0) {
+    fprintf(stderr, "mars_benchmark: invalid number of steps\n");
+    return 2;
+  }
+
+  std::vector<Scenario> scenarios;
+  std::vector<std::string> types = mars::utils::explodeString(',', scenarioList);
+  if(!smurfFile.empty() &&
+     std::find(types.begin(), types.end(), "smurf") == types.end()) {
+    types.push_back("smurf");
+  }
+  for(size_t i=0; i<types.size(); ++i) {
+    Scenario scenario;
+    scenario.type = scenario.name = mars::utils::trim(types[i]);
+    if(scenario.type.empty()) continue;
+    for(size_t k=0; k<scenarios.size(); ++k) {
+      if(scenarios[k].name == scenario.name) {
+        fprintf(stderr, "mars_benchmark: scenario %s is given twice\n",
+                scenario.name.c_str());
+        return 2;
+      }
+    }
+    if(!Benchmark::isScenarioType(scenario.type)) {
+      fprintf(stderr, "mars_benchmark: unknown scenario %s\n",
+              scenario.type.c_str());
+      return 2;
+    }
+    if(scenario.type == "smurf" && smurfFile.empty()) {
+      fprintf(stderr, "mars_benchmark: the smurf scenario needs --smurf\n");
+      return 2;
+    }
+    if(scenario.type == "box_stack") scenario.size = boxes;
+    else if(scenario.type == "chain") scenario.size = links;
+    else if(scenario.type == "lidar_rover") scenario.size = rovers;
+    else if(scenario.type == "heightfield") scenario.size = samples;
+    else if(scenario.type == "data_broker") scenario.size = receivers;
+    scenario.file = smurfFile;
+    scenario.steps = steps;
+    scenario.warmupSteps = warmupSteps;
+    scenarios.push_back(scenario);
+  }
+
+  lib_manager::LibManager *libManager = new lib_manager::LibManager();
+  configmaps::ConfigMap report;
+  int state = 0;
+  {
+    Benchmark benchmark(libManager);
+    if(!benchmark.init(configDir)) {
+      delete libManager;
+      return 2;
+    }
+    benchmark.setStepSize(calcMs, substeps);
+    benchmark.getSettings(&report);
+
+    for(size_t i=0; i<scenarios.size(); ++i) {
+      fprintf(stderr, "mars_benchmark: run %s\n", scenarios[i].name.c_str());
+      configmaps::ConfigMap &result = report["scenarios"][scenarios[i].name];
+      if(!benchmark.run(scenarios[i], &result)) {
+        state = 2;
+        break;
+      }
+      printf("%-12s %10.1f steps/s %9.3f ms/step %9.1f allocations/step\n",
+             scenarios[i].name.c_str(), (double)result["steps_per_sec"],
+             (double)result["step_ms"]["mean"],
+             (double)result["allocations_per_step"]);
+    }
+  }
+  delete libManager;
+  // the peak RSS covers the whole process, so it is only reported once
+  report["peak_rss_kb"] = (unsigned long)getPeakRSS();
+
+  if(state == 0 && !baselineFile.empty()) {
+    if(!mars::utils::pathExists(baselineFile)) {
+      fprintf(stderr, "mars_benchmark: baseline %s not found\n",
+              baselineFile.c_str());
+      state = 2;
+    }
+    else {
+      configmaps::ConfigMap baseline;
+      baseline = configmaps::ConfigMap::fromYamlFile(baselineFile);
+      if(Benchmark::compare(&report, baseline, tolerance)) {
+        state = 1;
+      }
+    }
+  }
+  report.toYamlFile(outputFile);
+  return state;
+}
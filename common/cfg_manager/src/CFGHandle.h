@@ -0,0 +1,140 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file CFGHandle.h
+ * \brief Typed handles that read the value of a param without locking.
+ *
+ * Every param publishes its "value" property into a CFGValueCell whenever
+ * it changes. A handle shares that cell, so reading it neither takes the
+ * CFGManager mutex nor looks up the param by name. The cell outlives the
+ * param, a handle of a removed param keeps returning the last value.
+ */
+
+#ifndef CFG_HANDLE_H
+#define CFG_HANDLE_H
+
+#ifdef _PRINT_HEADER_
+#warning "CFGHandle.h"
+#endif
+
+#include "CFGDefs.h"
+
+#include <mars/utils/Mutex.h>
+#include <mars/utils/MutexLocker.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+namespace mars {
+  namespace cfg_manager {
+
+    struct CFGValueCell {
+      CFGValueCell() : dValue(0.0), iValue(0), bValue(false), version(0) {}
+
+      std::atomic<double> dValue;
+      std::atomic<int> iValue;
+      std::atomic<bool> bValue;
+      // strings can not be stored atomically
+      std::string sValue;
+      mutable utils::Mutex mutexSValue;
+      // incremented after every change of the value
+      std::atomic<unsigned long> version;
+    };
+
+    template <typename T>
+    class CFGHandle {
+
+    public:
+      CFGHandle() : paramId(0) {}
+
+      bool isValid() const {return cell.get() != NULL;}
+      cfgParamId getParamId() const {return paramId;}
+
+      T get() const;
+      operator T() const {return get();}
+
+      unsigned long getVersion() const {
+        return cell->version.load(std::memory_order_acquire);
+      }
+
+      /**
+       * \brief Cheap change detection for pollers.
+       * \param lastVersion The version seen by the last call, updated to
+       *                    the current version.
+       */
+      bool changed(unsigned long *lastVersion) const {
+        unsigned long current = getVersion();
+        if(current == *lastVersion) return false;
+        *lastVersion = current;
+        return true;
+      }
+
+      /** The param type a handle of type T can be bound to. */
+      static cfgParamType getParamType();
+
+      void bind(cfgParamId _paramId, const std::shared_ptr<CFGValueCell> &_cell) {
+        paramId = _paramId;
+        cell = _cell;
+      }
+
+    private:
+      cfgParamId paramId;
+      std::shared_ptr<CFGValueCell> cell;
+
+    }; // end class CFGHandle
+
+    template <> inline double CFGHandle<double>::get() const {
+      return cell->dValue.load(std::memory_order_acquire);
+    }
+    template <> inline int CFGHandle<int>::get() const {
+      return cell->iValue.load(std::memory_order_acquire);
+    }
+    template <> inline bool CFGHandle<bool>::get() const {
+      return cell->bValue.load(std::memory_order_acquire);
+    }
+    template <> inline std::string CFGHandle<std::string>::get() const {
+      utils::MutexLocker locker(&cell->mutexSValue);
+      return cell->sValue;
+    }
+
+    template <> inline cfgParamType CFGHandle<double>::getParamType() {
+      return doubleParam;
+    }
+    template <> inline cfgParamType CFGHandle<int>::getParamType() {
+      return intParam;
+    }
+    template <> inline cfgParamType CFGHandle<bool>::getParamType() {
+      return boolParam;
+    }
+    template <> inline cfgParamType CFGHandle<std::string>::getParamType() {
+      return stringParam;
+    }
+
+    typedef CFGHandle<double> CFGDoubleHandle;
+    typedef CFGHandle<int> CFGIntHandle;
+    typedef CFGHandle<bool> CFGBoolHandle;
+    typedef CFGHandle<std::string> CFGStringHandle;
+
+  } // end namespace cfg_manager
+} // end namespace mars
+
+#endif /* CFG_HANDLE_H */
@@ -37,6 +37,7 @@
 #include <yaml-cpp/yaml.h>
 
 #include <sys/stat.h>
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -308,25 +309,9 @@ namespace mars {
       utils::MutexLocker locker(&mutexCFGParams);
       CFGParam *param = NULL;
       CFGProperty property;
-      property.setParamId(_propertyS.paramId);
-      property.setPropertyIndex(_propertyS.propertyIndex);
-      property.setPropertyType(_propertyS.propertyType);
-      switch (_propertyS.propertyType) {
-      case boolProperty:
-        property.setValue(_propertyS.bValue);
-        break;
-      case doubleProperty:
-        property.setValue(_propertyS.dValue);
-        break;
-      case intProperty:
-        property.setValue(_propertyS.iValue);
-        break;
-      case stringProperty:
-        property.setValue(_propertyS.sValue);
-        break;
-      default:
+      if( !propertyFromStruct(_propertyS, &property) ) {
         return false;
-      } // switch
+      }
       if( getParam(&param, _propertyS.paramId) ) {
         return param->setProperty(property);
       } else {
@@ -335,6 +320,74 @@ namespace mars {
     }
 
 
+    bool CFGManager::setProperties(const vector<cfgPropertyStruct> &_properties) {
+      utils::MutexLocker locker(&mutexCFGParams);
+      vector<CFGParam*> params;
+      vector< pair<CFGParam*, CFGProperty> > oldPropertys;
+      vector<cfgPropertyStruct>::const_iterator iter;
+      bool rValue = true;
+
+      for(iter = _properties.begin(); iter != _properties.end(); ++iter) {
+        CFGParam *param = NULL;
+        CFGProperty property;
+        if( !propertyFromStruct(*iter, &property) ||
+            !getParam(&param, iter->paramId) ||
+            iter->propertyIndex >= param->getNrOfPropertys() ) {
+          rValue = false;
+          break;
+        }
+        if( find(params.begin(), params.end(), param) == params.end() ) {
+          param->beginUpdate();
+          params.push_back(param);
+        }
+
+        CFGProperty oldProperty;
+        oldProperty.setParamId(iter->paramId);
+        oldProperty.setPropertyIndex(iter->propertyIndex);
+        oldProperty.setPropertyType(param->getPropertyTypeByIndex(iter->propertyIndex));
+        bool hasOldValue = param->getProperty(&oldProperty);
+
+        if( !param->setProperty(property) ) {
+          rValue = false;
+          break;
+        }
+        if( hasOldValue ) {
+          oldPropertys.push_back(pair<CFGParam*, CFGProperty>(param, oldProperty));
+        }
+      } // for
+
+      if( !rValue ) {
+        // roll back in reverse order, every old value was valid in turn
+        vector< pair<CFGParam*, CFGProperty> >::reverse_iterator iterOld;
+        for(iterOld = oldPropertys.rbegin(); iterOld != oldPropertys.rend();
+            ++iterOld) {
+          iterOld->first->setProperty(iterOld->second);
+        }
+      }
+
+      vector<CFGParam*>::iterator iterParam;
+      for(iterParam = params.begin(); iterParam != params.end(); ++iterParam) {
+        if( rValue ) {
+          (*iterParam)->endUpdate();
+        } else {
+          (*iterParam)->cancelUpdate();
+        }
+      }
+      return rValue;
+    }
+
+
+    std::shared_ptr<CFGValueCell> CFGManager::getValueCell(const cfgParamId &_id) const {
+      utils::MutexLocker locker(&mutexCFGParams);
+      CFGParam *param = NULL;
+      if( getParam(&param, _id) ) {
+        return param->getValueCell();
+      } else {
+        return std::shared_ptr<CFGValueCell>();
+      }
+    }
+
+
     bool CFGManager::getProperty(cfgPropertyStruct *_propertyS) const {
       utils::MutexLocker locker(&mutexCFGParams);
       CFGParam *param = NULL;
@@ -852,6 +905,26 @@ namespace mars {
     }
 
 
+    bool CFGManager::propertyFromStruct(const cfgPropertyStruct &_propertyS,
+                                        CFGProperty *property) {
+      property->setParamId(_propertyS.paramId);
+      property->setPropertyIndex(_propertyS.propertyIndex);
+      property->setPropertyType(_propertyS.propertyType);
+      switch (_propertyS.propertyType) {
+      case boolProperty:
+        return property->setValue(_propertyS.bValue);
+      case doubleProperty:
+        return property->setValue(_propertyS.dValue);
+      case intProperty:
+        return property->setValue(_propertyS.iValue);
+      case stringProperty:
+        return property->setValue(_propertyS.sValue);
+      default:
+        return false;
+      } // switch
+    }
+
+
     bool CFGManager::fileExists(const string &strFilename) const {
       struct stat stFileInfo;
       bool blnReturn;
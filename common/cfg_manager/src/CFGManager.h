@@ -93,6 +93,10 @@ namespace mars {
       virtual bool setProperty(const cfgPropertyStruct &_propertyS);
       virtual bool getProperty(cfgPropertyStruct *_propertyS) const;
 
+      virtual bool setProperties(const std::vector<cfgPropertyStruct> &_properties);
+
+      virtual std::shared_ptr<CFGValueCell> getValueCell(const cfgParamId &_id) const;
+
       using CFGManagerInterface::getPropertyValue;
       virtual bool getPropertyValue(cfgParamId paramId,
                                     const std::string &_propertyName,
@@ -210,6 +214,9 @@ namespace mars {
 
       bool fileExists(const std::string &strFilename) const;
 
+      static bool propertyFromStruct(const cfgPropertyStruct &_propertyS,
+                                     CFGProperty *property);
+
 
       void readGroup(const std::string &group, const YAML::Node &paramNodes);
 
@@ -35,6 +35,7 @@
 
 #include "CFGDefs.h"
 #include "CFGClient.h"
+#include "CFGHandle.h"
 
 #include <lib_manager/LibManager.hpp>
 
@@ -81,6 +82,47 @@ namespace mars {
       virtual bool setProperty(const cfgPropertyStruct &_propertyS) = 0;
       virtual bool getProperty(cfgPropertyStruct *_propertyS) const = 0;
 
+      /**
+       * \brief Sets several properties as one batch.
+       *
+       * If one of the properties is rejected none of them is changed. The
+       * clients of the changed params are notified after the whole batch
+       * is written, once per changed property.
+       */
+      virtual bool setProperties(const std::vector<cfgPropertyStruct> &_properties) {
+        bool rValue = true;
+        std::vector<cfgPropertyStruct>::const_iterator iter;
+        for(iter = _properties.begin(); iter != _properties.end(); ++iter) {
+          rValue &= setProperty(*iter);
+        }
+        return rValue;
+      }
+
+      /** \brief The cell the param publishes its value to, see CFGHandle. */
+      virtual std::shared_ptr<CFGValueCell> getValueCell(const cfgParamId &_id) const {
+        return std::shared_ptr<CFGValueCell>();
+      }
+
+      /**
+       * \brief Binds \a handle to the value of a param.
+       * \return false if the param does not exist or its type does not
+       *         match T.
+       */
+      template <typename T>
+      bool getHandle(const std::string &_group, const std::string &_name,
+                     CFGHandle<T> *handle) const {
+        cfgParamInfo info = getParamInfo(_group, _name);
+        if(info.id == 0 || info.type != CFGHandle<T>::getParamType()) {
+          return false;
+        }
+        std::shared_ptr<CFGValueCell> cell = getValueCell(info.id);
+        if(!cell) {
+          return false;
+        }
+        handle->bind(info.id, cell);
+        return true;
+      }
+
       template <typename T>
       bool getPropertyValue(const std::string &_group, const std::string &_name,
                             const std::string &_propertyName, T *rValue) const {
@@ -28,6 +28,8 @@
 
 #include "CFGParam.h"
 
+#include <algorithm>
+
 namespace mars {
   namespace cfg_manager {
 
@@ -36,7 +38,8 @@ namespace mars {
 
     CFGParam::CFGParam(const cfgParamId &_id, const string &_group,
                        const string &_name, const cfgParamType &_type)
-      : emptyString(""), noType(noTypeSet) {
+      : valueCell(new CFGValueCell), updating(false),
+        emptyString(""), noType(noTypeSet) {
       this->id    = _id;
       this->group = _group;
       this->paramName = _name;
@@ -154,6 +157,46 @@ namespace mars {
     }
 
 
+    const std::shared_ptr<CFGValueCell>& CFGParam::getValueCell() const {
+      return valueCell;
+    }
+
+
+    void CFGParam::beginUpdate() {
+      mutexCFGClients.lock();
+      updating = true;
+      mutexCFGClients.unlock();
+    }
+
+
+    void CFGParam::endUpdate() {
+      vector<unsigned int> changed;
+      mutexCFGClients.lock();
+      updating = false;
+      changed.swap(pendingUpdates);
+      mutexCFGClients.unlock();
+
+      vector<unsigned int>::iterator iter;
+      for(iter = changed.begin(); iter != changed.end(); ++iter) {
+        if(*iter == 0) {
+          publishValue();
+        }
+        mutexPropertys.lock();
+        cfgPropertyStruct tmpS = propertys.at(*iter)->getAsStruct();
+        mutexPropertys.unlock();
+        notifyClients(tmpS);
+      }
+    }
+
+
+    void CFGParam::cancelUpdate() {
+      mutexCFGClients.lock();
+      updating = false;
+      pendingUpdates.clear();
+      mutexCFGClients.unlock();
+    }
+
+
     void CFGParam::writeToYAML(YAML::Emitter &out) const {
       out << YAML::BeginMap;
 
@@ -215,23 +258,82 @@ namespace mars {
     // PROTECTED
 
     void CFGParam::updateClients(const CFGProperty &property) {
-      vector<CFGClient*>::iterator iter;
-      cfgPropertyStruct tmpS = property.getAsStruct();
+      unsigned int index = property.getPropertyIndex();
+      mutexCFGClients.lock();
+      if(updating) {
+        // notify only once per property when the update ends
+        if(std::find(pendingUpdates.begin(), pendingUpdates.end(),
+                     index) == pendingUpdates.end()) {
+          pendingUpdates.push_back(index);
+        }
+        mutexCFGClients.unlock();
+        return;
+      }
+      mutexCFGClients.unlock();
 
+      // the value property has index 0 for all param types
+      if(index == 0) {
+        publishValue();
+      }
+      notifyClients(property.getAsStruct());
+    }
+
+
+    void CFGParam::notifyClients(const cfgPropertyStruct &propertyS) {
+      vector<CFGClient*>::iterator iter;
       mutexCFGClients.lock();
       for(iter = cfgClients.begin(); iter != cfgClients.end(); ++iter) {
-        (*iter)->cfgUpdateProperty(tmpS);
+        (*iter)->cfgUpdateProperty(propertyS);
       }
       mutexCFGClients.unlock();
     }
 
 
+    void CFGParam::publishValue() {
+      mutexPropertys.lock();
+      const CFGProperty *prop = propertys.empty() ? NULL : propertys.front();
+      if(prop == NULL || !prop->isValueSet()) {
+        mutexPropertys.unlock();
+        return;
+      }
+      double dValue = 0.0;
+      int iValue = 0;
+      bool bValue = false;
+      string sValue = "";
+      switch(prop->getPropertyType()) {
+      case doubleProperty:
+        prop->getValue(&dValue);
+        valueCell->dValue.store(dValue, std::memory_order_release);
+        break;
+      case intProperty:
+        prop->getValue(&iValue);
+        valueCell->iValue.store(iValue, std::memory_order_release);
+        break;
+      case boolProperty:
+        prop->getValue(&bValue);
+        valueCell->bValue.store(bValue, std::memory_order_release);
+        break;
+      case stringProperty:
+        prop->getValue(&sValue);
+        valueCell->mutexSValue.lock();
+        valueCell->sValue = sValue;
+        valueCell->mutexSValue.unlock();
+        break;
+      default:
+        break;
+      } //switch
+      mutexPropertys.unlock();
+      valueCell->version.fetch_add(1, std::memory_order_release);
+    }
+
+
     void CFGParam::readFromYAML(const YAML::Node &node) {
       unsigned int index = 0;
       for(index = 0; index < getNrOfPropertys(); ++index) {
         readPropertyFromYAML(index, node);
       }
       readSaveSettingFromYAML(node);
+      publishValue();
     }
 
 
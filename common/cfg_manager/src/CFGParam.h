@@ -37,6 +37,7 @@
 #include "CFGDefs.h"
 #include "CFGProperty.h"
 #include "CFGClient.h"
+#include "CFGHandle.h"
 
 #include <yaml-cpp/yaml.h>
 
@@ -79,6 +80,21 @@ namespace mars {
 
       void writeToYAML(YAML::Emitter &out) const;
 
+      /** \brief The lock-free copy of the "value" property. */
+      const std::shared_ptr<CFGValueCell>& getValueCell() const;
+
+      /**
+       * \brief Defers the notification of the clients.
+       *
+       * Between beginUpdate and endUpdate the changed properties are only
+       * recorded. endUpdate publishes the new value and notifies every
+       * client once per changed property, cancelUpdate drops the recorded
+       * changes without notifying anyone.
+       */
+      void beginUpdate();
+      void endUpdate();
+      void cancelUpdate();
+
 
     private:
       cfgParamId id;
@@ -89,6 +105,12 @@ namespace mars {
       std::vector<CFGClient*> cfgClients;
       utils::Mutex mutexCFGClients;
 
+      std::shared_ptr<CFGValueCell> valueCell;
+      bool updating;
+      std::vector<unsigned int> pendingUpdates;
+
+      void notifyClients(const cfgPropertyStruct &propertyS);
+
 
     protected:
       std::vector<CFGProperty*> propertys;
@@ -97,6 +119,7 @@ namespace mars {
       unsigned char options;
 
       void updateClients(const CFGProperty &property);
+      void publishValue();
 
       void readFromYAML(const YAML::Node &node);
       void readPropertyFromYAML(unsigned int index, const YAML::Node &node) const;
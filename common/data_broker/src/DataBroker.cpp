@@ -42,6 +42,7 @@
 
 
 #include "DataBroker.h"
+#include "MessageQueue.h"
 #include "ProducerInterface.h"
 #include "ReceiverInterface.h"
 
@@ -93,7 +94,8 @@ namespace mars {
       DataBrokerInterface(theManager),
       mars::utils::Thread(),
       next_id(1), thread_running(false), stop_thread(false),
-      realtimeThreadRunning(false), startingRealtimeThread(false) {
+      realtimeThreadRunning(false), startingRealtimeThread(false),
+      messageQueue(NULL) {
 
       updatedElementsBackBuffer = new std::set<DataElement*>;
       updatedElementsFrontBuffer = new std::set<DataElement*>;
@@ -131,11 +133,17 @@ namespace mars {
 
       createTimer("_REALTIME_");
 
+      // messages are delivered from the thread of the queue
+      messageQueue = new MessageQueue(this);
+
       //pthread_create(&theThread, NULL, createDataBrokerThread, (void*)this);
       //start();
     }
 
     DataBroker::~DataBroker() {
+      // delivers the remaining messages
+      delete messageQueue;
+      messageQueue = NULL;
       stopRealtimeThread = true;
       stop_thread = true;
       if(wakeupMutex.tryLock() == MUTEX_ERROR_NO_ERROR) {
@@ -1014,16 +1022,39 @@ namespace mars {
       return id;
     }
 
-    void DataBroker::pushMessage(MessageType messageType,
-                                 const std::string &format, va_list args) {
+    void DataBroker::queueMessage(MessageType messageType, const char *site,
+                                  const char *format, va_list args) {
+      if(messageQueue && messageType != DB_MESSAGE_TYPE_FATAL) {
+        messageQueue->push(messageType, site, format, args);
+        return;
+      }
+      // fatal messages are delivered immediately after the queued ones
+      if(messageQueue) messageQueue->flush();
       const int MAX_BUFFER_SIZE = 1024;
       char buffer[MAX_BUFFER_SIZE];
-      vsnprintf(buffer, MAX_BUFFER_SIZE-1, format.c_str(), args);
+      vsnprintf(buffer, MAX_BUFFER_SIZE-1, format, args);
+      deliverMessage(messageType, buffer);
+    }
+
+    void DataBroker::deliverMessage(MessageType messageType,
+                                    const char *text) {
       DataPackage messagePackage;
-      messagePackage.add("message", std::string(buffer));
+      messagePackage.add("message", std::string(text));
       pushData(pushMessageIds[messageType], messagePackage);
     }
 
+    void DataBroker::pushMessage(MessageType messageType,
+                                 const std::string &format, va_list args) {
+      queueMessage(messageType, NULL, format.c_str(), args);
+    }
+
+    void DataBroker::logMessage(MessageType messageType,
+                                const char *format, va_list args) {
+      // the LOG_* macros pass string literals, so the format identifies
+      // the call site
+      queueMessage(messageType, format, format, args);
+    }
+
     void DataBroker::pushMessage(MessageType messageType,
                                  const std::string &format, ...) {
       va_list args;
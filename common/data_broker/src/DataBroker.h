@@ -50,6 +50,7 @@ namespace mars {
 
     class ReceiverInterface;
     class ProducerInterface;
+    class MessageQueue;
     struct DataElement;
 
     inline bool hasWildcards(const std::string &str) {
@@ -271,6 +272,13 @@ namespace mars {
       virtual void pushInfo(const std::string &format, ...);
       virtual void pushDebug(const std::string &format, ...);
 
+      using DataBrokerInterface::logMessage;
+      virtual void logMessage(MessageType messageType,
+                              const char *format, va_list args);
+
+      /** \brief Pushes a formatted message to its _MESSAGES_ stream. */
+      void deliverMessage(MessageType messageType, const char *text);
+
     private:
       DataElement *createDataElement(const std::string &groupName,
                                      const std::string &dataName,
@@ -324,6 +332,10 @@ namespace mars {
       std::map<std::string, Timer> timers;
       unsigned long newStreamId;
       unsigned long pushMessageIds[__DB_MESSAGE_TYPE_COUNT];
+      MessageQueue *messageQueue;
+
+      void queueMessage(MessageType messageType, const char *site,
+                        const char *format, va_list args);
     }; // end of class definition DataBroker
 
   } // end of namespace data_broker
@@ -558,6 +558,26 @@ namespace mars {
       virtual void pushInfo(const std::string &format, ...) = 0;
       virtual void pushDebug(const std::string &format, ...) = 0;
 
+      /**
+       * \brief pushes a message of a call site. Used by the LOG_* macros.
+       *
+       * Implementations may deliver the message asynchronously and limit the
+       * rate of messages with the same \a format pointer, so \a format
+       * should be a string literal. The default implementation calls
+       * pushMessage.
+       */
+      virtual void logMessage(MessageType messageType,
+                              const char *format, va_list args) {
+        pushMessage(messageType, std::string(format), args);
+      }
+
+      void logMessage(MessageType messageType, const char *format, ...) {
+        va_list args;
+        va_start(args, format);
+        logMessage(messageType, format, args);
+        va_end(args);
+      }
+
     }; // end of class definition DataBrokerInterface
 
 
@@ -0,0 +1,206 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "MessageQueue.h"
+#include "DataBroker.h"
+
+#include <mars/utils/MutexLocker.h>
+#include <mars/utils/misc.h>
+
+#include <cstdio>
+#include <unordered_map>
+
+namespace mars {
+  namespace data_broker {
+
+    using namespace mars::utils;
+
+    static const int messageSize = 1024;
+    static const unsigned int ringSize = 128;
+    static const int maxMessagesPerSite = 20;
+    static const long long rateWindow = 1000; // ms
+    static const unsigned long sleepTime = 10; // ms
+
+    static std::atomic<unsigned long> nextQueueId(1);
+
+    /// \cond HIDDEN_SYMBOLS
+    struct MessageRing {
+      struct Slot {
+        MessageType type;
+        char text[messageSize];
+      };
+
+      MessageRing() : head(0), tail(0), dropped(0), orphaned(false) {}
+
+      Slot slots[ringSize];
+      // head is only written by the producer, tail only by the consumer
+      std::atomic<unsigned int> head, tail;
+      std::atomic<unsigned long> dropped;
+      // set when the producing thread exited
+      std::atomic<bool> orphaned;
+    };
+
+    struct SiteState {
+      long long windowStart;
+      int count;
+      unsigned long suppressed;
+    };
+
+    // the ring and the rate limits of the calling thread
+    struct ThreadMessageState {
+      ThreadMessageState() : queueId(0) {}
+      ~ThreadMessageState() {
+        if(ring) ring->orphaned.store(true, std::memory_order_release);
+      }
+
+      unsigned long queueId;
+      std::shared_ptr<MessageRing> ring;
+      std::unordered_map<const char*, SiteState> sites;
+    };
+    /// \endcond
+
+    static thread_local ThreadMessageState threadState;
+
+    MessageQueue::MessageQueue(DataBroker *dataBroker) :
+      mars::utils::Thread(), dataBroker(dataBroker),
+      queueId(nextQueueId++),
+      deliverMutex(MUTEX_TYPE_RECURSIVE), stopThread(false) {
+      start();
+    }
+
+    MessageQueue::~MessageQueue() {
+      stopThread = true;
+      wait();
+      flush();
+    }
+
+    MessageRing* MessageQueue::getRing() {
+      if(threadState.queueId != queueId) {
+        if(threadState.ring) {
+          threadState.ring->orphaned.store(true, std::memory_order_release);
+        }
+        threadState.ring.reset(new MessageRing);
+        threadState.sites.clear();
+        threadState.queueId = queueId;
+        MutexLocker locker(&ringsMutex);
+        rings.push_back(threadState.ring);
+      }
+      return threadState.ring.get();
+    }
+
+    void MessageQueue::push(MessageType messageType, const char *site,
+                            const char *format, va_list args) {
+      MessageRing *ring = getRing();
+      unsigned long suppressed = 0;
+
+      if(site) {
+        long long now = getTime();
+        SiteState &state = threadState.sites[site];
+        if(state.count == 0 || now - state.windowStart >= rateWindow) {
+          suppressed = state.suppressed;
+          state.windowStart = now;
+          state.count = 0;
+          state.suppressed = 0;
+        }
+        if(++state.count > maxMessagesPerSite) {
+          ++state.suppressed;
+          return;
+        }
+      }
+
+      unsigned int head = ring->head.load(std::memory_order_relaxed);
+      if(head - ring->tail.load(std::memory_order_acquire) >= ringSize) {
+        ring->dropped.fetch_add(1 + suppressed, std::memory_order_relaxed);
+        return;
+      }
+      MessageRing::Slot &slot = ring->slots[head % ringSize];
+      slot.type = messageType;
+      int length = 0;
+      if(suppressed) {
+        length = snprintf(slot.text, messageSize,
+                          "(%lu similar messages suppressed) ", suppressed);
+        if(length < 0 || length >= messageSize) length = 0;
+      }
+      vsnprintf(slot.text + length, messageSize - length, format, args);
+      ring->head.store(head+1, std::memory_order_release);
+    }
+
+    void MessageQueue::deliver(MessageType messageType, const char *text) {
+      dataBroker->deliverMessage(messageType, text);
+    }
+
+    void MessageQueue::deliver() {
+      MutexLocker deliverLocker(&deliverMutex);
+      std::vector<std::shared_ptr<MessageRing> > current;
+      ringsMutex.lock();
+      current = rings;
+      ringsMutex.unlock();
+
+      bool removeOrphans = false;
+      for(size_t i=0; i<current.size(); ++i) {
+        MessageRing *ring = current[i].get();
+        // read orphaned first, so no message is pushed after the check
+        bool orphaned = ring->orphaned.load(std::memory_order_acquire);
+        unsigned int head = ring->head.load(std::memory_order_acquire);
+        unsigned int tail;
+        // a receiver may flush the queue recursively, so the tail is
+        // reloaded for every message
+        while((int)(head - (tail = ring->tail.load(std::memory_order_relaxed))) > 0) {
+          MessageRing::Slot &slot = ring->slots[tail % ringSize];
+          deliver(slot.type, slot.text);
+          ring->tail.compare_exchange_strong(tail, tail+1,
+                                             std::memory_order_release);
+        }
+        unsigned long dropped = ring->dropped.exchange(0);
+        if(dropped) {
+          char text[128];
+          snprintf(text, sizeof(text),
+                   "%lu log messages were dropped", dropped);
+          deliver(DB_MESSAGE_TYPE_WARNING, text);
+        }
+        if(orphaned) removeOrphans = true;
+      }
+
+      if(removeOrphans) {
+        MutexLocker locker(&ringsMutex);
+        for(size_t i=0; i<rings.size(); ) {
+          MessageRing *ring = rings[i].get();
+          if(ring->orphaned.load(std::memory_order_acquire) &&
+             ring->head.load() == ring->tail.load()) {
+            rings.erase(rings.begin()+i);
+          }
+          else ++i;
+        }
+      }
+    }
+
+    void MessageQueue::flush() {
+      deliver();
+    }
+
+    void MessageQueue::run() {
+      while(!stopThread) {
+        deliver();
+        msleep(sleepTime);
+      }
+    }
+
+  } // end of namespace data_broker
+} // end of namespace mars
@@ -0,0 +1,93 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file MessageQueue.h
+ * \brief Queues the log messages of the DataBroker and delivers them from
+ *        a background thread.
+ *
+ * Every thread that logs gets its own single producer ring, so queueing a
+ * message takes no lock. The messages of one call site, identified by the
+ * pointer of its format string, are limited to maxMessagesPerSite per
+ * second and thread. Suppressed and dropped messages are counted and
+ * reported with the next delivered message.
+ */
+
+#ifndef DATA_BROKER_MESSAGE_QUEUE_H
+#define DATA_BROKER_MESSAGE_QUEUE_H
+
+#ifdef _PRINT_HEADER_
+  #warning "MessageQueue.h"
+#endif
+
+#include "DataBrokerInterface.h"
+
+#include <mars/utils/Thread.h>
+#include <mars/utils/Mutex.h>
+
+#include <atomic>
+#include <cstdarg>
+#include <memory>
+#include <vector>
+
+namespace mars {
+  namespace data_broker {
+
+    class DataBroker;
+    struct MessageRing;
+
+    class MessageQueue : public mars::utils::Thread {
+    public:
+      explicit MessageQueue(DataBroker *dataBroker);
+      ~MessageQueue();
+
+      /**
+       * \brief Formats and queues a message of the calling thread.
+       * \param site Identifies the call site for rate limiting. Messages
+       *             with a \c NULL site are not limited.
+       */
+      void push(MessageType messageType, const char *site,
+                const char *format, va_list args);
+
+      /** \brief Delivers all queued messages from the calling thread. */
+      void flush();
+
+    protected:
+      void run();
+
+    private:
+      DataBroker *dataBroker;
+      // distinguishes queues that are created at the same address
+      unsigned long queueId;
+      std::vector<std::shared_ptr<MessageRing> > rings;
+      mars::utils::Mutex ringsMutex;
+      // serializes the consumers of the rings
+      mars::utils::Mutex deliverMutex;
+      std::atomic<bool> stopThread;
+
+      MessageRing* getRing();
+      void deliver();
+      void deliver(MessageType messageType, const char *text);
+    };
+
+  } // end of namespace data_broker
+} // end of namespace mars
+
+#endif // DATA_BROKER_MESSAGE_QUEUE_H
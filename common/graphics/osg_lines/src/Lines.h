@@ -59,6 +59,14 @@ namespace osg_lines {
     virtual void* getOSGNode() = 0;
     virtual void setBezierMode(bool bezier = true) = 0;
     virtual void setBezierInterpolationPoints(int numPoints = 20) = 0;
+    /**
+     * Switches the lines into streaming mode: the vertices are kept in a
+     * fixed-capacity ring buffer (VBO) and only the newest \c capacity
+     * points are drawn. Appending becomes constant-cost. A capacity of 0
+     * returns to the default unbounded mode. Bezier mode is ignored while
+     * streaming.
+     */
+    virtual void setStreamingCapacity(unsigned long capacity) = 0;
   };
 
 } // end of namespace: osg_lines
@@ -29,6 +29,7 @@
 #include "LinesP.h"
 
 #include <cstdio>
+#include <vector>
 
 namespace osg_lines {
   
@@ -37,6 +38,7 @@ namespace osg_lines {
     strip = true;
     bezierMode = false;
     bezierInterpolationPoints = 20;
+    streamCapacity = streamHead = streamCount = streamTotal = 0;
     linesTransform = new osg::MatrixTransform;
 
     node = new osg::Geode;
@@ -85,6 +87,11 @@ namespace osg_lines {
   }
 
   void LinesP::appendData(Vector v) {
+    if(streamCapacity) {
+      pushStreamPoint(osg::Vec3(v.x, v.y, v.z));
+      updateStreamRange();
+      return;
+    }
     origPoints->push_back(osg::Vec3(v.x, v.y, v.z));
     points->push_back(osg::Vec3(v.x, v.y, v.z));
     drawArray->setCount(points->size());
@@ -93,6 +100,16 @@ namespace osg_lines {
 
   void LinesP::setData(std::list<Vector> p) {
     std::list<Vector>::iterator it=p.begin();
+    if(streamCapacity) {
+      streamHead = streamCount = streamTotal = 0;
+      // only the newest streamCapacity points can be shown
+      for(size_t skip=p.size(); skip>streamCapacity; --skip) ++it;
+      for(;it!=p.end(); ++it) {
+        pushStreamPoint(osg::Vec3(it->x, it->y, it->z));
+      }
+      updateStreamRange();
+      return;
+    }
     origPoints->clear();
     points->clear();
     for(;it!=p.end(); ++it) {
@@ -120,6 +137,7 @@ namespace osg_lines {
       drawArray->setCount(points->size());
       linesGeom->addPrimitiveSet(drawArray.get());
     }
+    if(streamCapacity) updateStreamRange();
   }
 
   void LinesP::setColor(Color c) {
@@ -145,6 +163,11 @@ namespace osg_lines {
   }
 
   void LinesP::dirty(void) {
+    if(streamCapacity) {
+      colors->dirty();
+      linesGeom->dirtyBound();
+      return;
+    }
     linesGeom->dirtyDisplayList();
     linesGeom->dirtyBound();   
     if(bezierMode) {
@@ -193,4 +216,73 @@ namespace osg_lines {
     bezierInterpolationPoints = numPoints;
   }
 
+  void LinesP::setStreamingCapacity(unsigned long capacity) {
+    // keep the currently visible points when switching modes
+    std::vector<osg::Vec3> current;
+    if(streamCapacity) {
+      unsigned long first = (streamCount == streamCapacity) ? streamHead : 0;
+      for(unsigned long i=0; i<streamCount; ++i) {
+        current.push_back((*points.get())[first+i]);
+      }
+    }
+    else {
+      current.assign(origPoints->begin(), origPoints->end());
+    }
+
+    streamCapacity = capacity;
+    streamHead = streamCount = streamTotal = 0;
+    origPoints->clear();
+    if(capacity) {
+      // the vertex data is updated in place, so avoid the display list
+      // recompilation and stream the fixed size array via a VBO instead
+      linesGeom->setUseDisplayList(false);
+      linesGeom->setUseVertexBufferObjects(true);
+      points->resize(2*capacity);
+      size_t start = current.size() > capacity ? current.size()-capacity : 0;
+      for(size_t i=start; i<current.size(); ++i) {
+        pushStreamPoint(current[i]);
+      }
+      updateStreamRange();
+    }
+    else {
+      linesGeom->setUseVertexBufferObjects(false);
+      linesGeom->setUseDisplayList(true);
+      points->clear();
+      for(size_t i=0; i<current.size(); ++i) {
+        origPoints->push_back(current[i]);
+        points->push_back(current[i]);
+      }
+      drawArray->setFirst(0);
+      drawArray->setCount(points->size());
+      dirty();
+    }
+  }
+
+  void LinesP::pushStreamPoint(const osg::Vec3 &p) {
+    (*points.get())[streamHead] = p;
+    (*points.get())[streamHead+streamCapacity] = p;
+    if(++streamHead == streamCapacity) streamHead = 0;
+    if(streamCount < streamCapacity) ++streamCount;
+    ++streamTotal;
+  }
+
+  void LinesP::updateStreamRange() {
+    unsigned long first = (streamCount == streamCapacity) ? streamHead : 0;
+    unsigned long count = streamCount;
+    if(!strip) {
+      // only draw complete segments: skip a leading point whose partner
+      // was already overwritten and a trailing point without partner
+      if((streamTotal-streamCount) & 1) {
+        ++first;
+        --count;
+      }
+      count &= ~1ul;
+    }
+    drawArray->setFirst(first);
+    drawArray->setCount(count);
+    drawArray->dirty();
+    points->dirty();
+    linesGeom->dirtyBound();
+  }
+
 } // end of namespace: osg_lines
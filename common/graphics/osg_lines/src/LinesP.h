@@ -56,10 +56,15 @@ namespace osg_lines {
     void* getOSGNode();
     void setBezierMode(bool bezier);
     void setBezierInterpolationPoints(int numPoints);
+    void setStreamingCapacity(unsigned long capacity);
 
   private:
     bool strip, bezierMode;
     int bezierInterpolationPoints;
+    // ring buffer state for streaming mode; in strip mode every sample is
+    // stored twice (at i and i+capacity) so that the newest
+    // streamCapacity points always form one contiguous range
+    unsigned long streamCapacity, streamHead, streamCount, streamTotal;
     osg::ref_ptr<osg::Vec3Array> points, origPoints;
     osg::ref_ptr<osg::Geometry> linesGeom;
     osg::ref_ptr<osg::MatrixTransform> linesTransform;
@@ -69,6 +74,8 @@ namespace osg_lines {
     osg::ref_ptr<osg::Geode> node;
 
     osg::Vec3 getBezierPoint(float t);
+    void updateStreamRange();
+    void pushStreamPoint(const osg::Vec3 &p);
   };
 
 } // end of namespace: osg_lines
@@ -42,7 +42,10 @@
 
 #include <opencv2/opencv.hpp>
 
+#include <algorithm>
 #include <cmath>
+#include <sys/stat.h>
+#include <dirent.h>
 
 namespace osg_material_manager {
 
@@ -725,8 +728,8 @@ namespace osg_material_manager {
     stateSet->removeUniform(envMapScaleUniform.get());
     stateSet->removeUniform(terrainScaleZUniform.get());
     stateSet->removeUniform(terrainDimUniform.get());
-    ShaderFactory factory;
-    osg::Program *glslProgram;
+    bool tangents = checkTexture("normalMap") || checkTexture("environmentMap");
+    osg::ref_ptr<osg::Program> glslProgram;
 
     if(!map.hasKey("shader")) {
       map["shader"]["PixelLightVertex"] = true;
@@ -737,6 +740,178 @@ namespace osg_material_manager {
       }
     }
 
+    bool terrainShader = false;
+    if(map["shader"].hasKey("provider")) {
+      terrainShader = ((string)map["shader"]["provider"] == "DRockGraph" &&
+                       textures.find("terrainMap") != textures.end());
+    }
+    else {
+      terrainShader = map["shader"].hasKey("TerrainMapVertex");
+    }
+    if(terrainShader) {
+      stateSet->addUniform(terrainScaleZUniform.get());
+      stateSet->addUniform(terrainDimUniform.get());
+      terrainScaleZUniform->set((float)(double)map["scaleZ"]);
+    }
+    stateSet->addUniform(noiseMapUniform.get());
+    if(has_texture) {
+      stateSet->addUniform(texScaleUniform.get());
+      stateSet->addUniform(sinUniform.get());
+      stateSet->addUniform(cosUniform.get());
+    }
+    else {
+      stateSet->removeUniform(texScaleUniform.get());
+    }
+    if (map.hasKey("envMapSpecular")) {
+      envMapSpecularUniform->set(osg::Vec4((double)map["envMapSpecular"]["r"],
+                                           (double)map["envMapSpecular"]["g"],
+                                           (double)map["envMapSpecular"]["b"],
+                                           (double)map["envMapSpecular"]["a"]));
+      stateSet->addUniform(envMapSpecularUniform.get());
+    }
+    if (map.hasKey("envMapScale")) {
+      envMapScaleUniform->set(osg::Vec4((double)map["envMapScale"]["r"],
+                                        (double)map["envMapScale"]["g"],
+                                        (double)map["envMapScale"]["b"],
+                                        (double)map["envMapScale"]["a"]));
+      stateSet->addUniform(envMapScaleUniform.get());
+    }
+    if(map.hasKey("shaderSources")) {
+      // load shader from text file
+      glslProgram = new osg::Program();
+      { // load vertex shader
+        string file = map["shaderSources"]["vertexShader"];
+        if(!loadPath.empty() && file[0] != '/') {
+          file = loadPath + file;
+        }
+        std::ifstream t(file.c_str());
+        std::stringstream buffer;
+        buffer << t.rdbuf();
+        string source = buffer.str();
+        osg::Shader *shader = new osg::Shader(osg::Shader::VERTEX);
+        glslProgram->addShader(shader);
+        shader->setShaderSource( source );
+      }
+      { // load fragment shader
+        string file = map["shaderSources"]["fragmentShader"];
+        if(!loadPath.empty() && file[0] != '/') {
+          file = loadPath + file;
+        }
+        std::ifstream t(file.c_str());
+        std::stringstream buffer;
+        buffer << t.rdbuf();
+        string source = buffer.str();
+        osg::Shader *shader = new osg::Shader(osg::Shader::FRAGMENT);
+        glslProgram->addShader(shader);
+        shader->setShaderSource( source );
+      }
+    } else {
+      // materials with the same shader inputs share one generated program
+      string vertexSource, fragmentSource;
+      string key = getShaderKey(has_texture, tangents);
+      glslProgram = OsgMaterialManager::getShaderProgram(key, &vertexSource,
+                                                         &fragmentSource);
+      if(!glslProgram.valid()) {
+        ShaderFactory factory;
+        setupShaderFactory(&factory, has_texture);
+        vertexSource = factory.generateShaderSource(SHADER_TYPE_VERTEX);
+        fragmentSource = factory.generateShaderSource(SHADER_TYPE_FRAGMENT);
+        glslProgram = OsgMaterialManager::addShaderProgram(key, vertexSource,
+                                                           fragmentSource);
+      }
+      if(map.hasKey("printShader") && (bool)map["printShader"]) {
+        std::string filename = "shader_sources/" + name + "_vert.c";
+        createDirectory("shader_sources");
+        FILE *f = fopen(filename.c_str(), "w");
+        fprintf(f, "%s", vertexSource.c_str());
+        fclose(f);
+        filename = "shader_sources/" + name + "_frag.c";
+        f = fopen(filename.c_str(), "w");
+        fprintf(f, "%s", fragmentSource.c_str());
+        fclose(f);
+      }
+    }
+    if(tangents) {
+      glslProgram->addBindAttribLocation( "vertexTangent", TANGENT_UNIT );
+      stateSet->addUniform(bumpNorFacUniform.get());
+    } else {
+      stateSet->removeUniform(bumpNorFacUniform.get());
+    }
+    if(lastProgram.valid()) {
+      stateSet->removeAttribute(lastProgram.get());
+    }
+    stateSet->setAttributeAndModes(glslProgram.get(),
+                                   osg::StateAttribute::ON);
+
+    stateSet->removeUniform(shadowSamplesUniform.get());
+    stateSet->removeUniform(invShadowSamplesUniform.get());
+    stateSet->removeUniform(invShadowTextureSizeUniform.get());
+    stateSet->removeUniform(shadowScaleUniform.get());
+
+    stateSet->addUniform(shadowSamplesUniform.get());
+    stateSet->addUniform(invShadowSamplesUniform.get());
+    stateSet->addUniform(invShadowTextureSizeUniform.get());
+    stateSet->addUniform(shadowScaleUniform.get());
+
+    lastProgram = glslProgram;
+  }
+
+  static long getModificationTime(const string &file) {
+    struct stat info;
+    if(stat(file.c_str(), &info) != 0) return 0;
+    return (long)info.st_mtime;
+  }
+
+  /**
+   * \brief Returns the newest modification time of the files in \a dir.
+   * The shader generators pick their snippets from these directories.
+   */
+  static long getNewestModificationTime(const string &dir) {
+    long newest = 0;
+    DIR *d = opendir(dir.c_str());
+    if(!d) return 0;
+    struct dirent *entry;
+    while((entry = readdir(d))) {
+      if(entry->d_name[0] == '.') continue;
+      newest = std::max(newest, getModificationTime(dir + "/" + entry->d_name));
+    }
+    closedir(d);
+    return newest;
+  }
+
+  string OsgMaterial::getShaderKey(bool has_texture, bool tangents) {
+    // everything the generated sources depend on has to be part of the key
+    stringstream key;
+    key << resPath << "|" << loadPath << "|" << maxNumLights << "|";
+    key << shadowSamples << "|" << (useShadow ? shadowTechnique : "none");
+    key << "|" << has_texture << useWorldTexCoords << tangents;
+    key << checkTexture("diffuseMap") << map.hasKey("instancing") << "|";
+    // the built-in shader snippets may change between runs as well
+    key << getNewestModificationTime(resPath + "/shader") << "|";
+    key << getNewestModificationTime(resPath + "/graph_shader") << "|";
+    if(map["shader"].hasKey("custom")) {
+      key << getNewestModificationTime(loadPath + (string)map["shader"]["custom"]);
+      key << "|";
+    }
+    if(map["shader"].hasKey("provider")) {
+      // the graph files may change between runs of a persistent cache
+      string vertexPath = map["shader"]["vertex"];
+      string fragmentPath = map["shader"]["fragment"];
+      if(!loadPath.empty() && vertexPath[0] != '/') {
+        vertexPath = loadPath + vertexPath;
+      }
+      if(!loadPath.empty() && fragmentPath[0] != '/') {
+        fragmentPath = loadPath + fragmentPath;
+      }
+      key << getModificationTime(vertexPath) << "|";
+      key << getModificationTime(fragmentPath) << "|";
+    }
+    key << map["shader"].toYamlString();
+    return key.str();
+  }
+
+  void OsgMaterial::setupShaderFactory(ShaderFactory *factory,
+                                       bool has_texture) {
     if (map["shader"].hasKey("provider")) {
       if ((string)map["shader"]["provider"] == "DRockGraph") {
         ConfigMap options;
@@ -759,13 +934,8 @@ namespace osg_material_manager {
 
         DRockGraphSP *vertexProvider = new DRockGraphSP(resPath, vertexModel, options, shadowTechnique_);
         DRockGraphSP *fragmentProvider = new DRockGraphSP(resPath, fragmentModel, options, shadowTechnique_);
-        factory.setShaderProvider(vertexProvider, SHADER_TYPE_VERTEX);
-        factory.setShaderProvider(fragmentProvider, SHADER_TYPE_FRAGMENT);
-        if(textures.find("terrainMap") != textures.end()) {
-          stateSet->addUniform(terrainScaleZUniform.get());
-          stateSet->addUniform(terrainDimUniform.get());
-          terrainScaleZUniform->set((float)(double)map["scaleZ"]);
-        }
+        factory->setShaderProvider(vertexProvider, SHADER_TYPE_VERTEX);
+        factory->setShaderProvider(fragmentProvider, SHADER_TYPE_FRAGMENT);
       } else if ((string)map["shader"]["provider"] == "PhobosGraph") {
         ConfigMap options;
         options["numLights"] = maxNumLights;
@@ -786,8 +956,8 @@ namespace osg_material_manager {
         ConfigMap fragmentModel = ConfigMap::fromYamlFile(fragmentPath);
         PhobosGraphSP *vertexProvider = new PhobosGraphSP(resPath, vertexModel, options);
         PhobosGraphSP *fragmentProvider = new PhobosGraphSP(resPath, fragmentModel, options);
-        factory.setShaderProvider(vertexProvider, SHADER_TYPE_VERTEX);
-        factory.setShaderProvider(fragmentProvider, SHADER_TYPE_FRAGMENT);
+        factory->setShaderProvider(vertexProvider, SHADER_TYPE_VERTEX);
+        factory->setShaderProvider(fragmentProvider, SHADER_TYPE_FRAGMENT);
       }
     } else {
       vector<string> args;
@@ -799,9 +969,6 @@ namespace osg_material_manager {
         ConfigMap map2 = ConfigMap::fromYamlFile(resPath+"/shader/terrainMap_vert.yml");
         YamlShader *terrainMapVert = new YamlShader((string)map2["name"], args, map2, resPath);
         vertexShader->addShaderFunction(terrainMapVert);
-        stateSet->addUniform(terrainScaleZUniform.get());
-        stateSet->addUniform(terrainDimUniform.get());
-        terrainScaleZUniform->set((float)(double)map["scaleZ"]);
       }
       if (map["shader"].hasKey("PixelLightVertex")) {
         ConfigMap map2 = ConfigMap::fromYamlFile(resPath+"/shader/plight_vert.yaml");
@@ -856,103 +1023,10 @@ namespace osg_material_manager {
       }
 
       vertexShader->setupShaderEnv(SHADER_TYPE_VERTEX, map, has_texture, useWorldTexCoords);
-      factory.setShaderProvider(vertexShader, SHADER_TYPE_VERTEX);
+      factory->setShaderProvider(vertexShader, SHADER_TYPE_VERTEX);
       fragmentShader->setupShaderEnv(SHADER_TYPE_FRAGMENT, map, has_texture, useWorldTexCoords);
-      factory.setShaderProvider(fragmentShader, SHADER_TYPE_FRAGMENT);
-    }
-    stateSet->addUniform(noiseMapUniform.get());
-    if(has_texture) {
-      stateSet->addUniform(texScaleUniform.get());
-      stateSet->addUniform(sinUniform.get());
-      stateSet->addUniform(cosUniform.get());
-    }
-    else {
-      stateSet->removeUniform(texScaleUniform.get());
-    }
-    if (map.hasKey("envMapSpecular")) {
-      envMapSpecularUniform->set(osg::Vec4((double)map["envMapSpecular"]["r"],
-                                           (double)map["envMapSpecular"]["g"],
-                                           (double)map["envMapSpecular"]["b"],
-                                           (double)map["envMapSpecular"]["a"]));
-      stateSet->addUniform(envMapSpecularUniform.get());
-    }
-    if (map.hasKey("envMapScale")) {
-      envMapScaleUniform->set(osg::Vec4((double)map["envMapScale"]["r"],
-                                        (double)map["envMapScale"]["g"],
-                                        (double)map["envMapScale"]["b"],
-                                        (double)map["envMapScale"]["a"]));
-      stateSet->addUniform(envMapScaleUniform.get());
-    }
-    if(map.hasKey("shaderSources")) {
-      // load shader from text file
-      // todo: handle uniforms in a way that we dont need to create the shader
-      //       sources above
-      glslProgram = new osg::Program();
-      { // load vertex shader
-        string file = map["shaderSources"]["vertexShader"];
-        if(!loadPath.empty() && file[0] != '/') {
-          file = loadPath + file;
-        }
-        std::ifstream t(file.c_str());
-        std::stringstream buffer;
-        buffer << t.rdbuf();
-        string source = buffer.str();
-        osg::Shader *shader = new osg::Shader(osg::Shader::VERTEX);
-        glslProgram->addShader(shader);
-        shader->setShaderSource( source );
-      }
-      { // load fragment shader
-        string file = map["shaderSources"]["fragmentShader"];
-        if(!loadPath.empty() && file[0] != '/') {
-          file = loadPath + file;
-        }
-        std::ifstream t(file.c_str());
-        std::stringstream buffer;
-        buffer << t.rdbuf();
-        string source = buffer.str();
-        osg::Shader *shader = new osg::Shader(osg::Shader::FRAGMENT);
-        glslProgram->addShader(shader);
-        shader->setShaderSource( source );
-      }
-    } else {
-      glslProgram = factory.generateProgram();
-      if(map.hasKey("printShader") && (bool)map["printShader"]) {
-        std::string source = factory.generateShaderSource(SHADER_TYPE_VERTEX);
-        std::string filename = "shader_sources/" + name + "_vert.c";
-        createDirectory("shader_sources");
-        FILE *f = fopen(filename.c_str(), "w");
-        fprintf(f, "%s", source.c_str());
-        fclose(f);
-        source = factory.generateShaderSource(SHADER_TYPE_FRAGMENT);
-        filename = "shader_sources/" + name + "_frag.c";
-        f = fopen(filename.c_str(), "w");
-        fprintf(f, "%s", source.c_str());
-        fclose(f);
-      }
-    }
-    if(checkTexture("normalMap") || checkTexture("environmentMap")) {
-      glslProgram->addBindAttribLocation( "vertexTangent", TANGENT_UNIT );
-      stateSet->addUniform(bumpNorFacUniform.get());
-    } else {
-      stateSet->removeUniform(bumpNorFacUniform.get());
-    }
-    if(lastProgram.valid()) {
-      stateSet->removeAttribute(lastProgram.get());
+      factory->setShaderProvider(fragmentShader, SHADER_TYPE_FRAGMENT);
     }
-    stateSet->setAttributeAndModes(glslProgram,
-                                   osg::StateAttribute::ON);
-
-    stateSet->removeUniform(shadowSamplesUniform.get());
-    stateSet->removeUniform(invShadowSamplesUniform.get());
-    stateSet->removeUniform(invShadowTextureSizeUniform.get());
-    stateSet->removeUniform(shadowScaleUniform.get());
-
-    stateSet->addUniform(shadowSamplesUniform.get());
-    stateSet->addUniform(invShadowSamplesUniform.get());
-    stateSet->addUniform(invShadowTextureSizeUniform.get());
-    stateSet->addUniform(shadowScaleUniform.get());
-
-    lastProgram = glslProgram;
   }
 
   void OsgMaterial::setNoiseImage(osg::Image *i) {
@@ -65,6 +65,7 @@
 namespace osg_material_manager {
 
   class MaterialNode;
+  class ShaderFactory;
 
   class TextureInfo {
   public:
@@ -169,6 +170,8 @@ namespace osg_material_manager {
     osg::Vec4 getColor(std::string key);
     void setColor(std::string color, std::string key, std::string value);
     osg::Texture2D* loadTerrainTexture(std::string filename);
+    std::string getShaderKey(bool has_texture, bool tangents);
+    void setupShaderFactory(ShaderFactory *factory, bool has_texture);
 }; // end of class OsgMaterial
 
 } // end of namespace osg_material_manager
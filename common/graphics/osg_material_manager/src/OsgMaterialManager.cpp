@@ -38,12 +38,18 @@
 #include "MaterialNode.h"
 #include <osgDB/ReadFile>
 #include <osgDB/WriteFile>
+#include <mars/utils/misc.h>
+
+#include <functional>
+#include <cstdio>
 
 namespace osg_material_manager {
 
   std::vector<OsgMaterialManager::textureFileStruct> OsgMaterialManager::textureFiles;
   std::vector<OsgMaterialManager::imageFileStruct> OsgMaterialManager::imageFiles;
   std::map<std::string,osg::ref_ptr<osg::TextureCubeMap>> OsgMaterialManager::cubemaps;
+  std::map<std::string, OsgMaterialManager::shaderProgramStruct> OsgMaterialManager::shaderPrograms;
+  std::string OsgMaterialManager::shaderCachePath;
 
   OsgMaterialManager::OsgMaterialManager(const std::string &resourcesPath) : lib_manager::LibInterface(NULL) {
     resPath.sValue = resourcesPath;
@@ -72,6 +78,10 @@ namespace osg_material_manager {
       shadowSamples = cfg->getOrCreateProperty("Graphics",
                                                "shadowSamples",
                                                shadowSamples.iValue, this);
+      cfgShaderCachePath = cfg->getOrCreateProperty("Graphics",
+                                                    "shaderCachePath",
+                                                    std::string(""), this);
+      shaderCachePath = cfgShaderCachePath.sValue;
     }
     noiseImage = new osg::Image();
     noiseImage->allocateImage(128, 128, 4, GL_RGBA, GL_UNSIGNED_BYTE);
@@ -90,6 +100,8 @@ namespace osg_material_manager {
   }
 
   OsgMaterialManager::~OsgMaterialManager(void) {
+    // the programs belong to the graphics context of this manager
+    clearShaderPrograms();
     if(cfg) libManager->releaseLibrary("cfg_manager");
     //fprintf(stderr, "Delete osg_material_manager\n");
   }
@@ -214,6 +226,76 @@ namespace osg_material_manager {
       resPath.sValue = _property.sValue;
       return;
     }
+    if(_property.paramId == cfgShaderCachePath.paramId) {
+      shaderCachePath = cfgShaderCachePath.sValue = _property.sValue;
+      return;
+    }
+  }
+
+  osg::ref_ptr<osg::Program> OsgMaterialManager::createProgram(const std::string &vertexSource,
+                                                               const std::string &fragmentSource) {
+    osg::ref_ptr<osg::Program> program = new osg::Program();
+    osg::Shader *shader = new osg::Shader(osg::Shader::VERTEX);
+    shader->setShaderSource(vertexSource);
+    program->addShader(shader);
+    shader = new osg::Shader(osg::Shader::FRAGMENT);
+    shader->setShaderSource(fragmentSource);
+    program->addShader(shader);
+    return program;
+  }
+
+  std::string OsgMaterialManager::getShaderCacheFile(const std::string &key) {
+    char name[64];
+    snprintf(name, 64, "%016zx.yml", std::hash<std::string>()(key));
+    return mars::utils::pathJoin(shaderCachePath, name);
+  }
+
+  osg::ref_ptr<osg::Program> OsgMaterialManager::getShaderProgram(const std::string &key,
+                                                                  std::string *vertexSource,
+                                                                  std::string *fragmentSource) {
+    std::map<std::string, shaderProgramStruct>::iterator it;
+    it = shaderPrograms.find(key);
+    if(it != shaderPrograms.end()) {
+      *vertexSource = it->second.vertexSource;
+      *fragmentSource = it->second.fragmentSource;
+      return it->second.program;
+    }
+    if(shaderCachePath.empty()) return NULL;
+
+    std::string file = getShaderCacheFile(key);
+    if(!mars::utils::pathExists(file)) return NULL;
+    configmaps::ConfigMap map = configmaps::ConfigMap::fromYamlFile(file);
+    // the file name is only a hash of the key, so check for collisions
+    if(!map.hasKey("key") || (std::string)map["key"] != key) return NULL;
+    shaderProgramStruct &entry = shaderPrograms[key];
+    entry.vertexSource << map["vertex"];
+    entry.fragmentSource << map["fragment"];
+    entry.program = createProgram(entry.vertexSource, entry.fragmentSource);
+    *vertexSource = entry.vertexSource;
+    *fragmentSource = entry.fragmentSource;
+    return entry.program;
+  }
+
+  osg::ref_ptr<osg::Program> OsgMaterialManager::addShaderProgram(const std::string &key,
+                                                                  const std::string &vertexSource,
+                                                                  const std::string &fragmentSource) {
+    shaderProgramStruct &entry = shaderPrograms[key];
+    entry.vertexSource = vertexSource;
+    entry.fragmentSource = fragmentSource;
+    entry.program = createProgram(vertexSource, fragmentSource);
+    if(!shaderCachePath.empty()) {
+      configmaps::ConfigMap map;
+      map["key"] = key;
+      map["vertex"] = vertexSource;
+      map["fragment"] = fragmentSource;
+      mars::utils::createDirectory(shaderCachePath);
+      map.toYamlFile(getShaderCacheFile(key));
+    }
+    return entry.program;
+  }
+
+  void OsgMaterialManager::clearShaderPrograms() {
+    shaderPrograms.clear();
   }
 
   void OsgMaterialManager::setShadowSamples(int v) {
@@ -38,6 +38,8 @@
 #include <mars/cfg_manager/CFGClient.h>
 #include <mars/interfaces/LightData.h>
 
+#include <osg/Program>
+
 namespace osg_material_manager {
 
   class OsgMaterialManager : public lib_manager::LibInterface,
@@ -53,6 +55,11 @@ namespace osg_material_manager {
       osg::ref_ptr<osg::Image> image;
     }; // end of struct imageFileStruct
 
+    struct shaderProgramStruct {
+      std::string vertexSource, fragmentSource;
+      osg::ref_ptr<osg::Program> program;
+    }; // end of struct shaderProgramStruct
+
   public:
     OsgMaterialManager(lib_manager::LibManager *theManager);
     OsgMaterialManager(const std::string &resourcesPath);
@@ -107,6 +114,23 @@ namespace osg_material_manager {
     static osg::ref_ptr<osg::Texture2D> loadTexture(std::string filename);
     static osg::ref_ptr<osg::Image> loadImage(std::string filename);
 
+    /**
+     * Generated shader programs are shared between all materials with the
+     * same shader inputs. The key has to describe all inputs of the shader
+     * generation. If a shader cache path is configured the sources are also
+     * stored on disk and reused by following runs.
+     * getShaderProgram returns NULL if the key is not cached.
+     * The destructor calls clearShaderPrograms, because the programs are
+     * bound to the graphics context of the manager.
+     */
+    static osg::ref_ptr<osg::Program> getShaderProgram(const std::string &key,
+                                                       std::string *vertexSource,
+                                                       std::string *fragmentSource);
+    static osg::ref_ptr<osg::Program> addShaderProgram(const std::string &key,
+                                                       const std::string &vertexSource,
+                                                       const std::string &fragmentSource);
+    static void clearShaderPrograms();
+
   private:
     mars::cfg_manager::CFGManagerInterface *cfg;
     osg::ref_ptr<osg::Group> mainStateGroup;
@@ -128,6 +152,13 @@ namespace osg_material_manager {
     static std::vector<textureFileStruct> textureFiles;
     static std::vector<imageFileStruct> imageFiles;
     static std::map<std::string,osg::ref_ptr<osg::TextureCubeMap>> cubemaps;
+    static std::map<std::string, shaderProgramStruct> shaderPrograms;
+    static std::string shaderCachePath;
+    mars::cfg_manager::cfgPropertyStruct cfgShaderCachePath;
+
+    static osg::ref_ptr<osg::Program> createProgram(const std::string &vertexSource,
+                                                    const std::string &fragmentSource);
+    static std::string getShaderCacheFile(const std::string &key);
   };
 
 } // end of namespace: osg_material_manager
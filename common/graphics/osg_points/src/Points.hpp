@@ -53,6 +53,13 @@ namespace osg_points {
     virtual void setColors(const std::vector<Color> &colors) = 0;
     virtual void setLineWidth(double w) = 0;
     virtual void* getOSGNode() = 0;
+    /**
+     * Switches the points into streaming mode: the vertices are kept in a
+     * fixed-capacity ring buffer (VBO) and the oldest points are
+     * overwritten once \c capacity is reached. A capacity of 0 returns to
+     * the default unbounded mode.
+     */
+    virtual void setStreamingCapacity(unsigned long capacity) = 0;
   };
 
 } // end of namespace: osg_points
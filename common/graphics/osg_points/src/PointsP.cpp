@@ -29,11 +29,15 @@
 #include "PointsP.hpp"
 
 #include <cstdio>
+#include <algorithm>
+#include <vector>
 
 namespace osg_points {
 
   PointsP::PointsP() {
 
+    streamCapacity = streamHead = streamCount = 0;
+
     pointsTransform = new osg::MatrixTransform;
 
     node = new osg::Geode;
@@ -80,6 +84,16 @@ namespace osg_points {
   }
 
   void PointsP::appendData(Vector v) {
+    if(streamCapacity) {
+      (*points.get())[streamHead] = osg::Vec3(v.x, v.y, v.z);
+      if(++streamHead == streamCapacity) streamHead = 0;
+      if(streamCount < streamCapacity) ++streamCount;
+      drawArray->setCount(streamCount);
+      drawArray->dirty();
+      points->dirty();
+      pointsGeom->dirtyBound();
+      return;
+    }
     points->push_back(osg::Vec3(v.x, v.y, v.z));
     drawArray->setCount(points->size());
     dirty();
@@ -87,6 +101,20 @@ namespace osg_points {
 
   void PointsP::setData(const std::vector<Vector> &p) {
     std::vector<Vector>::const_iterator it=p.begin();
+    if(streamCapacity) {
+      // upload in one go; only the newest streamCapacity points are kept
+      if(p.size() > streamCapacity) it += p.size()-streamCapacity;
+      streamCount = 0;
+      for(;it!=p.end(); ++it) {
+        (*points.get())[streamCount++] = osg::Vec3(it->x, it->y, it->z);
+      }
+      streamHead = streamCount % streamCapacity;
+      drawArray->setCount(streamCount);
+      drawArray->dirty();
+      points->dirty();
+      pointsGeom->dirtyBound();
+      return;
+    }
     points->clear();
     for(;it!=p.end(); ++it) {
       points->push_back(osg::Vec3(it->x, it->y, it->z));
@@ -116,6 +144,9 @@ namespace osg_points {
   }
 
   void PointsP::dirty(void) {
+    if(streamCapacity) {
+      colors->dirty();
+    }
     pointsGeom->dirtyDisplayList();
     pointsGeom->dirtyBound();
   }
@@ -124,4 +155,41 @@ namespace osg_points {
     return (void*)(osg::Node*)node.get();
   }
 
+  void PointsP::setStreamingCapacity(unsigned long capacity) {
+    if(capacity) {
+      // keep the newest points that fit into the new buffer
+      unsigned long n = streamCapacity ? streamCount : points->size();
+      unsigned long oldest = 0;
+      if(streamCapacity && streamCount == streamCapacity) oldest = streamHead;
+      std::vector<osg::Vec3> current;
+      for(unsigned long i=0; i<n; ++i) {
+        current.push_back((*points.get())[(oldest+i) % points->size()]);
+      }
+      if(current.size() > capacity) {
+        current.erase(current.begin(), current.end()-capacity);
+      }
+      // the vertex data is updated in place, so avoid the display list
+      // recompilation and stream the fixed size array via a VBO instead
+      pointsGeom->setUseDisplayList(false);
+      pointsGeom->setUseVertexBufferObjects(true);
+      points->resize(capacity);
+      std::copy(current.begin(), current.end(), points->begin());
+      streamCapacity = capacity;
+      streamCount = current.size();
+      streamHead = streamCount % streamCapacity;
+    }
+    else {
+      if(streamCapacity) {
+        points->resize(streamCount);
+      }
+      streamCapacity = streamHead = streamCount = 0;
+      pointsGeom->setUseVertexBufferObjects(false);
+      pointsGeom->setUseDisplayList(true);
+    }
+    drawArray->setCount(streamCapacity ? streamCount : points->size());
+    drawArray->dirty();
+    points->dirty();
+    dirty();
+  }
+
 } // end of namespace: osg_points
@@ -49,8 +49,12 @@ namespace osg_points {
     void setLineWidth(double w);
     void dirty(void);
     void* getOSGNode();
+    void setStreamingCapacity(unsigned long capacity);
 
   private:
+    // ring buffer state for streaming mode; the draw order of points does
+    // not matter, so the buffer is drawn as [0, streamCount)
+    unsigned long streamCapacity, streamHead, streamCount;
     osg::ref_ptr<osg::Vec3Array> points;
     osg::ref_ptr<osg::Geometry> pointsGeom;
     osg::ref_ptr<osg::MatrixTransform> pointsTransform;
@@ -25,6 +25,8 @@
 #endif
 
 #include "MultiResHeightMapRenderer.h"
+#include <mars/utils/misc.h>
+#include <algorithm>
 #include <cstdlib>
 #include <cassert>
 #include <cmath>
@@ -44,6 +46,24 @@ namespace osg_terrain {
     float texCoord[2];
   };
 
+  // number of threads filling new sub tiles beside the refinement thread
+  static const int numTileWorkers = 3;
+  // time in ms per frame that may be spent on uploading sub tiles
+  static const long long uploadBudget = 2;
+  // time in seconds the tiles are prefetched ahead of the camera motion
+  static const double prefetchTime = 0.5;
+
+  class TileWorker : public mars::utils::Thread {
+  public:
+    TileWorker(MultiResHeightMapRenderer *renderer) : renderer(renderer) {}
+  protected:
+    void run() {
+      renderer->processTileJobs();
+    }
+  private:
+    MultiResHeightMapRenderer *renderer;
+  };
+
   MultiResHeightMapRenderer::MultiResHeightMapRenderer(int gridW, int gridH,
                                                        double visualW,
                                                        double visualH,
@@ -62,8 +82,8 @@ namespace osg_terrain {
     numSubTiles = 0;
     prepare();
     dirty = true;
-    swapBuffer = false;
-    swapBuffer2 = false;
+    mainTileDirty = false;
+    pendingTileJobs = 0;
     wireframe = false;
     highWireframe = false;
     solid = true;
@@ -77,6 +97,16 @@ namespace osg_terrain {
   }
 
   MultiResHeightMapRenderer::~MultiResHeightMapRenderer() {
+    jobMutex.lock();
+    finish = true;
+    jobCondition.wakeAll();
+    jobMutex.unlock();
+    if(isRunning()) wait();
+    for(size_t i=0; i<tileWorkers.size(); ++i) {
+      tileWorkers[i]->wait();
+      delete tileWorkers[i];
+    }
+    tileWorkers.clear();
     clear();
     delete[] vboIds;
     vboIds = NULL;
@@ -112,7 +142,13 @@ namespace osg_terrain {
     }
     // Initializes cube geometry and transfers it to VBOs
     highIsInitialized = initPlane(true);
-    if(highIsInitialized) this->start();
+    if(highIsInitialized) {
+      for(int i=0; i<numTileWorkers; ++i) {
+        tileWorkers.push_back(new TileWorker(this));
+        tileWorkers.back()->start();
+      }
+      this->start();
+    }
   }
 
 
@@ -155,6 +191,11 @@ namespace osg_terrain {
     fprintf(stderr, "num vertices: %d\n", numVertices+highNumVertices);
     numIndices = getLowResCellCntX()*getLowResCellCntY()*6;
     highNumIndices = scale*numIndices*maxNumSubTiles;//maxNumSubTiles*getHighResCellCntX()*getHighResCellCntY()*6;
+    // the prefetch position needs at most four sub tiles per level
+    prefetchSubTiles = 4*depth;
+    highNumVertices += prefetchSubTiles*numVertices;
+    highNumIndices += prefetchSubTiles*numIndices;
+    maxNumSubTiles += prefetchSubTiles;
     indicesToDraw = getLowResCellCntX()*getLowResCellCntY()*6;
     highIndicesToDraw = 0;
     highIndicesToDrawBuffer = 0;
@@ -256,61 +297,15 @@ namespace osg_terrain {
                     vertices[index].tangent, true);
         }
       }
+      mainTileDirty = true;
       dataMutex.unlock();
       dirty = false;
-      swapMutex.lock();
-      swapBuffer = true;
-      swapMutex.unlock();
     }
 
     if(!highIsInitialized) highInitialize();
     if(!highIsInitialized) return;
 
-    swapMutex.lock();
-    if(swapBuffer) {
-      swapMutex.unlock();
-      glBindBuffer(GL_ARRAY_BUFFER, vboIds[2]);
-      glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vboIds[3]);
-      VertexData *vertices = (VertexData*)glMapBuffer(GL_ARRAY_BUFFER,
-                                                      GL_WRITE_ONLY);
-
-      GLuint *indices = (GLuint*)glMapBuffer(GL_ELEMENT_ARRAY_BUFFER,
-                                             GL_WRITE_ONLY);
-
-      dataMutex.lock();
-      if(vertices) {
-        memcpy(vertices, highVertexCopy, listSubTiles.size()*numVertices*sizeof(VertexData));
-      }
-      if(indices) {
-        memcpy(indices, highIndexCopy, highIndicesToDrawBuffer*sizeof(GLuint));
-      }
-      glUnmapBuffer(GL_ARRAY_BUFFER);
-      glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER);
-      glBindBuffer(GL_ARRAY_BUFFER, vboIds[0]);
-      glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vboIds[1]);
-      vertices = (VertexData*)glMapBuffer(GL_ARRAY_BUFFER,
-                                          GL_WRITE_ONLY);
-
-      indices = (GLuint*)glMapBuffer(GL_ELEMENT_ARRAY_BUFFER,
-                                     GL_WRITE_ONLY);
-
-      if(vertices) {
-        memcpy(vertices, vertexCopy, numVertices*sizeof(VertexData));
-      }
-      if(indices) {
-        memcpy(indices, indexCopy, numIndices*sizeof(GLuint));
-      }
-      glUnmapBuffer(GL_ARRAY_BUFFER);
-      glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER);
-
-      highIndicesToDraw = highIndicesToDrawBuffer;
-      dataMutex.unlock();
-      glBindBuffer(GL_ARRAY_BUFFER, 0);
-      glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-      swapMutex.lock();
-      swapBuffer = false;
-    }
-    swapMutex.unlock();
+    uploadTiles();
     render(false);
 
     if(highIsInitialized && highIndicesToDraw) {
@@ -318,11 +313,8 @@ namespace osg_terrain {
     }
   }
 
-  void MultiResHeightMapRenderer::handleCamPos(double x, double y, Tile *tile) {
-    // get cell in main tile
-    //fprintf(stderr, "check: %lu\n", tile);
-    //fprintf(stderr, "%g %g %g %g\n", tile->xPos, tile->yPos, x, y);
-    std::vector<Tile*>::iterator it, it2;
+  void MultiResHeightMapRenderer::getCamCells(double x, double y, Tile *tile,
+                                              std::vector<std::pair<int,int> > *cells) {
     double cellStepX = tile->width/3;
     double cellStepY = tile->height/3;
     double x2 = x - 0.5*cellStepX;
@@ -331,80 +323,97 @@ namespace osg_terrain {
     int celly = floor((-tile->yPos + y2) / cellStepY);
     int cellx2 = floor((-tile->xPos + x + 0.5*cellStepX) / cellStepX);
     int celly2 = floor((-tile->yPos + y + 0.5*cellStepY) / cellStepY);
-    std::vector<Tile*> tiles;
 
     // todo: num cell tiles is everywhere in this file hardcoded with 3
-    bool skip = false;
     if(x-tile->xPos+0.5*cellStepX < 0 ||
        x-tile->xPos-0.5*cellStepX > tile->width ||
        y-tile->yPos+0.5*cellStepY < 0 ||
        y-tile->yPos-0.5*cellStepY > tile->height) {
-      skip = true;
-    }
-    if(!skip) {
-      for(int i=0; i<4; ++i) {
-        int cy, cx;
-        if(i==0) {
-          cx = cellx;
-          cy = celly;
-          if(cx < 0 || cy < 0) continue;
-          if(cx > 2) cx = 2;
-          if(cy > 2) cy = 2;
-        }
-        else if(i==1) {
-          cx = cellx2;
-          cy = celly;
-          if(cy < 0) continue;
-          if(cx < 0) cx = 0;
-          if(cx > 2) continue;
-          if(cy > 2) cy = 2;
-        }
-        else if(i==2) {
-          cx = cellx;
-          cy = celly2;
-          if(cx < 0) continue;
-          if(cy < 0) cy = 0;
-          if(cy > 2) continue;
-          if(cx > 2) cx = 2;
-        }
-        else if(i==3) {
-          cx = cellx2;
-          cy = celly2;
-          if(cx > 2 || cy > 2) continue;
-          if(cx < 0) cx = 0;
-          if(cy < 0) cy=0;
-        }
-        // now check that we don't already have this cell in this loop
-        bool found = false;
-        for(it=tiles.begin(); it!=tiles.end(); ++it) {
+      return;
+    }
+    for(int i=0; i<4; ++i) {
+      int cy, cx;
+      if(i==0) {
+        cx = cellx;
+        cy = celly;
+        if(cx < 0 || cy < 0) continue;
+        if(cx > 2) cx = 2;
+        if(cy > 2) cy = 2;
+      }
+      else if(i==1) {
+        cx = cellx2;
+        cy = celly;
+        if(cy < 0) continue;
+        if(cx < 0) cx = 0;
+        if(cx > 2) continue;
+        if(cy > 2) cy = 2;
+      }
+      else if(i==2) {
+        cx = cellx;
+        cy = celly2;
+        if(cx < 0) continue;
+        if(cy < 0) cy = 0;
+        if(cy > 2) continue;
+        if(cx > 2) cx = 2;
+      }
+      else {
+        cx = cellx2;
+        cy = celly2;
+        if(cx > 2 || cy > 2) continue;
+        if(cx < 0) cx = 0;
+        if(cy < 0) cy=0;
+      }
+      // now check that we don't already have this cell
+      std::pair<int,int> cell(cx, cy);
+      if(std::find(cells->begin(), cells->end(), cell) == cells->end()) {
+        cells->push_back(cell);
+      }
+    }
+  }
+
+  void MultiResHeightMapRenderer::handleCamPos(double x, double y,
+                                               double px, double py,
+                                               Tile *tile) {
+    //fprintf(stderr, "check: %lu\n", tile);
+    //fprintf(stderr, "%g %g %g %g\n", tile->xPos, tile->yPos, x, y);
+    std::vector<Tile*>::iterator it, it2;
+    std::vector<std::pair<int,int> > cells;
+    std::vector<Tile*> tiles, newTiles;
+
+    // the cells around the current camera position come first, so that
+    // they are created even if the prefetch runs out of memory
+    getCamCells(x, y, tile, &cells);
+    getCamCells(px, py, tile, &cells);
+
+    for(size_t i=0; i<cells.size(); ++i) {
+      int cx = cells[i].first;
+      int cy = cells[i].second;
+      // check wether the subtile already exists
+      bool found = false;
+      for(it=tile->subTiles.begin(); it!=tile->subTiles.end(); ++it) {
+        if(*it != 0) {
           if((*it)->x == cx && (*it)->y == cy) {
+            tiles.push_back(*it);
             found = true;
             break;
           }
         }
-        if(found) continue;
-        // now check wether the subtile already exists
-        for(it=tile->subTiles.begin(); it!=tile->subTiles.end(); ++it) {
-          if(*it != 0) {
-            if((*it)->x == cx && (*it)->y == cy) {
-              tiles.push_back(*it);
-              found = true;
-              break;
-            }
-          }
-        }
-        if(found) continue;
-        // else create it
-        cutTile(cx, cy, tile);
-        //fprintf(stderr, "create: cx: %d cy: %d px: %g py: %g w: %g %lu %g %g\n", cx, cy, tile->xPos, tile->yPos, tile->width/3, tile, x, y);
-        //if(depth < 6)
-        Tile *newTile = createSubTile(cx, cy, tile);
-        if(newTile) tiles.push_back(newTile);
-        else {
-          fprintf(stderr, "----- we just created an hole!!!!!!!\n");
-        }
+      }
+      if(found) continue;
+      // else create it
+      cutTile(cx, cy, tile);
+      //fprintf(stderr, "create: cx: %d cy: %d px: %g py: %g w: %g %lu %g %g\n", cx, cy, tile->xPos, tile->yPos, tile->width/3, tile, x, y);
+      Tile *newTile = createSubTile(cx, cy, tile);
+      if(newTile) {
+        tiles.push_back(newTile);
+        newTiles.push_back(newTile);
+      }
+      else {
+        fprintf(stderr, "----- we just created an hole!!!!!!!\n");
       }
     }
+    fillSubTiles(newTiles);
+
     // now remove the subtiles that are not any more in use
     for(it=tile->subTiles.begin(); it!=tile->subTiles.end(); ++it) {
       //fprintf(stderr, "check remove\n");
@@ -424,6 +433,98 @@ namespace osg_terrain {
     tile->subTiles.swap(tiles);
   }
 
+  void MultiResHeightMapRenderer::fillSubTiles(std::vector<Tile*> &tiles) {
+    if(tiles.empty()) return;
+    if(tiles.size() == 1 || tileWorkers.empty()) {
+      for(size_t i=0; i<tiles.size(); ++i) fillSubTile(tiles[i]);
+      return;
+    }
+    // the tiles are written to disjoint parts of the buffers, thus the
+    // workers only have to synchronize on the job list
+    jobMutex.lock();
+    tileJobs.insert(tileJobs.end(), tiles.begin(), tiles.end());
+    pendingTileJobs += tiles.size();
+    jobCondition.wakeAll();
+    while(!tileJobs.empty()) {
+      Tile *tile = tileJobs.back();
+      tileJobs.pop_back();
+      jobMutex.unlock();
+      fillSubTile(tile);
+      jobMutex.lock();
+      --pendingTileJobs;
+    }
+    while(pendingTileJobs > 0) {
+      jobsDoneCondition.wait(&jobMutex);
+    }
+    jobMutex.unlock();
+  }
+
+  void MultiResHeightMapRenderer::processTileJobs() {
+    jobMutex.lock();
+    while(!finish) {
+      if(tileJobs.empty()) {
+        jobCondition.wait(&jobMutex);
+        continue;
+      }
+      Tile *tile = tileJobs.back();
+      tileJobs.pop_back();
+      jobMutex.unlock();
+      fillSubTile(tile);
+      jobMutex.lock();
+      if(--pendingTileJobs == 0) jobsDoneCondition.wakeAll();
+    }
+    jobMutex.unlock();
+  }
+
+  void MultiResHeightMapRenderer::uploadTiles() {
+    // the refinement thread holds the lock while it changes the tiles,
+    // in that case we keep drawing the last uploaded state
+    if(dataMutex.tryLock() != mars::utils::MUTEX_ERROR_NO_ERROR) return;
+    if(!mainTileDirty && dirtySlots.empty()) {
+      dataMutex.unlock();
+      return;
+    }
+
+    if(mainTileDirty) {
+      glBindBuffer(GL_ARRAY_BUFFER, vboIds[0]);
+      glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vboIds[1]);
+      glBufferSubData(GL_ARRAY_BUFFER, 0, numVertices*sizeof(VertexData),
+                      vertexCopy);
+      glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, numIndices*sizeof(GLuint),
+                      indexCopy);
+      mainTileDirty = false;
+    }
+
+    // upload only the changed sub tiles and spread them over several
+    // frames if there are too many; new tiles are appended to the end of
+    // the buffer, so uploading from the back adds them before their parents
+    // get cut
+    glBindBuffer(GL_ARRAY_BUFFER, vboIds[2]);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vboIds[3]);
+    long long startTime = mars::utils::getTime();
+    while(!dirtySlots.empty()) {
+      std::set<int>::iterator it = --dirtySlots.end();
+      int slot = *it;
+      if(slot < static_cast<int>(listSubTiles.size())) {
+        glBufferSubData(GL_ARRAY_BUFFER,
+                        slot*numVertices*sizeof(VertexData),
+                        numVertices*sizeof(VertexData),
+                        highVertexCopy+slot*numVertices);
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER,
+                        slot*numIndices*sizeof(GLuint),
+                        numIndices*sizeof(GLuint),
+                        highIndexCopy+slot*numIndices);
+      }
+      dirtySlots.erase(it);
+      if(mars::utils::getTimeDiff(startTime) >= uploadBudget) break;
+    }
+    // only draw the new tile count if all tiles are uploaded
+    if(dirtySlots.empty()) highIndicesToDraw = highIndicesToDrawBuffer;
+    dataMutex.unlock();
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+  }
+
   void MultiResHeightMapRenderer::clearTile(Tile *tile) {
 
     std::vector<Tile*>::iterator it;
@@ -686,8 +787,8 @@ namespace osg_terrain {
     */
     highIndicesToDrawBuffer += numIndices;
     //fprintf(stderr, "_todraw: %d\n", highIndicesToDraw);
-    //fprintf(stderr, "fill subtile\n");
-    fillSubTile(newTile);
+    // the vertices are filled by the caller, possibly on a worker thread
+    dirtySlots.insert(newTile->verticesArrayOffset/numVertices);
     newTile->listPos = listSubTiles.size();
     listSubTiles.push_back(newTile);
     return newTile;
@@ -702,8 +803,11 @@ namespace osg_terrain {
   void MultiResHeightMapRenderer::cutHole(int x, int y, int x2, int y2,
                                           Tile *tile) {
     GLuint *indices = highIndexCopy;
-    if(tile==mainTile) indices = indexCopy;
-    swapBuffer2 = true;
+    if(tile==mainTile) {
+      indices = indexCopy;
+      mainTileDirty = true;
+    }
+    else dirtySlots.insert(tile->indicesArrayOffset/numIndices);
     if(indices) {
       for(int l = x; l<x+x2; ++l) {
         for(int n = y; n<y+y2; ++n) {
@@ -718,8 +822,11 @@ namespace osg_terrain {
     int nx = tile->rows/3;
     int ny = tile->cols/3;
     GLuint *indices = highIndexCopy;
-    if(tile==mainTile) indices = indexCopy;
-    swapBuffer2 = true;
+    if(tile==mainTile) {
+      indices = indexCopy;
+      mainTileDirty = true;
+    }
+    else dirtySlots.insert(tile->indicesArrayOffset/numIndices);
     if(indices) {
       int offset = tile->indicesArrayOffset;
       int x2 = tile->verticesArrayOffset;
@@ -743,7 +850,6 @@ namespace osg_terrain {
     // use highResBuffer
     VertexData *vertices = highVertexCopy;
     GLuint *indices = highIndexCopy;
-    swapBuffer2 = true;
     if(vertices) {
       int x2 = tile->verticesArrayOffset;
       int index;
@@ -1007,7 +1113,7 @@ namespace osg_terrain {
                                            Tile *tile) {
     VertexData *vertices = highVertexCopy;
     GLuint *indices = highIndexCopy;
-    swapBuffer2 = true;
+    dirtySlots.insert(verticesOffsetPos/numVertices);
 
     if(vertices) {
       //fprintf(stderr, "copy vertices from %d to %d\n", tile->verticesArrayOffset, verticesOffsetPos);
@@ -1044,13 +1150,28 @@ namespace osg_terrain {
     std::vector<Tile*> nextTiles2;
     std::vector<Tile*>::iterator outer, inner;
     int d;
-    double x, y;
+    double x, y, px, py;
+    double lastX = camX, lastY = camY;
+    double vx = 0, vy = 0;
+    long long lastTime = mars::utils::getTime();
     while(!finish && depth > 0) {
-      swapBuffer2 = false;
       dataMutex.lock();
       x = camX;
       y = camY;
-      handleCamPos(x, y, mainTile);
+      // extrapolate the camera motion to create the tiles before the
+      // camera reaches them
+      long long now = mars::utils::getTime();
+      double dt = (now - lastTime)*0.001;
+      if(dt > 0) {
+        vx = (x - lastX) / dt;
+        vy = (y - lastY) / dt;
+      }
+      lastX = x;
+      lastY = y;
+      lastTime = now;
+      px = x + vx*prefetchTime;
+      py = y + vy*prefetchTime;
+      handleCamPos(x, y, px, py, mainTile);
       d = 1;
       // handle cam pos on current subtiles
       nextTiles.clear();
@@ -1062,7 +1183,7 @@ namespace osg_terrain {
           for(inner=(*outer)->subTiles.begin();
               inner!=(*outer)->subTiles.end();
               ++inner) {
-            handleCamPos(x, y, *inner);
+            handleCamPos(x, y, px, py, *inner);
             nextTiles2.push_back(*inner);
             //fprintf(stderr, "-depth: %d %d\n", depth, offset);
           }
@@ -1072,11 +1193,6 @@ namespace osg_terrain {
         d += 1;
       }
       dataMutex.unlock();
-      if(swapBuffer2) {
-        swapMutex.lock();
-        swapBuffer = true;
-        swapMutex.unlock();
-      }
       msleep(40);
     }
   }
@@ -43,11 +43,13 @@
 #endif
 #include <map>
 #include <list>
+#include <set>
 #include <vector>
 #include <opencv2/opencv.hpp>
 
 #include <mars/utils/Thread.h>
 #include <mars/utils/Mutex.h>
+#include <mars/utils/WaitCondition.h>
 
 namespace osg_terrain {
 
@@ -72,6 +74,7 @@ namespace osg_terrain {
   }; // Tile
 
   struct VertexData;
+  class TileWorker;
 
   class MultiResHeightMapRenderer : public mars::utils::Thread {
   public:
@@ -130,7 +133,14 @@ namespace osg_terrain {
     bool initPlane(bool highRes);
     void recalcSteps();
     double getHeight(double x, double y);
-    void handleCamPos(double x, double y, Tile *tile);
+    // refines the tile around the camera position (x, y) and the
+    // predicted camera position (px, py)
+    void handleCamPos(double x, double y, double px, double py, Tile *tile);
+    void getCamCells(double x, double y, Tile *tile,
+                     std::vector<std::pair<int, int> > *cells);
+    void fillSubTiles(std::vector<Tile*> &tiles);
+    void processTileJobs();
+    void uploadTiles();
     void clearTile(Tile *tile);
     void drawPatch(int x, int y, Tile *tile);
     void moveTile(int indicesOffsetPos, int verticesOffsetPos, Tile *tile);
@@ -158,8 +168,19 @@ namespace osg_terrain {
     // for thread optimization
     VertexData *vertexCopy, *highVertexCopy;
     GLuint *indexCopy, *highIndexCopy;
-    bool swapBuffer, swapBuffer2, finish;
-    mars::utils::Mutex dataMutex, swapMutex;
+    bool finish;
+    mars::utils::Mutex dataMutex;
+    // sub tile slots that changed since the last upload, the slots are
+    // uploaded incrementally within a time budget per frame
+    std::set<int> dirtySlots;
+    bool mainTileDirty;
+
+    // workers that fill the vertex data of new sub tiles in parallel
+    std::vector<TileWorker*> tileWorkers;
+    std::vector<Tile*> tileJobs;
+    int pendingTileJobs;
+    mars::utils::Mutex jobMutex;
+    mars::utils::WaitCondition jobCondition, jobsDoneCondition;
 
     int numVertices, numIndices;
     int highNumVertices, highNumIndices;
@@ -168,6 +189,8 @@ namespace osg_terrain {
     double highStepX, highStepY;
     int highWidth, highHeight;
     int maxNumSubTiles, numSubTiles, depth;
+    // additional sub tiles reserved for the prefetch ahead of the camera
+    int prefetchSubTiles;
     double newIndicesPos, newVerticesPos;
     bool dirty;
     double minX, minY, minZ, maxX, maxY, maxZ;
@@ -189,6 +212,7 @@ namespace osg_terrain {
     //void drawSubTile(Tile *tile);
     void render(bool highRes);
 
+    friend class TileWorker;
   }; // class MultiResHeightMapRenderer
   
 } // namespace osg_terrain
@@ -2,8 +2,27 @@
 #include "DataBrokerPlotterLib.h"
 
 #include<QVBoxLayout>
+#include <algorithm>
 
 namespace data_broker_plotter {
+
+  /**
+   * Sets the range of \a axis like QCPAxis::rescale and returns false if
+   * the range did not change.
+   */
+  static bool setAxisRange(QCPAxis *axis, double lower, double upper) {
+    if(lower == upper) {
+      // keep the current size centered around the single value
+      double size = axis->range().size();
+      lower -= 0.5*size;
+      upper += 0.5*size;
+    }
+    if(axis->range().lower == lower && axis->range().upper == upper) {
+      return false;
+    }
+    axis->setRange(lower, upper);
+    return true;
+  }
   
   DataBrokerPlotter::DataBrokerPlotter(DataBrokerPlotterLib *_mainLib,
                                mars::data_broker::DataBrokerInterface *_dataBroker,
@@ -78,6 +97,13 @@ namespace data_broker_plotter {
           if(callbackParam % 10) {
             x = x*p->yScale.dValue+p->yOffset.dValue;
             p->yValues.push_back(x);
+            if(p->yValues.size() == 1) {
+              p->yMin = p->yMax = x;
+            }
+            else {
+              p->yMin = std::min(p->yMin, x);
+              p->yMax = std::max(p->yMax, x);
+            }
             p->gotNewData |= 1;
           }
           else {
@@ -88,7 +114,13 @@ namespace data_broker_plotter {
               xmin = x-xRange;
               while(!p->xValues.empty() && p->xValues.front() < xmin) {
                 p->xValues.pop_front();
-                p->yValues.pop_front();
+                if(!p->yValues.empty()) {
+                  if(p->yValues.front() <= p->yMin ||
+                     p->yValues.front() >= p->yMax) {
+                    p->yBoundsDirty = true;
+                  }
+                  p->yValues.pop_front();
+                }
               }
             }
             p->gotNewData |= 2;
@@ -117,13 +149,48 @@ namespace data_broker_plotter {
       packageList.pop_front();
     }
 
-    bool onlyEnlarge = false;
+    bool gotNewData = false;
     for(it=plots.begin(); it!=plots.end(); ++it) {
-      if((*it)->gotNewData == 3) {
-        (*it)->curve->setData((*it)->xValues, (*it)->yValues);
-        (*it)->curve->rescaleAxes(onlyEnlarge);
-        onlyEnlarge = true;
-        (*it)->gotNewData = 0;
+      p = *it;
+      if(p->gotNewData == 3) {
+        p->curve->setData(p->xValues, p->yValues);
+        if(p->yBoundsDirty && !p->yValues.empty()) {
+          QVector<double>::const_iterator minMax;
+          minMax = std::min_element(p->yValues.begin(), p->yValues.end());
+          p->yMin = *minMax;
+          minMax = std::max_element(p->yValues.begin(), p->yValues.end());
+          p->yMax = *minMax;
+        }
+        p->yBoundsDirty = false;
+        p->gotNewData = 0;
+        gotNewData = true;
+      }
+    }
+    // The axes cover all curves. The x values are sorted and the y bounds
+    // are kept up to date above, so no curve data has to be scanned here.
+    if(gotNewData) {
+      bool haveRange = false;
+      double xLower = 0.0, xUpper = 0.0, yLower = 0.0, yUpper = 0.0;
+      for(it=plots.begin(); it!=plots.end(); ++it) {
+        p = *it;
+        if(p->xValues.empty() || p->yValues.empty()) continue;
+        if(!haveRange) {
+          xLower = p->xValues.front();
+          xUpper = p->xValues.back();
+          yLower = p->yMin;
+          yUpper = p->yMax;
+          haveRange = true;
+        }
+        else {
+          xLower = std::min(xLower, p->xValues.front());
+          xUpper = std::max(xUpper, p->xValues.back());
+          yLower = std::min(yLower, p->yMin);
+          yUpper = std::max(yUpper, p->yMax);
+        }
+      }
+      if(haveRange) {
+        setAxisRange(qcPlot->xAxis, xLower, xUpper);
+        setAxisRange(qcPlot->yAxis, yLower, yUpper);
       }
     }
     qcPlot->replot();
@@ -192,6 +259,8 @@ namespace data_broker_plotter {
     dataBroker->registerSyncReceiver(this, "data_broker_plotter",
                                      tmpString, newPlot->dpId*10+1);
     newPlot->gotData = 0;
+    newPlot->yMin = newPlot->yMax = 0.0;
+    newPlot->yBoundsDirty = false;
     
     tmpString = cfgName;
     tmpString.append("sTime");
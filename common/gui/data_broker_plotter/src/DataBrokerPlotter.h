@@ -36,6 +36,9 @@ namespace data_broker_plotter {
     mars::data_broker::DataPackage dpPackage;
     int dpId, gotNewData;
     bool gotData;
+    // bounds of yValues; recomputed if a bound value was dropped
+    double yMin, yMax;
+    bool yBoundsDirty;
     QMutex mutex;
     mars::cfg_manager::cfgPropertyStruct xRange, yScale, sTime, yOffset;
     std::map<mars::cfg_manager::cfgParamId, mars::cfg_manager::cfgPropertyStruct*> cfgParamIdProp;
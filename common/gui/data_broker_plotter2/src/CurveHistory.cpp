@@ -0,0 +1,204 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "CurveHistory.hpp"
+
+namespace data_broker_plotter2 {
+
+  // number of buckets of a level combined into one bucket of the next level
+  static const int levelFactor = 8;
+  // no level is created with less buckets than this
+  static const size_t minLevelSize = 16;
+
+  CurveHistory::CurveHistory(size_t capacity_) : capacity(0) {
+    setCapacity(capacity_);
+  }
+
+  void CurveHistory::setCapacity(size_t capacity_) {
+    if(capacity_ == 0) capacity_ = 1;
+    if(capacity_ == capacity) return;
+
+    std::vector<Sample> keep;
+    size_t first = samples.size() > capacity_ ? samples.size() - capacity_ : 0;
+    for(size_t i=first; i<samples.size(); ++i) {
+      keep.push_back(samples[i]);
+    }
+
+    capacity = capacity_;
+    samples.reset(capacity);
+    levels.clear();
+    size_t levelSize = capacity/levelFactor;
+    while(levelSize >= minLevelSize) {
+      levels.push_back(Level());
+      // one extra bucket covers the samples of the pending buckets
+      levels.back().buckets.reset(levelSize+1);
+      levels.back().pendingCount = 0;
+      levelSize /= levelFactor;
+    }
+
+    for(size_t i=0; i<keep.size(); ++i) {
+      add(keep[i].time, keep[i].value);
+    }
+  }
+
+  void CurveHistory::clear() {
+    samples.clear();
+    for(size_t i=0; i<levels.size(); ++i) {
+      levels[i].buckets.clear();
+      levels[i].pendingCount = 0;
+    }
+  }
+
+  void CurveHistory::add(double time, double value) {
+    Sample sample = {time, value};
+    samples.push(sample);
+    if(levels.empty()) return;
+    Bucket bucket = {time, time, time, value, time, value};
+    addBucket(0, bucket);
+  }
+
+  void CurveHistory::addBucket(size_t level, const Bucket &bucket) {
+    Level &l = levels[level];
+    if(l.pendingCount == 0) {
+      l.pending = bucket;
+    }
+    else {
+      l.pending.end = bucket.end;
+      if(bucket.min < l.pending.min) {
+        l.pending.min = bucket.min;
+        l.pending.minTime = bucket.minTime;
+      }
+      if(bucket.max > l.pending.max) {
+        l.pending.max = bucket.max;
+        l.pending.maxTime = bucket.maxTime;
+      }
+    }
+    if(++l.pendingCount < levelFactor) return;
+    l.buckets.push(l.pending);
+    l.pendingCount = 0;
+    if(level+1 < levels.size()) addBucket(level+1, l.pending);
+  }
+
+  size_t CurveHistory::findSample(double time, bool after) const {
+    size_t low = 0, high = samples.size();
+    while(low < high) {
+      size_t mid = (low+high)/2;
+      double t = samples[mid].time;
+      if(t < time || (after && t == time)) low = mid+1;
+      else high = mid;
+    }
+    return low;
+  }
+
+  size_t CurveHistory::findBucket(size_t level, double time,
+                                  bool byStart) const {
+    const Ring<Bucket> &buckets = levels[level].buckets;
+    size_t low = 0, high = buckets.size();
+    while(low < high) {
+      size_t mid = (low+high)/2;
+      double t = byStart ? buckets[mid].start : buckets[mid].end;
+      if(t <= time) low = mid+1;
+      else high = mid;
+    }
+    return low;
+  }
+
+  size_t CurveHistory::countRange(size_t level, double start,
+                                  double end) const {
+    if(level == 0) {
+      return findSample(end, true) - findSample(start, false);
+    }
+    size_t first = findBucket(level-1, start, false);
+    size_t last = findBucket(level-1, end, true);
+    return last > first ? last - first : 0;
+  }
+
+  void CurveHistory::appendBucket(const Bucket &bucket,
+                                  QVector<double> *x, QVector<double> *y) {
+    if(bucket.minTime == bucket.maxTime) {
+      x->push_back(bucket.minTime);
+      y->push_back(bucket.min);
+    }
+    else if(bucket.minTime < bucket.maxTime) {
+      x->push_back(bucket.minTime);
+      y->push_back(bucket.min);
+      x->push_back(bucket.maxTime);
+      y->push_back(bucket.max);
+    }
+    else {
+      x->push_back(bucket.maxTime);
+      y->push_back(bucket.max);
+      x->push_back(bucket.minTime);
+      y->push_back(bucket.min);
+    }
+  }
+
+  void CurveHistory::appendRange(size_t level, double start, bool exclusive,
+                                 double end, QVector<double> *x,
+                                 QVector<double> *y) const {
+    if(level == 0) {
+      for(size_t i=findSample(start, exclusive);
+          i<samples.size() && samples[i].time <= end; ++i) {
+        x->push_back(samples[i].time);
+        y->push_back(samples[i].value);
+      }
+      return;
+    }
+
+    const Ring<Bucket> &buckets = levels[level-1].buckets;
+    size_t i = findBucket(level-1, start, false);
+    double last = start;
+    bool found = false;
+    for(; i<buckets.size() && buckets[i].start <= end; ++i) {
+      appendBucket(buckets[i], x, y);
+      last = buckets[i].end;
+      found = true;
+    }
+    // the newest samples are not combined into a bucket of this level yet
+    if(i == buckets.size() && last < end) {
+      appendRange(level-1, last, found || exclusive, end, x, y);
+    }
+  }
+
+  void CurveHistory::getVisible(double start, double end, int resolution,
+                                QVector<double> *x,
+                                QVector<double> *y) const {
+    x->clear();
+    y->clear();
+    if(resolution < 1) resolution = 1;
+    size_t level = 0;
+    for(; level<levels.size(); ++level) {
+      size_t limit = level ? resolution : 2*resolution;
+      if(countRange(level, start, end) <= limit) break;
+    }
+    appendRange(level, start, false, end, x, y);
+  }
+
+  void CurveHistory::getAll(std::vector<double> *x,
+                            std::vector<double> *y) const {
+    x->resize(samples.size());
+    y->resize(samples.size());
+    for(size_t i=0; i<samples.size(); ++i) {
+      (*x)[i] = samples[i].time;
+      (*y)[i] = samples[i].value;
+    }
+  }
+
+} // end of namespace: data_broker_plotter2
@@ -0,0 +1,145 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file CurveHistory.hpp
+ * \brief Bounded sample history of a curve with a min/max decimation
+ *        pyramid.
+ *
+ * The raw samples are kept in a ring buffer. Every level of the pyramid
+ * combines levelFactor buckets of the level below into one bucket that
+ * stores the minimum and maximum value together with their times. A query
+ * returns the finest level that has at most about one bucket per pixel of
+ * the requested range, so the plot only gets a few points per pixel while
+ * peaks are preserved.
+ **/
+
+#ifndef DATA_BROKER_PLOTTER2_CURVE_HISTORY_HPP
+#define DATA_BROKER_PLOTTER2_CURVE_HISTORY_HPP
+
+#include <QVector>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+namespace data_broker_plotter2 {
+
+  class CurveHistory {
+  public:
+    explicit CurveHistory(size_t capacity=100000);
+
+    /**
+     * Changes the number of raw samples kept. The newest ones are kept.
+     * The memory is only allocated while the history is filled.
+     */
+    void setCapacity(size_t capacity);
+    void clear();
+    /** Appends a sample. The times have to be increasing. */
+    void add(double time, double value);
+
+    size_t size() const {return samples.size();}
+
+    /**
+     * Fills \a x and \a y with the samples between \a start and \a end,
+     * decimated to about \a resolution buckets.
+     */
+    void getVisible(double start, double end, int resolution,
+                    QVector<double> *x, QVector<double> *y) const;
+
+    /** Copies all raw samples. */
+    void getAll(std::vector<double> *x, std::vector<double> *y) const;
+
+  private:
+    struct Sample {
+      double time, value;
+    };
+
+    struct Bucket {
+      double start, end;
+      double minTime, min;
+      double maxTime, max;
+    };
+
+    /**
+     * A ring buffer that only allocates its capacity step by step while it
+     * is filled. It does not wrap before it is full, so the storage can be
+     * doubled without moving the elements.
+     */
+    template <typename T>
+    class Ring {
+    public:
+      Ring() : capacity(1), first(0), count(0) {}
+      void reset(size_t capacity_) {
+        capacity = capacity_ ? capacity_ : 1;
+        std::vector<T>().swap(data);
+        first = count = 0;
+      }
+      void clear() {first = count = 0;}
+      void push(const T &value) {
+        if(count < capacity) {
+          // first is 0 until the ring is full
+          if(count == data.size()) {
+            data.resize(std::min(capacity, std::max(2*data.size(),
+                                                    (size_t)64)));
+          }
+          data[count++] = value;
+        }
+        else {
+          data[first] = value;
+          first = (first+1) % capacity;
+        }
+      }
+      size_t size() const {return count;}
+      const T& operator[](size_t i) const {
+        return data[(first+i) % data.size()];
+      }
+
+    private:
+      std::vector<T> data;
+      size_t capacity, first, count;
+    };
+
+    struct Level {
+      Ring<Bucket> buckets;
+      // the bucket that is filled from the level below
+      Bucket pending;
+      int pendingCount;
+    };
+
+    size_t capacity;
+    Ring<Sample> samples;
+    // levels[i] combines the buckets of levels[i-1], levels[0] the samples
+    std::vector<Level> levels;
+
+    void addBucket(size_t level, const Bucket &bucket);
+    size_t countRange(size_t level, double start, double end) const;
+    // first sample with a time after (or at) the given time
+    size_t findSample(double time, bool after) const;
+    // first bucket of levels[level] with an end (or start) after the time
+    size_t findBucket(size_t level, double time, bool byStart) const;
+    void appendRange(size_t level, double start, bool exclusive, double end,
+                     QVector<double> *x, QVector<double> *y) const;
+    static void appendBucket(const Bucket &bucket,
+                             QVector<double> *x, QVector<double> *y);
+  };
+
+} // end of namespace: data_broker_plotter2
+
+#endif // DATA_BROKER_PLOTTER2_CURVE_HISTORY_HPP
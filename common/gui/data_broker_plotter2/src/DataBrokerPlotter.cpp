@@ -7,6 +7,7 @@
 #include<QSplitter>
 #include<QPushButton>
 #include <QFileDialog>
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 
@@ -16,6 +17,24 @@ namespace data_broker_plotter2 {
 
   enum { CALLBACK_OTHER=0, CALLBACK_NEW_STREAM=-1 };
 
+  /**
+   * Sets the range of \a axis like QCPAxis::rescale and returns false if
+   * the range did not change.
+   */
+  static bool setAxisRange(QCPAxis *axis, double lower, double upper) {
+    if(lower == upper) {
+      // keep the current size centered around the single value
+      double size = axis->range().size();
+      lower -= 0.5*size;
+      upper += 0.5*size;
+    }
+    if(axis->range().lower == lower && axis->range().upper == upper) {
+      return false;
+    }
+    axis->setRange(lower, upper);
+    return true;
+  }
+
   DataBrokerPlotter::DataBrokerPlotter(DataBrokerPlotterLib *_mainLib,
                                        lib_manager::LibManager* theManager,
                                        mars::data_broker::DataBrokerInterface *_dataBroker,
@@ -24,7 +43,7 @@ namespace data_broker_plotter2 {
     mars::main_gui::BaseWidget(parent, cfg, _name),
     libManager(theManager), dataBroker(_dataBroker), mainLib(_mainLib),
     name(_name), nextPlotId(1), updateMap(false), needReplot(false), inReceive(false), exit(false),
-    threadRunning(false), simTime(0) {
+    threadRunning(false), clearHistory(false), simTime(0) {
 
       //setStyleSheet("background-color:#eeeeee;");
     configPath = cfg->getOrCreateProperty("Config", "config_path", string(".")).sValue;
@@ -71,6 +90,7 @@ namespace data_broker_plotter2 {
     updateFilterTicks = 0;
 
     map["Properties"]["X-Range in ms"] = 10000UL;
+    map["Properties"]["History Size"] = 100000UL;
     map["Properties"]["Data Update Rate"] = 40.0;
     map["Properties"]["Pen Size"] = 1.0;
     map["Properties"]["Filter"] = "*/Motors/:*root:";
@@ -82,6 +102,8 @@ namespace data_broker_plotter2 {
       }
     }
     xRange = map["Properties"]["X-Range in ms"];
+    historySize = map["Properties"]["History Size"];
+    if(historySize < 1) historySize = 1;
     dataUpdateRate = map["Properties"]["Data Update Rate"];
     penSize = map["Properties"]["Pen Size"];
     filter = mars::utils::explodeString(':', map["Properties"]["Filter"]);
@@ -129,6 +151,7 @@ namespace data_broker_plotter2 {
     while(inReceive || threadRunning) {
       msleep(10);
     }
+    for(auto it: streams) delete it.second;
   }
 
   void DataBrokerPlotter::update() {
@@ -138,15 +161,53 @@ namespace data_broker_plotter2 {
       updateMap = false;
     }
 
-    bool onlyEnlarge = false;
+    // only the visible range at screen resolution is handed to the curves
+    double end = simTime;
+    double start = end - xRange;
+    int resolution = qcPlot->axisRect()->width();
+    bool gotData = false;
     for(auto it: plotMap) {
-      if(it.second->curve) {
-        if(it.second->gotData) {
-          it.second->curve->setData(it.second->xValues, it.second->yValues);
-          it.second->gotData = 0;
+      Plot *plot = it.second;
+      if(plot->curve && plot->gotData) {
+        plot->history.getVisible(start, end, resolution,
+                                 &plot->xVisible, &plot->yVisible);
+        plot->curve->setData(plot->xVisible, plot->yVisible);
+        // the decimated data has only a few points per pixel
+        if(!plot->yVisible.empty()) {
+          plot->yMin = *std::min_element(plot->yVisible.begin(),
+                                         plot->yVisible.end());
+          plot->yMax = *std::max_element(plot->yVisible.begin(),
+                                         plot->yVisible.end());
         }
-        it.second->curve->rescaleAxes(onlyEnlarge);
-        onlyEnlarge = true;
+        plot->gotData = 0;
+        gotData = true;
+      }
+    }
+    // the axes are only adapted if a curve changed
+    if(gotData) {
+      bool haveRange = false;
+      double xLower = 0.0, xUpper = 0.0, yLower = 0.0, yUpper = 0.0;
+      for(auto it: plotMap) {
+        Plot *plot = it.second;
+        if(!plot->curve || plot->xVisible.empty()) continue;
+        if(!haveRange) {
+          xLower = plot->xVisible.front();
+          xUpper = plot->xVisible.back();
+          yLower = plot->yMin;
+          yUpper = plot->yMax;
+          haveRange = true;
+        }
+        else {
+          xLower = std::min(xLower, plot->xVisible.front());
+          xUpper = std::max(xUpper, plot->xVisible.back());
+          yLower = std::min(yLower, plot->yMin);
+          yUpper = std::max(yUpper, plot->yMax);
+        }
+      }
+      if(haveRange) {
+        bool changed = setAxisRange(qcPlot->xAxis, xLower, xUpper);
+        changed |= setAxisRange(qcPlot->yAxis, yLower, yUpper);
+        if(changed) needReplot = true;
       }
     }
     if(needReplot) {
@@ -184,26 +245,104 @@ namespace data_broker_plotter2 {
         double v;
         package.get(0, &v);
         if(v < simTime) {
-          for(auto it: plotMap) {
-            it.second->xValues.clear();
-            it.second->yValues.clear();
+          // the simulation was reset
+          clearHistory = true;
+          for(auto it: streams) {
+            it.second->times.clear();
+            it.second->values.clear();
           }
         }
         simTime = v;
       }
       else {
-        packageList.push_back({label, simTime, info, package});
+        addPackage(label, info, package, simTime);
       }
     }
     dataLock.unlock();
     inReceive = false;
   }
 
+  void DataBrokerPlotter::addPackage(const std::string &label,
+                                     const mars::data_broker::DataInfo &info,
+                                     const mars::data_broker::DataPackage &package,
+                                     double time) {
+    StreamData *&stream = streams[info.dataId];
+    if(!stream) {
+      stream = new StreamData;
+      stream->label = label;
+      stream->info = info;
+      stream->packageSize = 0;
+      stream->layoutChanged = false;
+    }
+    if(stream->itemIndices.empty() || stream->packageSize != package.size()) {
+      stream->itemIndices.clear();
+      stream->itemNames.clear();
+      stream->times.clear();
+      stream->values.clear();
+      for(size_t i=0; i<package.size(); ++i) {
+        if(package[i].type == mars::data_broker::DOUBLE_TYPE ||
+           package[i].type == mars::data_broker::INT_TYPE) {
+          stream->itemIndices.push_back(i);
+          stream->itemNames.push_back(package[i].getName());
+        }
+      }
+      stream->packageSize = package.size();
+      stream->layoutChanged = true;
+    }
+    if(stream->itemIndices.empty()) return;
+
+    double x;
+    int ix;
+    stream->times.push_back(time);
+    for(size_t i=0; i<stream->itemIndices.size(); ++i) {
+      long index = stream->itemIndices[i];
+      if(package[index].type == mars::data_broker::INT_TYPE) {
+        package.get(index, &ix);
+        x = (double)ix;
+      }
+      else {
+        package.get(index, &x);
+      }
+      stream->values.push_back(x);
+    }
+  }
+
+  void DataBrokerPlotter::addSamples(StreamData *stream) {
+    if(stream->plots.size() != stream->readNames.size()) {
+      stream->plots.clear();
+      for(auto name: stream->readNames) {
+        std::string label2 = stream->label + "/" + name;
+        auto it = plotMap.find(label2);
+        if(it == plotMap.end()) {
+          createNewPlot(label2, stream->info);
+          it = plotMap.find(label2);
+        }
+        stream->plots.push_back(it->second);
+      }
+    }
+    size_t numPlots = stream->plots.size();
+    if(!numPlots || stream->readValues.size() != stream->readTimes.size()*numPlots) {
+      return;
+    }
+    for(size_t i=0; i<stream->readTimes.size(); ++i) {
+      for(size_t k=0; k<numPlots; ++k) {
+        stream->plots[k]->history.add(stream->readTimes[i],
+                                      stream->readValues[i*numPlots+k]);
+      }
+    }
+    for(size_t k=0; k<numPlots; ++k) {
+      stream->plots[k]->gotData = true;
+    }
+    needReplot = true;
+  }
+
   void DataBrokerPlotter::createNewPlot(std::string label, const mars::data_broker::DataInfo &info) {
     Plot *newPlot = new Plot;
 
     newPlot->name = label;
+    newPlot->history.setCapacity(historySize);
     newPlot->gotData = 0;
+    newPlot->yMin = newPlot->yMax = 0.0;
     newPlot->curve = NULL;
     newPlot->dataInfo = info;
 
@@ -288,6 +427,16 @@ namespace data_broker_plotter2 {
           }
         }
       }
+      else if(key.find("History") != std::string::npos) {
+        plotLock.lock();
+        historySize = atol(value.c_str());
+        if(historySize < 1) historySize = 1;
+        for(auto it: plotMap) {
+          it.second->history.setCapacity(historySize);
+        }
+        plotLock.unlock();
+        map["Properties"]["History Size"] = historySize;
+      }
       else if(key.find("Data") != std::string::npos) {
         plotLock.lock();
         // todo: change already registerd data
@@ -440,61 +589,47 @@ namespace data_broker_plotter2 {
 
   void DataBrokerPlotter::run() {
     threadRunning = true;
-    double x, xmin;
-    int ix;
+    std::vector<StreamData*> streamList;
 
     while(!exit) {
       // first handle panding dataPackages
       dataLock.lock();
-      std::vector<PackageData> packageList_;
-      packageList.swap(packageList_);
-
       while(!pendingIDs.empty()) {
         std::map<std::string, mars::data_broker::DataInfo>::iterator it = pendingIDs.begin();
         mars::data_broker::DataPackage package = dataBroker->getDataPackage(it->second.dataId);
-        packageList_.push_back({it->first, simTime, it->second, package});
+        if(it->first != "mars_sim/simTime") {
+          addPackage(it->first, it->second, package, simTime);
+        }
         pendingIDs.erase(it);
       }
+      bool clear = clearHistory;
+      clearHistory = false;
+      streamList.clear();
+      for(auto it: streams) {
+        StreamData *stream = it.second;
+        stream->readTimes.swap(stream->times);
+        stream->readValues.swap(stream->values);
+        stream->times.clear();
+        stream->values.clear();
+        if(stream->layoutChanged) {
+          stream->readNames = stream->itemNames;
+          stream->plots.clear();
+          stream->layoutChanged = false;
+        }
+        streamList.push_back(stream);
+      }
       dataLock.unlock();
 
       plotLock.lock();
-
-      for(auto p: packageList_) {
-        mars::data_broker::DataInfo &info = p.di;
-        mars::data_broker::DataPackage &package = p.dp;
-        if(p.label == "mars_sim/simTime") {
-
-        }
-        else {
-          for(size_t i=0; i<package.size(); ++i) {
-            std::string label2 = p.label + "/" + package[i].getName();
-
-            auto it = plotMap.find(label2);
-            if(it == plotMap.end()) {
-              createNewPlot(label2, info);
-              it = plotMap.find(label2);
-            }
-            if(package[i].type == mars::data_broker::DOUBLE_TYPE) {
-              package.get(i, &x);
-            }
-            else if(package[i].type == mars::data_broker::INT_TYPE) {
-              package.get(i, &ix);
-              x = (double)ix;
-            }
-            else {
-              continue;
-            }
-            xmin = simTime-xRange;
-            it->second->xValues.push_back(p.simTime);
-            it->second->yValues.push_back(x);
-            while(!it->second->xValues.empty() && it->second->xValues.front() < xmin) {
-              it->second->xValues.pop_front();
-              it->second->yValues.pop_front();
-            }
-            needReplot = true;
-            it->second->gotData = true;
-          }
+      if(clear) {
+        for(auto it: plotMap) {
+          it.second->history.clear();
+          it.second->gotData = true;
         }
+        needReplot = true;
+      }
+      for(auto stream: streamList) {
+        if(!stream->readTimes.empty()) addSamples(stream);
       }
       plotLock.unlock();
       msleep(10);
@@ -523,8 +658,10 @@ namespace data_broker_plotter2 {
         fprintf(stderr, "Error open File: %s\n", filePath.c_str());
         continue;
       }
-      for(long i=0; i<p.second->xValues.size(); ++i) {
-        fprintf(file, "%g %g\n", p.second->xValues[i], p.second->yValues[i]);
+      std::vector<double> xValues, yValues;
+      p.second->history.getAll(&xValues, &yValues);
+      for(size_t i=0; i<xValues.size(); ++i) {
+        fprintf(file, "%g %g\n", xValues[i], yValues[i]);
       }
       fclose(file);
     }
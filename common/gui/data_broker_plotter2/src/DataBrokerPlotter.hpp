@@ -8,6 +8,7 @@
 #define DATA_BROKER_PLOTTER_HPP
 
 #include "qcustomplot.h"
+#include "CurveHistory.hpp"
 #include <QPainter>
 #include <QCloseEvent>
 #include <QMutex>
@@ -48,19 +49,36 @@ namespace data_broker_plotter2 {
     std::string name;
     QCPGraph *curve;
     mars::data_broker::DataInfo dataInfo;
-    QVector<double> xValues;
-    QVector<double> yValues;
+    CurveHistory history;
+    // the decimated visible part of the history handed to the curve
+    QVector<double> xVisible;
+    QVector<double> yVisible;
+    // bounds of the visible part, updated together with it
+    double yMin, yMax;
     bool gotData, show;
     QMutex mutex;
     configmaps::ConfigMap options;
   };
 
-  class PackageData {
+  /**
+   * The plotted values of a DataBroker stream. receiveData only appends
+   * the numeric values to times/values, the plot thread swaps them into
+   * readTimes/readValues and adds them to the curve histories.
+   */
+  class StreamData {
   public:
     std::string label;
-    double simTime;
-    mars::data_broker::DataInfo di;
-    mars::data_broker::DataPackage dp;
+    mars::data_broker::DataInfo info;
+    size_t packageSize;
+    bool layoutChanged;
+    std::vector<long> itemIndices;
+    std::vector<std::string> itemNames;
+    // one time and itemIndices.size() values per received package
+    std::vector<double> times, values;
+    // only used by the plot thread
+    std::vector<std::string> readNames;
+    std::vector<double> readTimes, readValues;
+    std::vector<Plot*> plots;
   };
 
   class DataBrokerPlotter : public mars::main_gui::BaseWidget,
@@ -103,9 +121,9 @@ namespace data_broker_plotter2 {
     QCustomPlot *qcPlot;
     QMutex dataLock, plotLock;
     std::string name, configPath, exportPath;
-    std::vector<PackageData> packageList;
+    std::map<unsigned long, StreamData*> streams;
     std::vector<std::string> filter;
-    unsigned long xRange;
+    unsigned long xRange, historySize;
     int updateFilterTicks;
 
     std::map<unsigned long, int> registerMap;
@@ -115,11 +133,16 @@ namespace data_broker_plotter2 {
     std::map<mars::cfg_manager::cfgParamId, Plot*> cfgParamIdToPlot;
 
     int nextPlotId;
-    bool updateMap, needReplot, inReceive, exit, threadRunning;
+    bool updateMap, needReplot, inReceive, exit, threadRunning, clearHistory;
     double penSize, dataUpdateRate, simTime;
     std::default_random_engine generator;
 
     void createNewPlot(std::string label, const mars::data_broker::DataInfo &info);
+    void addPackage(const std::string &label,
+                    const mars::data_broker::DataInfo &info,
+                    const mars::data_broker::DataPackage &package,
+                    double time);
+    void addSamples(StreamData *stream);
     void shiftDown( QRect &rect, int offset ) const;
     void showPlot(Plot* plot);
     void hidePlot(Plot* plot);
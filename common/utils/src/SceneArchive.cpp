@@ -0,0 +1,396 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "SceneArchive.h"
+#include "Mutex.h"
+#include "MutexLocker.h"
+#include "misc.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+#include <zlib.h>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mars {
+  namespace utils {
+
+    static const uint32_t localHeaderSignature = 0x04034b50;
+    static const uint32_t centralHeaderSignature = 0x02014b50;
+    static const uint32_t endOfDirectorySignature = 0x06054b50;
+    static const size_t localHeaderSize = 30;
+    static const size_t centralHeaderSize = 46;
+    static const size_t endOfDirectorySize = 22;
+    static const int methodStored = 0;
+    static const int methodDeflated = 8;
+
+    static uint16_t readU16(const char *p) {
+      const unsigned char *u = (const unsigned char*)p;
+      return (uint16_t)(u[0] | (u[1] << 8));
+    }
+
+    static uint32_t readU32(const char *p) {
+      const unsigned char *u = (const unsigned char*)p;
+      return ((uint32_t)u[0] | ((uint32_t)u[1] << 8) |
+              ((uint32_t)u[2] << 16) | ((uint32_t)u[3] << 24));
+    }
+
+    // entry names are relative and use '/' as separator
+    static std::string normalizeName(const std::string &name) {
+      std::string result;
+      result.reserve(name.size());
+      for(size_t i=0; i<name.size(); ++i) {
+        char c = name[i] == '\\' ? '/' : name[i];
+        if(c == '/' && (result.empty() || result[result.size()-1] == '/')) {
+          continue;
+        }
+        result.push_back(c);
+      }
+      while(result.compare(0, 2, "./") == 0) result.erase(0, 2);
+      return result;
+    }
+
+    SceneArchive::SceneArchive() : data(NULL), dataSize(0), mapped(false) {
+    }
+
+    SceneArchive::~SceneArchive() {
+      close();
+    }
+
+    bool SceneArchive::open(const std::string &filename_) {
+      close();
+      filename = filename_;
+#ifdef WIN32
+      std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+      if(!file.is_open()) {
+        fprintf(stderr, "SceneArchive: could not open %s\n", filename.c_str());
+        return false;
+      }
+      file.seekg(0, std::ios::end);
+      dataSize = (size_t)file.tellg();
+      file.seekg(0, std::ios::beg);
+      char *buffer = (char*)malloc(dataSize ? dataSize : 1);
+      file.read(buffer, dataSize);
+      data = buffer;
+      mapped = false;
+#else
+      int fd = ::open(filename.c_str(), O_RDONLY);
+      if(fd < 0) {
+        fprintf(stderr, "SceneArchive: could not open %s\n", filename.c_str());
+        return false;
+      }
+      struct stat st;
+      if(fstat(fd, &st) != 0 || st.st_size == 0) {
+        fprintf(stderr, "SceneArchive: could not read %s\n", filename.c_str());
+        ::close(fd);
+        return false;
+      }
+      void *p = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      ::close(fd);
+      if(p == MAP_FAILED) {
+        fprintf(stderr, "SceneArchive: could not map %s\n", filename.c_str());
+        return false;
+      }
+      data = (const char*)p;
+      dataSize = st.st_size;
+      mapped = true;
+#endif
+      if(!readDirectory()) {
+        fprintf(stderr, "SceneArchive: %s is no valid zip archive\n",
+                filename.c_str());
+        close();
+        return false;
+      }
+      return true;
+    }
+
+    void SceneArchive::close() {
+      if(data) {
+#ifdef WIN32
+        free((void*)data);
+#else
+        if(mapped) munmap((void*)data, dataSize);
+#endif
+      }
+      data = NULL;
+      dataSize = 0;
+      mapped = false;
+      entries.clear();
+    }
+
+    bool SceneArchive::readDirectory() {
+      if(dataSize < endOfDirectorySize) return false;
+
+      // the end of central directory record is followed by a comment of
+      // at most 64k
+      size_t end = dataSize - endOfDirectorySize;
+      size_t first = end > 0xffff ? end - 0xffff : 0;
+      size_t pos = end + 1;
+      for(size_t i=end+1; i>first; --i) {
+        if(readU32(data+i-1) == endOfDirectorySignature) {
+          pos = i-1;
+          break;
+        }
+      }
+      if(pos > end) return false;
+
+      size_t count = readU16(data+pos+10);
+      size_t directorySize = readU32(data+pos+12);
+      size_t offset = readU32(data+pos+16);
+      if(count == 0xffff || offset == 0xffffffff) {
+        fprintf(stderr, "SceneArchive: zip64 archives are not supported\n");
+        return false;
+      }
+      if(offset + directorySize > pos) return false;
+
+      for(size_t i=0; i<count; ++i) {
+        if(offset + centralHeaderSize > pos ||
+           readU32(data+offset) != centralHeaderSignature) {
+          return false;
+        }
+        const char *header = data+offset;
+        if(offset + centralHeaderSize + readU16(header+28) > pos) return false;
+        int flags = readU16(header+8);
+        int method = readU16(header+10);
+        size_t compressedSize = readU32(header+20);
+        size_t size = readU32(header+24);
+        size_t nameLength = readU16(header+28);
+        size_t extraLength = readU16(header+30);
+        size_t commentLength = readU16(header+32);
+        size_t localOffset = readU32(header+42);
+        std::string name(header+centralHeaderSize, nameLength);
+        offset += centralHeaderSize + nameLength + extraLength + commentLength;
+
+        // directories have no content
+        if(name.empty() || name[name.size()-1] == '/') continue;
+        if(flags & 1) {
+          fprintf(stderr, "SceneArchive: skip encrypted entry %s\n",
+                  name.c_str());
+          continue;
+        }
+        if(method != methodStored && method != methodDeflated) {
+          fprintf(stderr, "SceneArchive: skip entry %s with unsupported "
+                  "compression %d\n", name.c_str(), method);
+          continue;
+        }
+        if(localOffset + localHeaderSize > dataSize ||
+           readU32(data+localOffset) != localHeaderSignature) {
+          return false;
+        }
+        Entry entry;
+        entry.offset = (localOffset + localHeaderSize +
+                        readU16(data+localOffset+26) +
+                        readU16(data+localOffset+28));
+        entry.compressedSize = compressedSize;
+        entry.size = size;
+        entry.method = method;
+        if(entry.offset + compressedSize > dataSize) return false;
+        entries[normalizeName(name)] = entry;
+      }
+      return true;
+    }
+
+    bool SceneArchive::hasFile(const std::string &name) const {
+      return entries.find(normalizeName(name)) != entries.end();
+    }
+
+    std::vector<std::string> SceneArchive::getFileNames() const {
+      std::vector<std::string> names;
+      std::map<std::string, Entry>::const_iterator it;
+      for(it=entries.begin(); it!=entries.end(); ++it) {
+        names.push_back(it->first);
+      }
+      return names;
+    }
+
+    bool SceneArchive::getFile(const std::string &name, const char **data_,
+                               size_t *size, std::vector<char> *buffer) const {
+      std::map<std::string, Entry>::const_iterator it;
+      it = entries.find(normalizeName(name));
+      if(it == entries.end()) return false;
+      const Entry &entry = it->second;
+
+      if(entry.method == methodStored) {
+        *data_ = data + entry.offset;
+        *size = entry.size;
+        return true;
+      }
+
+      buffer->resize(entry.size ? entry.size : 1);
+      z_stream stream;
+      memset(&stream, 0, sizeof(stream));
+      // negative window bits: raw deflate data without zlib header
+      if(inflateInit2(&stream, -MAX_WBITS) != Z_OK) return false;
+      stream.next_in = (Bytef*)(data + entry.offset);
+      stream.avail_in = (uInt)entry.compressedSize;
+      stream.next_out = (Bytef*)buffer->data();
+      stream.avail_out = (uInt)entry.size;
+      int result = inflate(&stream, Z_FINISH);
+      size_t written = stream.total_out;
+      inflateEnd(&stream);
+      if(result != Z_STREAM_END || written != entry.size) {
+        fprintf(stderr, "SceneArchive: could not decompress %s from %s\n",
+                name.c_str(), filename.c_str());
+        return false;
+      }
+      *data_ = buffer->data();
+      *size = entry.size;
+      return true;
+    }
+
+    bool SceneArchive::readFile(const std::string &name,
+                                std::string *content) const {
+      const char *p;
+      size_t size;
+      std::vector<char> buffer;
+      if(!getFile(name, &p, &size, &buffer)) return false;
+      content->assign(p, size);
+      return true;
+    }
+
+    bool SceneArchive::extractAll(const std::string &directory) const {
+      std::string dir = directory;
+      if(!dir.empty() && dir[dir.size()-1] != '/') dir += "/";
+      if(!createDirectory(dir)) return false;
+
+      std::vector<char> buffer;
+      std::map<std::string, Entry>::const_iterator it;
+      for(it=entries.begin(); it!=entries.end(); ++it) {
+        const char *p;
+        size_t size;
+        if(!getFile(it->first, &p, &size, &buffer)) return false;
+        std::string file = dir + it->first;
+        std::string path = getPathOfFile(file);
+        if(!createDirectory(path)) return false;
+        FILE *out = fopen(file.c_str(), "wb");
+        if(!out) {
+          fprintf(stderr, "SceneArchive: could not write %s\n", file.c_str());
+          return false;
+        }
+        bool ok = (fwrite(p, 1, size, out) == size);
+        fclose(out);
+        if(!ok) return false;
+      }
+      return true;
+    }
+
+    /// \cond HIDDEN_SYMBOLS
+    struct MountPoint {
+      std::string directory;
+      std::shared_ptr<SceneArchive> archive;
+    };
+    /// \endcond
+
+    // later mounts hide the files of earlier ones like extracting
+    // into the same directory would
+    static std::vector<MountPoint> mountPoints;
+    static Mutex mountMutex;
+
+    static std::string mountDirectory(const std::string &directory) {
+      std::string dir = directory;
+      if(!dir.empty() && dir[dir.size()-1] != '/') dir += "/";
+      return dir;
+    }
+
+    bool SceneArchive::mount(const std::string &archiveFile,
+                             const std::string &directory) {
+      std::shared_ptr<SceneArchive> archive(new SceneArchive);
+      if(!archive->open(archiveFile)) return false;
+      std::string dir = mountDirectory(directory);
+
+      MutexLocker locker(&mountMutex);
+      for(size_t i=0; i<mountPoints.size(); ) {
+        if(mountPoints[i].directory == dir &&
+           mountPoints[i].archive->getFilename() == archiveFile) {
+          mountPoints.erase(mountPoints.begin()+i);
+        }
+        else ++i;
+      }
+      MountPoint mountPoint = {dir, archive};
+      mountPoints.push_back(mountPoint);
+      return true;
+    }
+
+    void SceneArchive::unmountAll() {
+      MutexLocker locker(&mountMutex);
+      mountPoints.clear();
+    }
+
+    bool SceneArchive::getMountedFile(const std::string &filename,
+                                      const char **data, size_t *size,
+                                      std::vector<char> *buffer) {
+      MutexLocker locker(&mountMutex);
+      for(size_t i=mountPoints.size(); i>0; --i) {
+        const MountPoint &mountPoint = mountPoints[i-1];
+        if(filename.compare(0, mountPoint.directory.size(),
+                            mountPoint.directory) != 0) {
+          continue;
+        }
+        std::string name = filename.substr(mountPoint.directory.size());
+        if(mountPoint.archive->getFile(name, data, size, buffer)) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    bool SceneArchive::isMountedFile(const std::string &filename) {
+      MutexLocker locker(&mountMutex);
+      for(size_t i=mountPoints.size(); i>0; --i) {
+        const MountPoint &mountPoint = mountPoints[i-1];
+        if(filename.compare(0, mountPoint.directory.size(),
+                            mountPoint.directory) == 0 &&
+           mountPoint.archive->hasFile(filename.substr(mountPoint.directory.size()))) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    bool SceneArchive::readMountedFile(const std::string &filename,
+                                       std::string *content) {
+      const char *data;
+      size_t size;
+      std::vector<char> buffer;
+      if(getMountedFile(filename, &data, &size, &buffer)) {
+        content->assign(data, size);
+        return true;
+      }
+      std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+      if(!file.is_open()) return false;
+      std::stringstream stream;
+      stream << file.rdbuf();
+      *content = stream.str();
+      return true;
+    }
+
+  } // end of namespace utils
+} // end of namespace mars
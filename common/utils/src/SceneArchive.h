@@ -0,0 +1,128 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file SceneArchive.h
+ * \brief Read only access to the entries of a zip archive without
+ *        extracting it.
+ *
+ * The archive is mapped into memory and its central directory is indexed
+ * once. Stored entries are served directly from the mapping, deflated
+ * entries are decompressed on demand into a buffer of the caller.
+ *
+ * An archive can be mounted at a virtual directory. The files below that
+ * directory are then resolved by getMountedFile, so the loaders can use
+ * the same file names as for an extracted archive.
+ */
+
+#ifndef MARS_UTILS_SCENEARCHIVE_H
+#define MARS_UTILS_SCENEARCHIVE_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace mars {
+  namespace utils {
+
+    class SceneArchive {
+    public:
+      SceneArchive();
+      ~SceneArchive();
+
+      /** \brief Maps the archive and reads its central directory. */
+      bool open(const std::string &filename);
+      void close();
+      bool isOpen() const {return data != NULL;}
+
+      const std::string& getFilename() const {return filename;}
+      bool hasFile(const std::string &name) const;
+      std::vector<std::string> getFileNames() const;
+
+      /**
+       * \brief Gets the content of an entry.
+       *
+       * For stored entries \a data points into the mapped archive and stays
+       * valid until the archive is closed. Deflated entries are decompressed
+       * into \a buffer and \a data points to its content.
+       */
+      bool getFile(const std::string &name, const char **data, size_t *size,
+                   std::vector<char> *buffer) const;
+      bool readFile(const std::string &name, std::string *content) const;
+
+      /** \brief Writes all entries below \a directory. */
+      bool extractAll(const std::string &directory) const;
+
+      /**
+       * \brief Opens \a archiveFile and mounts it at \a directory.
+       *
+       * Like extracting into the same directory, archives mounted later
+       * hide the files of earlier ones. Mounting an archive again replaces
+       * its previous mount.
+       */
+      static bool mount(const std::string &archiveFile,
+                        const std::string &directory);
+      /**
+       * \brief Closes all mounted archives. Called when the scene is
+       *        cleared; until then the archives are kept for reloading.
+       */
+      static void unmountAll();
+      /**
+       * \brief Resolves \a filename in the mounted archives. Like getFile,
+       *        but the data of stored entries is only valid as long as
+       *        their archive stays mounted.
+       */
+      static bool getMountedFile(const std::string &filename,
+                                 const char **data, size_t *size,
+                                 std::vector<char> *buffer);
+      static bool isMountedFile(const std::string &filename);
+      /**
+       * \brief Reads \a filename from a mounted archive or, if it is not
+       *        part of one, from the file system.
+       */
+      static bool readMountedFile(const std::string &filename,
+                                  std::string *content);
+
+    private:
+      struct Entry {
+        size_t offset;
+        size_t compressedSize;
+        size_t size;
+        int method;
+      };
+
+      std::string filename;
+      const char *data;
+      size_t dataSize;
+      bool mapped;
+      std::map<std::string, Entry> entries;
+
+      bool readDirectory();
+
+      // disallow copying
+      SceneArchive(const SceneArchive &);
+      SceneArchive &operator=(const SceneArchive &);
+    }; // end of class SceneArchive
+
+  } // end of namespace utils
+} // end of namespace mars
+
+#endif /* MARS_UTILS_SCENEARCHIVE_H */
@@ -0,0 +1,124 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ArchiveReadFileCallback.h"
+
+#include <mars/utils/SceneArchive.h>
+#include <osgDB/FileNameUtils>
+
+#include <istream>
+#include <streambuf>
+#include <vector>
+
+namespace mars {
+  namespace graphics {
+
+    using osgDB::ReaderWriter;
+
+    // reads from memory without copying it into a string stream
+    class MemoryBuffer : public std::streambuf {
+    public:
+      MemoryBuffer(const char *data, size_t size) {
+        char *p = const_cast<char*>(data);
+        setg(p, p, p+size);
+      }
+
+    protected:
+      virtual pos_type seekoff(off_type offset, std::ios_base::seekdir dir,
+                               std::ios_base::openmode mode) {
+        char *p = gptr();
+        if(dir == std::ios_base::beg) p = eback() + offset;
+        else if(dir == std::ios_base::cur) p += offset;
+        else p = egptr() + offset;
+        if(p < eback() || p > egptr()) return pos_type(off_type(-1));
+        setg(eback(), p, egptr());
+        return pos_type(p - eback());
+      }
+
+      virtual pos_type seekpos(pos_type pos, std::ios_base::openmode mode) {
+        return seekoff(off_type(pos), std::ios_base::beg, mode);
+      }
+    };
+
+    // the reader needs the directory of the file to resolve relative paths
+    static osg::ref_ptr<osgDB::Options> getOptions(const std::string &filename,
+                                                   const osgDB::Options *options) {
+      osg::ref_ptr<osgDB::Options> result;
+      if(options) {
+        result = static_cast<osgDB::Options*>(options->clone(osg::CopyOp::SHALLOW_COPY));
+      }
+      else {
+        result = new osgDB::Options;
+      }
+      result->getDatabasePathList().push_front(osgDB::getFilePath(filename));
+      return result;
+    }
+
+    ArchiveReadFileCallback::ArchiveReadFileCallback(osgDB::Registry::ReadFileCallback *next)
+      : next(next) {
+    }
+
+    ReaderWriter::ReadResult ArchiveReadFileCallback::readNode(const std::string &filename,
+                                                               const osgDB::Options *options) {
+      const char *data;
+      size_t size;
+      std::vector<char> buffer;
+      if(utils::SceneArchive::getMountedFile(filename, &data, &size, &buffer)) {
+        std::string ext = osgDB::getLowerCaseFileExtension(filename);
+        ReaderWriter *rw = osgDB::Registry::instance()->getReaderWriterForExtension(ext);
+        if(rw) {
+          MemoryBuffer memoryBuffer(data, size);
+          std::istream stream(&memoryBuffer);
+          return rw->readNode(stream, getOptions(filename, options).get());
+        }
+      }
+      if(next.valid()) return next->readNode(filename, options);
+      return osgDB::Registry::instance()->readNodeImplementation(filename, options);
+    }
+
+    ReaderWriter::ReadResult ArchiveReadFileCallback::readImage(const std::string &filename,
+                                                                const osgDB::Options *options) {
+      const char *data;
+      size_t size;
+      std::vector<char> buffer;
+      if(utils::SceneArchive::getMountedFile(filename, &data, &size, &buffer)) {
+        std::string ext = osgDB::getLowerCaseFileExtension(filename);
+        ReaderWriter *rw = osgDB::Registry::instance()->getReaderWriterForExtension(ext);
+        if(rw) {
+          MemoryBuffer memoryBuffer(data, size);
+          std::istream stream(&memoryBuffer);
+          ReaderWriter::ReadResult result = rw->readImage(stream, getOptions(filename, options).get());
+          if(result.validImage()) result.getImage()->setFileName(filename);
+          return result;
+        }
+      }
+      if(next.valid()) return next->readImage(filename, options);
+      return osgDB::Registry::instance()->readImageImplementation(filename, options);
+    }
+
+    void ArchiveReadFileCallback::install() {
+      osgDB::Registry *registry = osgDB::Registry::instance();
+      osgDB::Registry::ReadFileCallback *current = registry->getReadFileCallback();
+      if(dynamic_cast<ArchiveReadFileCallback*>(current)) return;
+      registry->setReadFileCallback(new ArchiveReadFileCallback(current));
+    }
+
+  } // end of namespace graphics
+} // end of namespace mars
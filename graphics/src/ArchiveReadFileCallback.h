@@ -0,0 +1,56 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MARS_GRAPHICS_ARCHIVEREADFILECALLBACK_H
+#define MARS_GRAPHICS_ARCHIVEREADFILECALLBACK_H
+
+#include <osgDB/Registry>
+
+namespace mars {
+  namespace graphics {
+
+    /**
+     * Serves the meshes and images of mounted scene archives
+     * (see utils::SceneArchive) from memory to all osgDB read calls.
+     * Other files are passed to the previously installed callback.
+     */
+    class ArchiveReadFileCallback : public osgDB::Registry::ReadFileCallback {
+    public:
+      explicit ArchiveReadFileCallback(osgDB::Registry::ReadFileCallback *next);
+
+      virtual osgDB::ReaderWriter::ReadResult readNode(const std::string &filename,
+                                                       const osgDB::Options *options);
+      virtual osgDB::ReaderWriter::ReadResult readImage(const std::string &filename,
+                                                        const osgDB::Options *options);
+
+      /** \brief Installs the callback once for the osgDB registry. */
+      static void install();
+
+    protected:
+      virtual ~ArchiveReadFileCallback() {}
+
+    private:
+      osg::ref_ptr<osgDB::Registry::ReadFileCallback> next;
+    };
+
+  } // end of namespace graphics
+} // end of namespace mars
+
+#endif /* MARS_GRAPHICS_ARCHIVEREADFILECALLBACK_H */
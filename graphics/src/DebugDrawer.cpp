@@ -0,0 +1,216 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DebugDrawer.h"
+
+#include <mars/utils/MutexLocker.h>
+
+namespace mars {
+  namespace graphics {
+
+    using namespace interfaces;
+    using namespace utils;
+
+    static osg::Geometry* createGeometry(osg::Vec3Array *vertices,
+                                         osg::Vec4Array *colors,
+                                         osg::DrawArrays *draw) {
+      osg::Geometry *geometry = new osg::Geometry();
+      vertices->setDataVariance(osg::Object::DYNAMIC);
+      colors->setDataVariance(osg::Object::DYNAMIC);
+      geometry->setDataVariance(osg::Object::DYNAMIC);
+      // the arrays are refilled with a varying size, vertex buffer objects
+      // avoid recompiling a display list every time
+      geometry->setUseDisplayList(false);
+      geometry->setUseVertexBufferObjects(true);
+      geometry->setVertexArray(vertices);
+      geometry->setColorArray(colors);
+      geometry->setColorBinding(osg::Geometry::BIND_PER_VERTEX);
+      geometry->addPrimitiveSet(draw);
+      return geometry;
+    }
+
+    DebugDrawer::DebugDrawer(osg::Group *parent, const std::string &fontPath)
+      : parent(parent), font(fontPath + "/arial.ttf"), changed(false) {
+    }
+
+    DebugDrawer::~DebugDrawer() {
+      std::map<std::string, Channel*>::iterator it;
+      for(it=channels.begin(); it!=channels.end(); ++it) {
+        parent->removeChild(it->second->geode.get());
+        delete it->second;
+      }
+    }
+
+    void DebugDrawer::swap(const std::string &channel,
+                           DebugDrawBuffer *buffer) {
+      MutexLocker locker(&mutex);
+      Channel *&c = channels[channel];
+      if(!c) c = createChannel();
+      // the caller keeps its style and gets the old geometry to refill
+      c->buffer.swapGeometry(*buffer);
+      c->buffer.lineWidth = buffer->lineWidth;
+      c->buffer.pointSize = buffer->pointSize;
+      c->buffer.labelSize = buffer->labelSize;
+      c->changed = true;
+      c->removed = false;
+      changed = true;
+    }
+
+    void DebugDrawer::remove(const std::string &channel) {
+      MutexLocker locker(&mutex);
+      std::map<std::string, Channel*>::iterator it = channels.find(channel);
+      if(it == channels.end()) return;
+      it->second->removed = true;
+      changed = true;
+    }
+
+    void DebugDrawer::clear() {
+      MutexLocker locker(&mutex);
+      std::map<std::string, Channel*>::iterator it;
+      for(it=channels.begin(); it!=channels.end(); ++it) {
+        it->second->removed = true;
+      }
+      changed = true;
+    }
+
+    void DebugDrawer::update() {
+      MutexLocker locker(&mutex);
+      if(!changed) return;
+      changed = false;
+
+      std::map<std::string, Channel*>::iterator it = channels.begin();
+      while(it!=channels.end()) {
+        Channel *c = it->second;
+        if(c->removed) {
+          parent->removeChild(c->geode.get());
+          delete c;
+          channels.erase(it++);
+          continue;
+        }
+        if(c->changed) {
+          upload(c);
+          c->changed = false;
+        }
+        ++it;
+      }
+    }
+
+    DebugDrawer::Channel* DebugDrawer::createChannel() {
+      Channel *c = new Channel;
+      c->changed = c->removed = false;
+      c->geode = new osg::Geode();
+      c->lineVertices = new osg::Vec3Array();
+      c->lineColors = new osg::Vec4Array();
+      c->lineDraw = new osg::DrawArrays(osg::PrimitiveSet::LINES, 0, 0);
+      c->lines = createGeometry(c->lineVertices.get(), c->lineColors.get(),
+                                c->lineDraw.get());
+      c->pointVertices = new osg::Vec3Array();
+      c->pointColors = new osg::Vec4Array();
+      c->pointDraw = new osg::DrawArrays(osg::PrimitiveSet::POINTS, 0, 0);
+      c->points = createGeometry(c->pointVertices.get(), c->pointColors.get(),
+                                 c->pointDraw.get());
+      c->geode->addDrawable(c->lines.get());
+      c->geode->addDrawable(c->points.get());
+
+      c->lineWidth = new osg::LineWidth(1.0);
+      c->lines->getOrCreateStateSet()->setAttributeAndModes(c->lineWidth.get(),
+                                                            osg::StateAttribute::ON);
+      c->point = new osg::Point(5.0);
+      c->points->getOrCreateStateSet()->setAttribute(c->point.get());
+
+      osg::StateSet *states = c->geode->getOrCreateStateSet();
+      states->setMode(GL_LIGHTING,
+                      osg::StateAttribute::OFF | osg::StateAttribute::PROTECTED);
+      states->setMode(GL_FOG, osg::StateAttribute::OFF);
+      c->geode->setNodeMask(1);
+      parent->addChild(c->geode.get());
+      return c;
+    }
+
+    osg::ref_ptr<osgText::Text> DebugDrawer::createLabel() {
+      osg::ref_ptr<osgText::Text> text = new osgText::Text;
+      text->setDataVariance(osg::Object::DYNAMIC);
+      text->setFont(font);
+      text->setAxisAlignment(osgText::Text::SCREEN);
+      text->setAlignment(osgText::Text::CENTER_CENTER);
+      return text;
+    }
+
+    void DebugDrawer::upload(Channel *c) {
+      const DebugDrawBuffer &b = c->buffer;
+
+      size_t numLines = b.lineColors.size();
+      c->lineVertices->resize(numLines*2);
+      c->lineColors->resize(numLines*2);
+      for(size_t i=0; i<numLines; ++i) {
+        const Vector &start = b.lineVertices[i*2];
+        const Vector &end = b.lineVertices[i*2+1];
+        const Color &color = b.lineColors[i];
+        osg::Vec4 col(color.r, color.g, color.b, color.a);
+        (*c->lineVertices)[i*2].set(start.x(), start.y(), start.z());
+        (*c->lineVertices)[i*2+1].set(end.x(), end.y(), end.z());
+        (*c->lineColors)[i*2] = col;
+        (*c->lineColors)[i*2+1] = col;
+      }
+      c->lineDraw->setCount(numLines*2);
+      c->lineVertices->dirty();
+      c->lineColors->dirty();
+      c->lines->dirtyBound();
+      c->lineWidth->setWidth(b.lineWidth);
+
+      size_t numPoints = b.points.size();
+      c->pointVertices->resize(numPoints);
+      c->pointColors->resize(numPoints);
+      for(size_t i=0; i<numPoints; ++i) {
+        const Vector &pos = b.points[i];
+        const Color &color = b.pointColors[i];
+        (*c->pointVertices)[i].set(pos.x(), pos.y(), pos.z());
+        (*c->pointColors)[i].set(color.r, color.g, color.b, color.a);
+      }
+      c->pointDraw->setCount(numPoints);
+      c->pointVertices->dirty();
+      c->pointColors->dirty();
+      c->points->dirtyBound();
+      c->point->setSize(b.pointSize);
+
+      // the first two drawables of the geode are the lines and points
+      size_t numLabels = b.labels.size();
+      if(numLabels < c->labels.size()) {
+        c->geode->removeDrawables(2+numLabels, c->labels.size()-numLabels);
+        c->labels.resize(numLabels);
+      }
+      while(c->labels.size() < numLabels) {
+        c->labels.push_back(createLabel());
+        c->geode->addDrawable(c->labels.back().get());
+      }
+      for(size_t i=0; i<numLabels; ++i) {
+        const DebugDrawBuffer::Label &label = b.labels[i];
+        osgText::Text *text = c->labels[i].get();
+        text->setPosition(osg::Vec3(label.pos.x(), label.pos.y(),
+                                    label.pos.z()));
+        text->setCharacterSize(b.labelSize);
+        text->setColor(osg::Vec4(label.color.r, label.color.g,
+                                 label.color.b, label.color.a));
+        text->setText(label.text);
+      }
+    }
+
+  } // end of namespace graphics
+} // end of namespace mars
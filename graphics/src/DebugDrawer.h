@@ -0,0 +1,91 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MARS_GRAPHICS_DEBUGDRAWER_H
+#define MARS_GRAPHICS_DEBUGDRAWER_H
+
+#include <mars/interfaces/graphics/draw_structs.h>
+#include <mars/utils/Mutex.h>
+
+#include <osg/Group>
+#include <osg/Geode>
+#include <osg/Geometry>
+#include <osg/LineWidth>
+#include <osg/Point>
+#include <osgText/Text>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace mars {
+  namespace graphics {
+
+    /**
+     * Draws the interfaces::DebugDrawBuffer channels of the producers.
+     *
+     * Every channel is one geode with one line and one point geometry whose
+     * vertex arrays are refilled when the channel changed. The labels use a
+     * pool of text drawables that is only resized if the number of labels
+     * changes. swap() and remove() can be called from any thread, update()
+     * has to be called from the graphics thread.
+     */
+    class DebugDrawer {
+    public:
+      DebugDrawer(osg::Group *parent, const std::string &fontPath);
+      ~DebugDrawer();
+
+      void swap(const std::string &channel,
+                interfaces::DebugDrawBuffer *buffer);
+      void remove(const std::string &channel);
+      void clear();
+
+      /** \brief Uploads the geometry of the changed channels. */
+      void update();
+
+    private:
+      struct Channel {
+        interfaces::DebugDrawBuffer buffer;
+        bool changed, removed;
+        osg::ref_ptr<osg::Geode> geode;
+        osg::ref_ptr<osg::Geometry> lines, points;
+        osg::ref_ptr<osg::Vec3Array> lineVertices, pointVertices;
+        osg::ref_ptr<osg::Vec4Array> lineColors, pointColors;
+        osg::ref_ptr<osg::DrawArrays> lineDraw, pointDraw;
+        osg::ref_ptr<osg::LineWidth> lineWidth;
+        osg::ref_ptr<osg::Point> point;
+        std::vector<osg::ref_ptr<osgText::Text> > labels;
+      };
+
+      osg::ref_ptr<osg::Group> parent;
+      std::string font;
+      utils::Mutex mutex;
+      std::map<std::string, Channel*> channels;
+      bool changed;
+
+      Channel* createChannel();
+      void upload(Channel *channel);
+      osg::ref_ptr<osgText::Text> createLabel();
+    };
+
+  } // end of namespace graphics
+} // end of namespace mars
+
+#endif /* MARS_GRAPHICS_DEBUGDRAWER_H */
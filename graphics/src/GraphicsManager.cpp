@@ -26,6 +26,7 @@
  */
 
 #include "GraphicsManager.h"
+#include "ArchiveReadFileCallback.h"
 #include "config.h"
 #include <mars/utils/misc.h>
 #include <mars/interfaces/sim/ControlCenter.h>
@@ -113,11 +114,14 @@ namespace mars {
         set_window_prop(0),
         initialized(false),
         activeWindow(NULL),
-        materialManager(NULL) {
+        materialManager(NULL),
+        debugDrawer(NULL) {
       //osg::setNotifyLevel( osg::WARN );
 
       // first check if we have the cfg_manager lib
       framesFactory = new osg_frames::FramesFactory();
+      // meshes and textures of scene archives are not extracted
+      ArchiveReadFileCallback::install();
     }
 
     GraphicsManager::~GraphicsManager() {
@@ -130,6 +134,7 @@ namespace mars {
       if(materialManager) libManager->releaseLibrary("osg_material_manager");
       //fprintf(stderr, "Delete mars_graphics\n");
       delete framesFactory;
+      delete debugDrawer;
     }
 
     void GraphicsManager::initializeOSG(void *data, bool createWindow) {
@@ -279,6 +284,8 @@ namespace mars {
         scene->setStateSet(globalStateset.get());
         scene->addChild(lightGroup.get());
         scene->addChild(shadowedScene.get());
+        debugDrawer = new DebugDrawer(scene.get(),
+                                      resources_path.sValue + "/Fonts");
 
         // init light (osg can have only 8 lights enabled at a time)
         for (unsigned int i =0; i<8;i++) {
@@ -435,6 +442,7 @@ namespace mars {
         removeDrawObject(iter->first);
       }
       clearDrawItems();
+      if(debugDrawer) debugDrawer->clear();
     }
 
     void GraphicsManager::addGraphicsUpdateInterface(GraphicsUpdateInterface *g) {
@@ -535,6 +543,7 @@ namespace mars {
         draws[i].nodes.clear();
         draws[i].nodes = tmp_nodes;
       }
+      if(debugDrawer) debugDrawer->update();
     }
 
     const mars::interfaces::GraphicData GraphicsManager::getGraphicOptions(void) const {
@@ -1050,6 +1059,17 @@ namespace mars {
       OSGNodeStruct *ns = findDrawObject(id);
       if(ns != NULL) ns->object()->setQuaternion(q);
     }
+    void GraphicsManager::setDrawObjectPoses(size_t count, const unsigned long *ids,
+                                             const Vector *pos,
+                                             const Quaternion *q) {
+      for(size_t i=0; i<count; ++i) {
+        OSGNodeStruct *ns = findDrawObject(ids[i]);
+        if(ns == NULL) continue;
+        DrawObject *drawObject = ns->object();
+        drawObject->setPosition(pos[i]);
+        drawObject->setQuaternion(q[i]);
+      }
+    }
     void GraphicsManager::setDrawObjectScale(unsigned long id, const Vector &ext) {
       OSGNodeStruct *ns = findDrawObject(id);
       if(ns != NULL) ns->object()->setScaledSize(ext);
@@ -1160,6 +1180,15 @@ namespace mars {
       }
     }
 
+    void GraphicsManager::swapDebugDraw(const std::string &channel,
+                                        DebugDrawBuffer *buffer) {
+      if(debugDrawer) debugDrawer->swap(channel, buffer);
+    }
+
+    void GraphicsManager::removeDebugDraw(const std::string &channel) {
+      if(debugDrawer) debugDrawer->remove(channel);
+    }
+
     void GraphicsManager::clearDrawItems(void) {
       //clear the list of draw items
       for(vector<drawMapper>::iterator it = draws.begin();
@@ -70,6 +70,7 @@
 #include <osg_frames/FramesFactory.hpp>
 
 #include "gui_helper_functions.h"
+#include "DebugDrawer.h"
 
 namespace mars {
   namespace graphics {
@@ -127,6 +128,9 @@ namespace mars {
       virtual void addDrawItems(interfaces::drawStruct *draw); ///< Adds drawStruct items to the graphics scene.
       virtual void removeDrawItems(interfaces::DrawInterface *iface);
       virtual void clearDrawItems(void);
+      virtual void swapDebugDraw(const std::string &channel,
+                                 interfaces::DebugDrawBuffer *buffer);
+      virtual void removeDebugDraw(const std::string &channel);
 
       virtual void addLight(mars::interfaces::LightData &ls); ///< adds a light to the scene
       virtual void removeLight(unsigned int index); ///< removes a light from the scene
@@ -143,6 +147,9 @@ namespace mars {
       virtual void removeDrawObject(unsigned long id);
       virtual void setDrawObjectPos(unsigned long id, const mars::utils::Vector &pos);
       virtual void setDrawObjectRot(unsigned long id, const mars::utils::Quaternion &q);
+      virtual void setDrawObjectPoses(size_t count, const unsigned long *ids,
+                                      const mars::utils::Vector *pos,
+                                      const mars::utils::Quaternion *q);
       virtual void setDrawObjectScale(unsigned long id, const mars::utils::Vector &ext);
       virtual void setDrawObjectMaterial(unsigned long id,
                                          const mars::interfaces::MaterialData &material);
@@ -415,6 +422,7 @@ namespace mars {
       bool initialized;
       GraphicsWidget *activeWindow;
       osg_material_manager::OsgMaterialManager *materialManager;
+      DebugDrawer *debugDrawer;
       void setupCFG(void);
 
       unsigned long findCoreObject(unsigned long draw_id) const;
@@ -37,6 +37,7 @@
 #include <opencv2/opencv.hpp>
 
 #include <mars/utils/mathUtils.h>
+#include <mars/utils/SceneArchive.h>
 
 namespace mars {
   namespace graphics {
@@ -398,7 +399,18 @@ namespace mars {
         nodeFileStruct newNodeFile;
         newNodeFile.fileName = filename;
 
-        FILE* input = fopen(filename.c_str(), "rb");
+        // files of mounted scene archives are read in place
+        const char *archiveData;
+        size_t archiveSize;
+        std::vector<char> archiveBuffer;
+        FILE* input = NULL;
+#ifndef WIN32
+        if(utils::SceneArchive::getMountedFile(filename, &archiveData,
+                                               &archiveSize, &archiveBuffer)) {
+          input = fmemopen((void*)archiveData, archiveSize, "rb");
+        }
+#endif
+        if(!input) input = fopen(filename.c_str(), "rb");
         if(!input) {
           fprintf(stderr, "ERROR: reading file: %s\n", filename.c_str());
           return 0;
@@ -604,8 +616,18 @@ namespace mars {
       void GuiHelper::readPixelData(mars::interfaces::terrainStruct *terrain) {
 
         cv::Mat img;
+        const char *archiveData;
+        size_t archiveSize;
+        std::vector<char> archiveBuffer;
 
-        img=cv::imread(terrain->srcname, cv::IMREAD_ANYDEPTH);
+        if(utils::SceneArchive::getMountedFile(terrain->srcname, &archiveData,
+                                               &archiveSize, &archiveBuffer)) {
+          cv::Mat raw(1, (int)archiveSize, CV_8UC1, (void*)archiveData);
+          img=cv::imdecode(raw, cv::IMREAD_ANYDEPTH);
+        }
+        else {
+          img=cv::imread(terrain->srcname, cv::IMREAD_ANYDEPTH);
+        }
         if(img.data) {
           terrain->width = img.cols;
           terrain->height = img.rows;
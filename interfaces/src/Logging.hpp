@@ -15,13 +15,14 @@
 #ifndef ROCK
 //Push the logging mechanism to mars if mars is used standalone
 #include <mars/data_broker/DataBrokerInterface.h>
-// use pushMessage() rather than pushError et al because pushMessage 
-// can also take a va_list.
-#define LOG_FATAL(...) if(mars::interfaces::ControlCenter::theDataBroker) (mars::interfaces::ControlCenter::theDataBroker->pushMessage(mars::data_broker::DB_MESSAGE_TYPE_FATAL, __VA_ARGS__))
-#define LOG_ERROR(...) if(mars::interfaces::ControlCenter::theDataBroker) (mars::interfaces::ControlCenter::theDataBroker->pushMessage(mars::data_broker::DB_MESSAGE_TYPE_ERROR, __VA_ARGS__))
-#define LOG_WARN(...) if(mars::interfaces::ControlCenter::theDataBroker) (mars::interfaces::ControlCenter::theDataBroker->pushMessage(mars::data_broker::DB_MESSAGE_TYPE_WARNING, __VA_ARGS__))
-#define LOG_INFO(...) if(mars::interfaces::ControlCenter::theDataBroker) (mars::interfaces::ControlCenter::theDataBroker->pushMessage(mars::data_broker::DB_MESSAGE_TYPE_INFO, __VA_ARGS__))
-#define LOG_DEBUG(...) if(mars::interfaces::ControlCenter::theDataBroker) (mars::interfaces::ControlCenter::theDataBroker->pushMessage(mars::data_broker::DB_MESSAGE_TYPE_DEBUG, __VA_ARGS__))
+// use logMessage() rather than pushError et al because logMessage
+// can also take a va_list. It queues the message and rate limits each
+// call site, so the format should be a string literal.
+#define LOG_FATAL(...) if(mars::interfaces::ControlCenter::theDataBroker) (mars::interfaces::ControlCenter::theDataBroker->logMessage(mars::data_broker::DB_MESSAGE_TYPE_FATAL, __VA_ARGS__))
+#define LOG_ERROR(...) if(mars::interfaces::ControlCenter::theDataBroker) (mars::interfaces::ControlCenter::theDataBroker->logMessage(mars::data_broker::DB_MESSAGE_TYPE_ERROR, __VA_ARGS__))
+#define LOG_WARN(...) if(mars::interfaces::ControlCenter::theDataBroker) (mars::interfaces::ControlCenter::theDataBroker->logMessage(mars::data_broker::DB_MESSAGE_TYPE_WARNING, __VA_ARGS__))
+#define LOG_INFO(...) if(mars::interfaces::ControlCenter::theDataBroker) (mars::interfaces::ControlCenter::theDataBroker->logMessage(mars::data_broker::DB_MESSAGE_TYPE_INFO, __VA_ARGS__))
+#define LOG_DEBUG(...) if(mars::interfaces::ControlCenter::theDataBroker) (mars::interfaces::ControlCenter::theDataBroker->logMessage(mars::data_broker::DB_MESSAGE_TYPE_DEBUG, __VA_ARGS__))
 #else //ROCK
 //Useing the Rock logging system
 #include <base/Logging.hpp>
@@ -73,6 +73,19 @@ namespace mars {
       virtual void addDrawItems(drawStruct *draw) = 0; ///< Adds \c drawStruct items to the graphics scene
       virtual void removeDrawItems(DrawInterface *iface) = 0;
       virtual void clearDrawItems(void) = 0;
+      /**
+       * \brief Replaces the debug geometry of \a channel by the content of
+       *        \a buffer.
+       *
+       * The geometry is swapped, \a buffer gets the previous geometry of the
+       * channel and can be cleared and refilled for the next step. Its line
+       * width, point and label size are copied and kept by \a buffer. The
+       * graphics uploads the latest geometry of every channel once per
+       * frame. Can be called from any thread.
+       */
+      virtual void swapDebugDraw(const std::string &channel,
+                                 DebugDrawBuffer *buffer) {}
+      virtual void removeDebugDraw(const std::string &channel) {}
 
       virtual void addLight(LightData &ls) = 0; ///< Adds a light to the scene.
 
@@ -85,6 +98,18 @@ namespace mars {
                                     const mars::utils::Vector &pos) = 0;
       virtual void setDrawObjectRot(unsigned long id,
                                     const mars::utils::Quaternion &q) = 0;
+      /**
+       * \brief Sets the position and orientation of \a count draw objects
+       *        in one call.
+       */
+      virtual void setDrawObjectPoses(size_t count, const unsigned long *ids,
+                                      const mars::utils::Vector *pos,
+                                      const mars::utils::Quaternion *q) {
+        for(size_t i=0; i<count; ++i) {
+          setDrawObjectPos(ids[i], pos[i]);
+          setDrawObjectRot(ids[i], q[i]);
+        }
+      }
       virtual void setDrawObjectScale(unsigned long id,
                                       const mars::utils::Vector &ext) = 0;
       virtual void setDrawObjectMaterial(unsigned long id, 
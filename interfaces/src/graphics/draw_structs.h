@@ -36,6 +36,9 @@
 #include <mars/utils/Color.h>
 #include <mars/utils/Vector.h>
 
+#include <Eigen/Geometry>
+
+#include <cmath>
 #include <string>
 #include <vector>
 
@@ -112,6 +115,114 @@ namespace mars {
       std::vector<draw_item> drawItems;
     }; // end of struct drawStruct
 
+    /**
+     * \brief DebugDrawBuffer collects the debug geometry of one producer,
+     * e.g. the contacts of a physics step.
+     *
+     * The buffer is filled without any graphics calls and handed over with
+     * GraphicsManagerInterface::swapDebugDraw. All lines and all points of a
+     * buffer are drawn with one draw call each, independent of their number.
+     * clear() keeps the allocated memory, so a buffer that is refilled every
+     * step does not allocate.
+     */
+    struct DebugDrawBuffer {
+      struct Label {
+        mars::utils::Vector pos;
+        mars::utils::Color color;
+        std::string text;
+      };
+
+      // two vertices and one color per line
+      std::vector<mars::utils::Vector> lineVertices;
+      std::vector<mars::utils::Color> lineColors;
+      std::vector<mars::utils::Vector> points;
+      std::vector<mars::utils::Color> pointColors;
+      std::vector<Label> labels;
+      double lineWidth, pointSize, labelSize;
+
+      DebugDrawBuffer() : lineWidth(1.0), pointSize(5.0), labelSize(0.1) {}
+
+      void clear() {
+        lineVertices.clear();
+        lineColors.clear();
+        points.clear();
+        pointColors.clear();
+        labels.clear();
+      }
+
+      bool empty() const {
+        return lineColors.empty() && points.empty() && labels.empty();
+      }
+
+      /**
+       * \brief Swaps the geometry with \a other. The style (line width,
+       *        point and label size) stays with each buffer.
+       */
+      void swapGeometry(DebugDrawBuffer &other) {
+        lineVertices.swap(other.lineVertices);
+        lineColors.swap(other.lineColors);
+        points.swap(other.points);
+        pointColors.swap(other.pointColors);
+        labels.swap(other.labels);
+      }
+
+      void addLine(const mars::utils::Vector &start,
+                   const mars::utils::Vector &end,
+                   const mars::utils::Color &color) {
+        lineVertices.push_back(start);
+        lineVertices.push_back(end);
+        lineColors.push_back(color);
+      }
+
+      void addPoint(const mars::utils::Vector &pos,
+                    const mars::utils::Color &color) {
+        points.push_back(pos);
+        pointColors.push_back(color);
+      }
+
+      /**
+       * \brief Adds an arrow from \a start to \a end. The head is made of
+       *        four lines, its length is \a headSize times the arrow length.
+       */
+      void addArrow(const mars::utils::Vector &start,
+                    const mars::utils::Vector &end,
+                    const mars::utils::Color &color, double headSize=0.2) {
+        mars::utils::Vector dir = end - start;
+        double length = dir.norm();
+        addLine(start, end, color);
+        if(length <= 0.0) return;
+
+        // two directions perpendicular to the arrow span the head
+        mars::utils::Vector other(0.0, 0.0, 0.0);
+        if(fabs(dir.x()) <= fabs(dir.y()) && fabs(dir.x()) <= fabs(dir.z())) {
+          other.x() = 1.0;
+        }
+        else if(fabs(dir.y()) <= fabs(dir.z())) {
+          other.y() = 1.0;
+        }
+        else {
+          other.z() = 1.0;
+        }
+        double head = length*headSize;
+        mars::utils::Vector side = dir.cross(other).normalized()*(head*0.5);
+        mars::utils::Vector up = (dir/length).cross(side);
+        mars::utils::Vector base = end - dir*headSize;
+        addLine(end, base+side, color);
+        addLine(end, base-side, color);
+        addLine(end, base+up, color);
+        addLine(end, base-up, color);
+      }
+
+      void addLabel(const mars::utils::Vector &pos, const std::string &text,
+                    const mars::utils::Color &color) {
+        Label label;
+        label.pos = pos;
+        label.color = color;
+        label.text = text;
+        labels.push_back(label);
+      }
+    }; // end of struct DebugDrawBuffer
+
 
     struct hudElementStruct {
       int id;
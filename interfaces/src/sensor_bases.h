@@ -43,11 +43,13 @@ namespace mars {
 
     class BaseConfig {
     public:
-      BaseConfig() : updateRate(10) {}
+      BaseConfig() : updateRate(10), historySize(0) {}
       virtual ~BaseConfig() {}
       std::string name;
       unsigned long id;
       unsigned long updateRate;
+      // number of samples kept per sensor, 0 disables the history
+      unsigned long historySize;
     }; // end of class BaseConfig
 
     class BaseSensor {
@@ -82,6 +84,27 @@ namespace mars {
         return 0;
       }
 
+      /**
+       * Appends the samples recorded since the simulation time \c since
+       * (in ms) if the sensor keeps a history of its data.
+       * \return the number of appended samples
+       */
+      virtual int getHistory(double since, std::vector<double> *times,
+                             std::vector<double> *data) const{
+        return 0;
+      }
+
+      /**
+       * Interpolates the sensor data at the simulation time \c time
+       * (in ms) from the history of the sensor.
+       * \return false if the sensor has no history or the time is not
+       *         covered by it
+       */
+      virtual bool getSensorDataAt(double time,
+                                   std::vector<double> *data) const{
+        return false;
+      }
+
       void getCoreExchange(core_objects_exchange* obj) const{
         obj->index = id;
         obj->name = name;
@@ -32,6 +32,8 @@
 #include <string>
 #include <vector>
 #include <configmaps/ConfigData.h>
+#include <mars/utils/Vector.h>
+#include <mars/utils/Geometry.hpp>
 
 namespace mars {
 
@@ -123,6 +125,25 @@ namespace mars {
       /**returns the node of the given entity; returns 0 if the entity or the node don't exist*/
       virtual unsigned long getEntityJoint(const std::string &entityName, const std::string &jointName) = 0;
 
+      /**spatial queries on the bounding boxes of the entities; they return
+       * the ids of all entities whose world aligned bounding box overlaps
+       * the given volume*/
+      virtual void getEntitiesInBox(const utils::Vector &min, const utils::Vector &max,
+                                    std::vector<unsigned long> *ids) = 0;
+      virtual void getEntitiesInSphere(const utils::Vector &center, double radius,
+                                       std::vector<unsigned long> *ids) = 0;
+      /**the plane normals have to point to the inside of the frustum*/
+      virtual void getEntitiesInFrustum(const std::vector<utils::Plane> &planes,
+                                        std::vector<unsigned long> *ids) = 0;
+      /**returns the eight vertices and the center of the cached oriented
+       * bounding box of an entity; returns false if the entity doesn't exist*/
+      virtual bool getEntityBoundingBox(unsigned long id, std::vector<utils::Vector> *vertices,
+                                        utils::Vector *center) = 0;
+      /**marks the cached bounding boxes as outdated, called after each step
+       * and whenever nodes are moved; can be called from any thread without
+       * locking the entity manager*/
+      virtual void invalidateBoundingVolumes() = 0;
+
       //Debug functions
       virtual void printEntityNodes(const std::string &entityName) = 0;
       virtual void printEntityMotors(const std::string &entityName) = 0;
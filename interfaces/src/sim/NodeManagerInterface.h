@@ -371,6 +371,23 @@ namespace mars {
        */
       virtual const utils::Quaternion getRotation(NodeId id) const = 0;
 
+      /**
+       * \brief Returns position, orientation and extent of a node.
+       *
+       * Unlike \c getFullNode this does not copy the NodeData of the node
+       * (names, material, config map) and takes the node lock only once.
+       * Use it where only the spatial state of a node is needed.
+       *
+       * \param id The id of the node.
+       * \param pos Is filled with the position of the node.
+       * \param rot Is filled with the orientation of the node.
+       * \param ext Is filled with the extent of the node.
+       * \returns \c false if no node with the given id exists.
+       */
+      virtual bool getNodeBounds(NodeId id, utils::Vector *pos,
+                                 utils::Quaternion *rot,
+                                 utils::Vector *ext) const = 0;
+
       /**
        * \brief Sets the current orientation of a node.
        *
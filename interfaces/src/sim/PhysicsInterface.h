@@ -56,20 +56,46 @@ namespace mars {
     public:
       sReal ground_friction, ground_cfm, ground_erp;
       sReal step_size; /**< Step size in seconds */
+      /**< Number of physics steps per simulation step. The nodes and
+       *   their sensors are updated once after all of them. */
+      int num_sub_steps;
       utils::Vector world_gravity;
       bool fast_step;
       bool draw_contact_points;
       sReal world_cfm, world_erp;
+      /**< Contacts of one geom pair closer than this distance are merged
+       *   into one contact; a value <= 0 disables the merging. */
+      sReal contact_merge_distance;
+      /**< The contacts of a geom pair are reused in the next step if both
+       *   geoms moved less than this distance and their rotation matrices
+       *   changed less than this value; a value <= 0 disables the reuse. */
+      sReal contact_reuse_tolerance;
 
       virtual ~PhysicsInterface() {}
       virtual void setPhysicsPlugins(std::vector<mars::interfaces::pluginStruct> physicsPlugins) = 0;
       virtual void initTheWorld(void) = 0;
       virtual void freeTheWorld(void) = 0;
       virtual void stepTheWorld(void) = 0;
+      /**
+       * Removes the contacts added from outside the collision detection
+       * (NodeInterface::addContact). They act in every sub-step, so this
+       * is called once after all sub-steps of a step.
+       */
+      virtual void clearExternalContacts(void) = 0;
       virtual bool existsWorld(void) const = 0;
       virtual const utils::Vector getCenterOfMass(const std::vector<std::shared_ptr<NodeInterface>> &nodes) const = 0;
       virtual int checkCollisions(void) = 0;
       virtual sReal getVectorCollision(const utils::Vector &pos, const utils::Vector &ray) const = 0;
+      /**
+       * Batched version of getVectorCollision: traces one ray per start
+       * position in \c pos, all with the same direction and length given
+       * by \c ray. The scene is culled once against the bounding box of
+       * all rays. \c depths is resized to pos.size() and filled with the
+       * distance to the closest hit (or the ray length if nothing is hit).
+       */
+      virtual void getVectorCollisions(const std::vector<utils::Vector> &pos,
+                                       const utils::Vector &ray,
+                                       std::vector<sReal> *depths) const = 0;
       virtual void getSphereCollision(const utils::Vector &pos,
                                       const double r,
                                       std::vector<utils::Vector> &contacts,
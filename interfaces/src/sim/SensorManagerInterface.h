@@ -163,6 +163,31 @@ namespace mars {
        */
       virtual int getSensorData(unsigned long id, sReal **data) const = 0;
 
+      /**
+       * \brief Reads all samples a sensor recorded since the given time.
+       *
+       * Only sensors configured with a \c history size record samples.
+       *
+       * \param since The simulation time in ms after which samples are read.
+       * \param times Receives the time stamps of the samples.
+       * \param data Receives the samples one after another in the layout of
+       *        getSensorData.
+       * \return The number of samples read.
+       */
+      virtual int getSensorHistory(unsigned long id, double since,
+                                   std::vector<double> *times,
+                                   std::vector<double> *data) const = 0;
+
+      /**
+       * \brief Interpolates the data of a sensor at the given simulation
+       *        time from its recorded samples.
+       *
+       * \return false if the sensor has no history or the time is not
+       *         covered by the recorded samples.
+       */
+      virtual bool getSensorDataAt(unsigned long id, double time,
+                                   std::vector<double> *data) const = 0;
+
       /**
        *\brief Returns the number of sensors that are currently present in the simulation.
        *
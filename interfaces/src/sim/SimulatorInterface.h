@@ -40,6 +40,9 @@
 #include "../LightData.h"
 #include <mars/utils/Vector.h>
 
+#include <map>
+#include <string>
+
 namespace lib_manager {
   class LibManager;
 }
@@ -120,6 +123,16 @@ namespace mars {
        */
       virtual unsigned long getTime() = 0;
 
+      /**
+       * \brief Returns the wall time in ms spent in each phase of step()
+       * ("physics", "nodes", "joints", "motors", "controllers",
+       * "data_broker", "plugins"), summed over the steps counted since the
+       * last resetStepPhaseTimes() call.
+       */
+      virtual void getStepPhaseTimes(std::map<std::string, double> *phaseMs,
+                                     unsigned long *steps) = 0;
+      virtual void resetStepPhaseTimes() = 0;
+
     };
 
 
@@ -95,6 +95,18 @@ def requestDataBroker(group_name, package_name, data_name):
     global iDict
     iDict["request"].append({"type": "DataBroker", "g": group_name, "name": package_name, "d": data_name})
 
+def requestEntitiesInSphere(name, center, radius):
+    global iDict
+    iDict["request"].append({"type": "EntitiesInSphere", "name": name,
+                             "center": [float(x) for x in center],
+                             "radius": float(radius)})
+
+def requestEntitiesInBox(name, min_corner, max_corner):
+    global iDict
+    iDict["request"].append({"type": "EntitiesInBox", "name": name,
+                             "min": [float(x) for x in min_corner],
+                             "max": [float(x) for x in max_corner]})
+
 def logMessage(s):
     global iDict
     iDict["log"]["debug"].append(s)
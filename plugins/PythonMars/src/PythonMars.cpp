@@ -33,11 +33,13 @@
 #include <mars/interfaces/sim/SensorManagerInterface.h>
 #include <mars/interfaces/sim/NodeManagerInterface.h>
 #include <mars/interfaces/sim/JointManagerInterface.h>
+#include <mars/interfaces/sim/EntityManagerInterface.h>
 #include <mars/interfaces/sim/SimulatorInterface.h>
 #include <mars/interfaces/graphics/GraphicsManagerInterface.h>
 #include <mars/data_broker/DataPackage.h>
 #include <mars/sim/CameraSensor.h>
 #include <mars/sim/SimNode.h>
+#include <mars/sim/SimEntity.h>
 #include <mars/app/MARS.h>
 #include <mars/utils/misc.h>
 #ifdef __unix__
@@ -55,6 +57,10 @@ namespace mars {
       using namespace mars::utils;
       using namespace mars::interfaces;
 
+      // upper bound for the ring buffer of a streaming line; the buffer
+      // is allocated at once and strips store every point twice
+      static const int maxLineStreamingCapacity = 1000000;
+
       PythonMars::PythonMars(lib_manager::LibManager *theManager)
         : MarsPluginTemplateGUI(theManager, "PythonMars")      {
 #ifdef __unix__
@@ -151,13 +157,13 @@ namespace mars {
             if(map["log"].hasKey("debug")) {
               ConfigVector::iterator it = map["log"]["debug"].begin();
               for(; it!=map["log"]["debug"].end(); ++it) {
-                LOG_DEBUG((std::string)*it);
+                LOG_DEBUG("%s", ((std::string)*it).c_str());
               }
             }
             if(map["log"].hasKey("error")) {
               ConfigVector::iterator it = map["log"]["error"].begin();
               for(; it!=map["log"]["error"].end(); ++it) {
-                LOG_ERROR((std::string)*it);
+                LOG_ERROR("%s", ((std::string)*it).c_str());
               }
             }
             ConfigMap::iterator it = map.find("log");
@@ -267,6 +273,10 @@ namespace mars {
           }
 
           if(map.hasKey("config")) {
+            // existing params are changed as one batch
+            std::vector<cfg_manager::cfgPropertyStruct> batch;
+            cfg_manager::cfgPropertyStruct prop;
+            prop.propertyIndex = 0;
             ConfigMap::iterator it = map["config"].beginMap();
             for(; it!=map["config"].endMap(); ++it) {
               std::string group = it->first;
@@ -279,18 +289,27 @@ namespace mars {
                 std::string value = atom.toString().c_str();
                 cfg_manager::cfgParamInfo info;
                 info = control->cfg->getParamInfo(group, name);
+                prop.paramId = info.id;
                 switch(info.type) {
                 case cfg_manager::boolParam:
-                  control->cfg->setProperty(group, name, (bool)atoi(value.c_str()));
+                  prop.propertyType = cfg_manager::boolProperty;
+                  prop.bValue = (bool)atoi(value.c_str());
+                  batch.push_back(prop);
                   break;
                 case cfg_manager::doubleParam:
-                  control->cfg->setProperty(group, name, atof(value.c_str()));
+                  prop.propertyType = cfg_manager::doubleProperty;
+                  prop.dValue = atof(value.c_str());
+                  batch.push_back(prop);
                   break;
                 case cfg_manager::intParam:
-                  control->cfg->setProperty(group, name, atoi(value.c_str()));
+                  prop.propertyType = cfg_manager::intProperty;
+                  prop.iValue = atoi(value.c_str());
+                  batch.push_back(prop);
                   break;
                 case cfg_manager::stringParam:
-                  control->cfg->setProperty(group, name, value);
+                  prop.propertyType = cfg_manager::stringProperty;
+                  prop.sValue = value;
+                  batch.push_back(prop);
                   break;
                 case cfg_manager::noParam:
                   switch(atom.getType()) {
@@ -314,6 +333,9 @@ namespace mars {
                 }
               }
             }
+            if(!batch.empty() && !control->cfg->setProperties(batch)) {
+              LOG_ERROR("PythonMars: config batch rejected, nothing changed");
+            }
             ConfigMap::iterator iit = map.find("config");
             map.erase(iit);
           }
@@ -622,6 +644,21 @@ namespace mars {
                     lines[name].l->setBezierMode((int)cmd["config"][4]);
                     lines[name].l->setBezierInterpolationPoints((int)cmd["config"][5]);
                   }
+                  if(cmd.hasKey("streaming")) {
+                    int capacity = cmd["streaming"];
+                    if(capacity <= 0) {
+                      LOG_ERROR("PythonMars: ignore invalid streaming capacity %d of line %s",
+                                capacity, name.c_str());
+                    }
+                    else {
+                      if(capacity > maxLineStreamingCapacity) {
+                        LOG_WARN("PythonMars: limit streaming capacity of line %s to %d",
+                                 name.c_str(), maxLineStreamingCapacity);
+                        capacity = maxLineStreamingCapacity;
+                      }
+                      lines[name].l->setStreamingCapacity((unsigned long)capacity);
+                    }
+                  }
                 }
               }
             }
@@ -782,6 +819,32 @@ namespace mars {
               }
             }
 
+            if(type == "EntitiesInSphere" || type == "EntitiesInBox") {
+              std::vector<unsigned long> ids;
+              if(type == "EntitiesInSphere") {
+                if(!it->hasKey("center") || !it->hasKey("radius")) continue;
+                ConfigItem &c = (*it)["center"];
+                Vector center((double)c[0], (double)c[1], (double)c[2]);
+                control->entities->getEntitiesInSphere(center,
+                                                       (double)(*it)["radius"],
+                                                       &ids);
+              }
+              else {
+                if(!it->hasKey("min") || !it->hasKey("max")) continue;
+                ConfigItem &a = (*it)["min"];
+                ConfigItem &b = (*it)["max"];
+                Vector min((double)a[0], (double)a[1], (double)a[2]);
+                Vector max((double)b[0], (double)b[1], (double)b[2]);
+                control->entities->getEntitiesInBox(min, max, &ids);
+              }
+              sendMap["Entities"][name] = ConfigVector();
+              int n = 0;
+              for(size_t i=0; i<ids.size(); ++i) {
+                sim::SimEntity *entity = control->entities->getEntity(ids[i]);
+                if(entity) sendMap["Entities"][name][n++] = entity->getName();
+              }
+            }
+
             if(type == "Config") {
               if(!it->hasKey("group")) continue;
               std::string group = (*it)["group"];
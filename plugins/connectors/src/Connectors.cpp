@@ -35,8 +35,12 @@
 #include <mars/interfaces/sim/JointManagerInterface.h>
 #include <mars/sim/SimEntity.h>
 #include <mars/sim/SimJoint.h>
+#include <mars/sim/SimNode.h>
 #include <mars/utils/mathUtils.h>
 
+#include <cmath>
+#include <algorithm>
+
 namespace mars {
   namespace plugins {
     namespace connectors {
@@ -49,7 +53,7 @@ namespace mars {
 
       Connectors::Connectors(lib_manager::LibManager *theManager) :
         MarsPluginTemplateGUI(theManager, "Connectors"),
-        mars::utils::Thread() {
+        mars::utils::Thread(), cellSize(0.0) {
       }
 
       void Connectors::init() {
@@ -129,6 +133,8 @@ namespace mars {
           femaleconnectors[female]["jointid"] = jointid;
           femaleconnectors[female]["partner"] = male;
           connections[male] = female;
+          setConnected(male, true, true);
+          setConnected(female, false, true);
         }
       }
 
@@ -162,6 +168,8 @@ namespace mars {
           control->joints->removeJoint(jointid); // if no match is found, this tries to delete joint id 0
           (it->second)["jointid"] = 0;
           (it->second)["partner"] = "";
+          setConnected(connector, male, false);
+          setConnected(partner, !male, false);
           if (male) {
             it = femaleconnectors.find(partner);
           } else {
@@ -186,6 +194,18 @@ namespace mars {
           for (configmaps::ConfigVector::iterator it = typevec.begin(); it!= typevec.end(); ++it) {
             tmpmap = (*it);
             connectortypes[(*it)["name"]] = tmpmap; // the one last read in determines the type
+            ConnectorType &type = typeCache[(std::string)tmpmap["name"]];
+            type.distance = tmpmap.get("distance", 0.0);
+            type.angle = tmpmap.get("angle", 0.0);
+            type.maxforce = tmpmap.get("maxforce", 0.0);
+            if(type.distance > cellSize) {
+              // the grid cells have to cover the largest mating distance
+              cellSize = type.distance;
+              femaleGrid.clear();
+              for(size_t i=0; i<femaleStates.size(); ++i) {
+                femaleStates[i].inGrid = false;
+              }
+            }
           }
 
           // gather connectors
@@ -193,10 +213,41 @@ namespace mars {
           for (configmaps::ConfigVector::iterator it = convec.begin(); it!= convec.end(); ++it) {
             tmpmap = (*it);
             tmpmap["nodeid"] = control->nodes->getID((*it)["link"]);
+            ConnectorState state;
+            state.name = (std::string)tmpmap["name"];
+            state.type = (std::string)tmpmap["type"];
+            state.nodeid = tmpmap["nodeid"];
+            state.hasNode = false;
+            state.typeInfo = NULL;
+            state.automatic = (tmpmap.get("mating", std::string()) == "automatic");
+            state.connected = false;
+            state.cellKey = 0;
+            state.inGrid = false;
             if (((std::string)((*it)["gender"])).compare("male") == 0) { // male
+              if(maleIndex.find(state.name) == maleIndex.end()) {
+                maleIndex[state.name] = maleStates.size();
+                maleStates.push_back(state);
+              }
+              else {
+                maleStates[maleIndex[state.name]] = state;
+              }
               maleconnectors[(std::string)(tmpmap["name"])] =  tmpmap;
               fprintf(stderr, "Adding male connector: %s\n", ((std::string)(tmpmap["name"])).c_str(), (unsigned long)(tmpmap["nodeid"]));
             } else { // female
+              std::map<std::string, size_t>::iterator fit = femaleIndex.find(state.name);
+              if(fit == femaleIndex.end()) {
+                femaleIndex[state.name] = femaleStates.size();
+                femaleStates.push_back(state);
+              }
+              else {
+                // drop the old grid entry, it is re-added on the next check
+                ConnectorState &old = femaleStates[fit->second];
+                if(old.inGrid) {
+                  std::vector<size_t> &cell = femaleGrid[old.cellKey];
+                  cell.erase(std::remove(cell.begin(), cell.end(), fit->second), cell.end());
+                }
+                old = state;
+              }
               femaleconnectors[(std::string)(tmpmap["name"])] = tmpmap;
               fprintf(stderr, "Adding female connector: %s\n", ((std::string)(tmpmap["name"])).c_str());
             }
@@ -210,61 +261,129 @@ namespace mars {
       Connectors::~Connectors() {
       }
 
-      bool Connectors::closeEnough(std::string malename, std::string femalename) {
-        unsigned long maleid = maleconnectors[malename]["nodeid"];
-        unsigned long femaleid = femaleconnectors[femalename]["nodeid"];
-        utils::Vector malerot = control->nodes->getRotation(maleid)*Vector(1.0, 0.0, 0.0);
-        utils::Vector femalerot = control->nodes->getRotation(femaleid)*Vector(1.0, 0.0, 0.0);
-        sReal angle = utils::angleBetween(malerot, femalerot);
-
-        //TODO: this is a hard-coded hack, should be defined in type
-        sReal distance = utils::distanceBetween(control->nodes->getPosition(maleid),
-          control->nodes->getPosition(femaleid));
-        //fprintf(stderr, "distance/angle: %i, %i, %g/%g\n", maleid, femaleid, distance, angle);
-        return (distance <= ((double)(connectortypes[maleconnectors[malename]["type"]]["distance"]))
-          && angle < ((double)(connectortypes[maleconnectors[malename]["type"]]["angle"])));
-
+      bool Connectors::closeEnough(const ConnectorState &male,
+                                   const ConnectorState &female) {
+        if(!male.typeInfo) return false;
+        sReal distance = (male.pos - female.pos).norm();
+        if(distance > male.typeInfo->distance) return false;
+        sReal angle = utils::angleBetween(male.xAxis, female.xAxis);
+        return angle < male.typeInfo->angle;
       }
 
-      void Connectors::checkForPossibleConnections(bool isforced) {
-        // Connector properties.
-        std::string malename, femalename, maletype, femaletype, malemating, femalemating;
+      unsigned long Connectors::getCellKey(long x, long y, long z) const {
+        // unsigned arithmetic wraps instead of overflowing
+        return (((unsigned long)x*73856093UL) ^ ((unsigned long)y*19349663UL) ^
+                ((unsigned long)z*83492791UL));
+      }
 
-        // Merge type to check against.
-        std::string automatic ("automatic");
+      void Connectors::setConnected(const std::string &name, bool male,
+                                    bool connected) {
+        std::map<std::string, size_t> &index = male ? maleIndex : femaleIndex;
+        std::map<std::string, size_t>::iterator it = index.find(name);
+        if(it != index.end()) {
+          (male ? maleStates : femaleStates)[it->second].connected = connected;
+        }
+      }
 
-        // Nested for loop to check for every male-female connector mating combination.
-        for (std::map<std::string, configmaps::ConfigMap>::iterator mit= maleconnectors.begin();
-          mit!=maleconnectors.end(); ++mit) {
+      void Connectors::updateConnectorFrames() {
+        for(size_t i=0; i<maleStates.size(); ++i) {
+          ConnectorState &state = maleStates[i];
+          if(!state.typeInfo) {
+            // the type may be declared by an entity registered later
+            std::map<std::string, ConnectorType>::const_iterator it = typeCache.find(state.type);
+            if(it != typeCache.end()) state.typeInfo = &(it->second);
+          }
+          if(state.connected) continue;
+          std::shared_ptr<sim::SimNode> node = control->nodes->getSimNode(state.nodeid);
+          state.hasNode = (node != NULL);
+          if(!node) continue;
+          state.pos = node->getPosition();
+          state.xAxis = node->getRotation()*Vector(1.0, 0.0, 0.0);
+        }
 
-          // Get male connector properties.
-          malename = (std::string)mit->second["name"];
-          maletype = (std::string)mit->second["type"];
-          malemating = (std::string)mit->second["mating"];
+        // only move the females whose cell changed since the last check
+        double invCellSize = cellSize > 0.0 ? 1.0/cellSize : 1.0;
+        for(size_t i=0; i<femaleStates.size(); ++i) {
+          ConnectorState &state = femaleStates[i];
+          std::shared_ptr<sim::SimNode> node = control->nodes->getSimNode(state.nodeid);
+          state.hasNode = (node != NULL);
+          if(!node) {
+            // the node was removed, so the connector leaves the grid
+            if(state.inGrid) {
+              std::vector<size_t> &cell = femaleGrid[state.cellKey];
+              cell.erase(std::remove(cell.begin(), cell.end(), i), cell.end());
+              state.inGrid = false;
+            }
+            continue;
+          }
+          state.pos = node->getPosition();
+          state.xAxis = node->getRotation()*Vector(1.0, 0.0, 0.0);
+          unsigned long key = getCellKey((long)std::floor(state.pos.x()*invCellSize),
+                                         (long)std::floor(state.pos.y()*invCellSize),
+                                         (long)std::floor(state.pos.z()*invCellSize));
+          if(state.inGrid && key == state.cellKey) continue;
+          if(state.inGrid) {
+            std::vector<size_t> &cell = femaleGrid[state.cellKey];
+            cell.erase(std::remove(cell.begin(), cell.end(), i), cell.end());
+          }
+          femaleGrid[key].push_back(i);
+          state.cellKey = key;
+          state.inGrid = true;
+        }
+      }
 
-          for (std::map<std::string, configmaps::ConfigMap>::iterator fit= femaleconnectors.begin();
-            fit!=femaleconnectors.end(); ++fit) {
+      void Connectors::checkForPossibleConnections(bool isforced) {
+        if(maleStates.empty() || femaleStates.empty()) return;
+        updateConnectorFrames();
+
+        double invCellSize = cellSize > 0.0 ? 1.0/cellSize : 1.0;
+        std::vector<size_t> candidates;
+
+        for(size_t m=0; m<maleStates.size(); ++m) {
+          ConnectorState &male = maleStates[m];
+          if(male.connected || !male.hasNode || !male.typeInfo) continue;
+
+          // gather the females from the 27 cells around the male; the cell
+          // size equals the largest mating distance of all types
+          candidates.clear();
+          long cx = (long)std::floor(male.pos.x()*invCellSize);
+          long cy = (long)std::floor(male.pos.y()*invCellSize);
+          long cz = (long)std::floor(male.pos.z()*invCellSize);
+          for(long x=cx-1; x<=cx+1; ++x) {
+            for(long y=cy-1; y<=cy+1; ++y) {
+              for(long z=cz-1; z<=cz+1; ++z) {
+                std::unordered_map<unsigned long, std::vector<size_t> >::const_iterator cell;
+                cell = femaleGrid.find(getCellKey(x, y, z));
+                if(cell == femaleGrid.end()) continue;
+                candidates.insert(candidates.end(), cell->second.begin(),
+                                  cell->second.end());
+              }
+            }
+          }
+          // hash collisions can report a female twice
+          std::sort(candidates.begin(), candidates.end());
+          candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                           candidates.end());
 
-            // Get female connector properties.
-            femalename = (std::string)fit->second["name"];
-            femaletype = (std::string)fit->second["type"];
-            femalemating = (std::string)fit->second["mating"];
+          for(size_t c=0; c<candidates.size(); ++c) {
+            ConnectorState &female = femaleStates[candidates[c]];
+            if(female.connected) continue;
 
             // There are 2 cases that will trigger checking for connections:
             //  1. When it is forced from the Control GUI: Control > Connect available connectors
             //  2. During plugin update(): IF autoconnect is globally set to true OR IF male and female's mating properties are both set to automatic.
-            if(isforced || (cfgautoconnect.bValue || (malemating.compare(automatic) == 0 && femalemating.compare(automatic) == 0))){
-
-              // Check if connectors meet the mating requirements:
-              //  1. They are of the  same type.
-              //  2. They are close enough to each other (distance and angle) as per the set thresholds in the model's YML config file.
-              //  3. They are not already connected to each other.
-              if (maletype.compare(femaletype) == 0 && closeEnough(malename, femalename)
-                && ((std::string)mit->second["partner"]).empty() && ((std::string)fit->second["partner"]).empty()) {
+            if(!(isforced || cfgautoconnect.bValue || (male.automatic && female.automatic))) {
+              continue;
+            }
 
-                  // All mating requirements have been met. Mate the connectors.
-                  connect(malename, femalename);
-              }
+            // Check if connectors meet the mating requirements:
+            //  1. They are of the  same type.
+            //  2. They are close enough to each other (distance and angle) as per the set thresholds in the model's YML config file.
+            //  3. They are not already connected to each other.
+            if(male.type == female.type && closeEnough(male, female)) {
+              // All mating requirements have been met. Mate the connectors.
+              connect(male.name, female.name);
+              if(male.connected) break;
             }
           }
         }
@@ -282,7 +401,8 @@ namespace mars {
             for (std::map<std::string, std::string>::iterator it = connections.begin(); it!=connections.end(); ++it) {
               utils::Vector forcevec = control->joints->getSimJoint(maleconnectors[it->first]["jointid"])->getJointLoad();
               //fprintf(stderr, "JointLoad: %g\n", forcevec.norm());
-              if (forcevec.norm() > (double)(connectortypes[maleconnectors[it->first]["type"]]["maxforce"])) {
+              const ConnectorState &male = maleStates[maleIndex[it->first]];
+              if (male.typeInfo && forcevec.norm() > male.typeInfo->maxforce) {
                 disconnect(it->first);
               }
             }
@@ -44,15 +44,49 @@
 
 // Threads.
 #include <mars/utils/Thread.h>
+#include <mars/utils/Vector.h>
 #include <atomic>
 
 #include <string>
+#include <vector>
+#include <unordered_map>
 
 namespace mars {
 
   namespace plugins {
     namespace connectors {
 
+      /**
+       * Mating thresholds of a connector type, parsed once from the
+       * "types" section of the entity config.
+       */
+      struct ConnectorType {
+        double distance;
+        double angle;
+        double maxforce;
+      };
+
+      /**
+       * Typed per connector state used by the mating checks. The frame
+       * (position and x-axis) is refreshed once per check from the SimNode
+       * looked up by nodeid and the connector is sorted into a uniform grid
+       * with the largest mating distance as cell size. Only the id is kept,
+       * so a removed node is not kept alive and its connector is skipped.
+       */
+      struct ConnectorState {
+        std::string name;
+        std::string type;
+        unsigned long nodeid;
+        bool hasNode;
+        const ConnectorType *typeInfo;
+        bool automatic;
+        bool connected;
+        utils::Vector pos;
+        utils::Vector xAxis;
+        unsigned long cellKey;
+        bool inGrid;
+      };
+
       class Connectors: public mars::interfaces::MarsPluginTemplateGUI,
         public mars::data_broker::ReceiverInterface,
         public mars::main_gui::MenuInterface,
@@ -103,7 +137,18 @@ namespace mars {
         std::map<std::string, configmaps::ConfigMap> femaleconnectors;
         std::map<std::string, configmaps::ConfigMap> connectortypes;
         std::map<std::string, std::string> connections;
-        bool closeEnough(std::string malename, std::string femalename);
+        std::map<std::string, ConnectorType> typeCache;
+        std::vector<ConnectorState> maleStates, femaleStates;
+        std::map<std::string, size_t> maleIndex, femaleIndex;
+        // female connectors sorted by grid cell
+        std::unordered_map<unsigned long, std::vector<size_t> > femaleGrid;
+        double cellSize;
+
+        bool closeEnough(const ConnectorState &male,
+                         const ConnectorState &female);
+        unsigned long getCellKey(long x, long y, long z) const;
+        void updateConnectorFrames();
+        void setConnected(const std::string &name, bool male, bool connected);
 
         /**
          * Checks every male-female connector mating combination and mates all
@@ -0,0 +1,309 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file DataBrokerShm.cpp
+ * \brief Mirrors DataBroker streams into POSIX shared memory.
+ */
+
+#include "DataBrokerShm.h"
+#include <mars/data_broker/DataBrokerInterface.h>
+#include <mars/utils/MutexLocker.h>
+#include <mars/utils/misc.h>
+
+namespace mars {
+  namespace plugins {
+    namespace data_broker_shm {
+
+      using namespace mars::utils;
+      using namespace mars::interfaces;
+      using namespace mars::data_broker;
+
+      // callback parameter of the simulation time registration
+      static const int simTimeCallback = -1;
+      // number of updates between attempts to open missing published streams
+      static const int openInterval = 100;
+
+      static bool getItemValue(const DataItem &item, double *value) {
+        switch(item.type) {
+        case INT_TYPE: *value = item.i; return true;
+        case UINT_TYPE: *value = item.ui; return true;
+        case LONG_TYPE: *value = item.l; return true;
+        case ULONG_TYPE: *value = item.ul; return true;
+        case FLOAT_TYPE: *value = item.f; return true;
+        case DOUBLE_TYPE: *value = item.d; return true;
+        case BOOL_TYPE: *value = item.b ? 1.0 : 0.0; return true;
+        default: return false;
+        }
+      }
+
+      static void addItem(DataPackage *package, const std::string &name,
+                          int type) {
+        switch(type) {
+        case INT_TYPE: package->add(name, (int)0); break;
+        case UINT_TYPE: package->add(name, (unsigned int)0); break;
+        case LONG_TYPE: package->add(name, (long)0); break;
+        case ULONG_TYPE: package->add(name, (unsigned long)0); break;
+        case FLOAT_TYPE: package->add(name, (float)0); break;
+        case BOOL_TYPE: package->add(name, false); break;
+        default: package->add(name, 0.0); break;
+        }
+      }
+
+      static void setItemValue(DataItem *item, double value) {
+        switch(item->type) {
+        case INT_TYPE: item->i = (int)value; break;
+        case UINT_TYPE: item->ui = (unsigned int)value; break;
+        case LONG_TYPE: item->l = (long)value; break;
+        case ULONG_TYPE: item->ul = (unsigned long)value; break;
+        case FLOAT_TYPE: item->f = (float)value; break;
+        case DOUBLE_TYPE: item->d = value; break;
+        case BOOL_TYPE: item->b = (value != 0.0); break;
+        default: break;
+        }
+      }
+
+      DataBrokerShm::DataBrokerShm(lib_manager::LibManager *theManager)
+        : MarsPluginTemplate(theManager, "DataBrokerShm"),
+          simTime(0.0), openCounter(0) {
+      }
+
+      void DataBrokerShm::init() {
+        cfgMirror = control->cfg->getOrCreateProperty("DataBrokerShm", "mirror",
+                                                      std::string(), this);
+        cfgPublish = control->cfg->getOrCreateProperty("DataBrokerShm", "publish",
+                                                       std::string(), this);
+        // only applies to streams created afterwards
+        cfgRingSize = control->cfg->getOrCreateProperty("DataBrokerShm", "ring size",
+                                                        256, this);
+        control->dataBroker->registerSyncReceiver(this, "mars_sim", "simTime",
+                                                  simTimeCallback);
+        setMirrorStreams(cfgMirror.sValue);
+        setPublishStreams(cfgPublish.sValue);
+      }
+
+      void DataBrokerShm::reset() {
+        simTime = 0.0;
+      }
+
+      DataBrokerShm::~DataBrokerShm() {
+        if(control->dataBroker) {
+          control->dataBroker->unregisterSyncReceiver(this, "mars_sim", "simTime");
+        }
+        clearMirrorStreams();
+        clearPublishStreams();
+      }
+
+      void DataBrokerShm::parseStreamList(const std::string &list,
+                                          std::vector<Stream*> *streams) {
+        std::vector<std::string> entries = explodeString(';', list);
+        for(size_t i=0; i<entries.size(); ++i) {
+          std::string entry = trim(entries[i]);
+          size_t pos = entry.find('/');
+          if(pos == std::string::npos || pos == 0 || pos+1 == entry.size()) {
+            if(!entry.empty()) {
+              fprintf(stderr, "DataBrokerShm: ignore invalid stream \"%s\"\n",
+                      entry.c_str());
+            }
+            continue;
+          }
+          Stream *stream = new Stream;
+          stream->groupName = entry.substr(0, pos);
+          stream->dataName = entry.substr(pos+1);
+          stream->packageSize = 0;
+          stream->pushId = 0;
+          stream->nextRead = 0;
+          stream->failed = false;
+          streams->push_back(stream);
+        }
+      }
+
+      void DataBrokerShm::clearMirrorStreams() {
+        // The DataBroker may call receiveData while we unregister, so the
+        // lock is only taken to delete the streams afterwards.
+        for(size_t i=0; i<mirrorStreams.size(); ++i) {
+          control->dataBroker->unregisterSyncReceiver(this,
+                                                      mirrorStreams[i]->groupName,
+                                                      mirrorStreams[i]->dataName);
+        }
+        MutexLocker locker(&streamMutex);
+        for(size_t i=0; i<mirrorStreams.size(); ++i) {
+          delete mirrorStreams[i];
+        }
+        mirrorStreams.clear();
+      }
+
+      void DataBrokerShm::clearPublishStreams() {
+        MutexLocker locker(&streamMutex);
+        for(size_t i=0; i<publishStreams.size(); ++i) {
+          delete publishStreams[i];
+        }
+        publishStreams.clear();
+      }
+
+      void DataBrokerShm::setMirrorStreams(const std::string &list) {
+        clearMirrorStreams();
+        std::vector<Stream*> streams;
+        parseStreamList(list, &streams);
+        streamMutex.lock();
+        mirrorStreams.swap(streams);
+        streamMutex.unlock();
+        // the regions are created with the first package we receive
+        for(size_t i=0; i<mirrorStreams.size(); ++i) {
+          control->dataBroker->registerSyncReceiver(this,
+                                                    mirrorStreams[i]->groupName,
+                                                    mirrorStreams[i]->dataName,
+                                                    (int)i);
+        }
+      }
+
+      void DataBrokerShm::setPublishStreams(const std::string &list) {
+        clearPublishStreams();
+        MutexLocker locker(&streamMutex);
+        parseStreamList(list, &publishStreams);
+        openCounter = 0;
+      }
+
+      bool DataBrokerShm::createMirror(Stream *stream,
+                                       const DataPackage &package) {
+        std::vector<std::string> names;
+        std::vector<int> types;
+        double value;
+        stream->itemIndices.clear();
+        for(size_t i=0; i<package.size(); ++i) {
+          // strings have no fixed size and are not mirrored
+          if(!getItemValue(package[i], &value)) continue;
+          stream->itemIndices.push_back((long)i);
+          names.push_back(package[i].getName());
+          types.push_back(package[i].type);
+        }
+        stream->packageSize = package.size();
+        stream->values.resize(names.size());
+        int ringSize = cfgRingSize.iValue > 0 ? cfgRingSize.iValue : 1;
+        return stream->shm.create(shmRegionName(stream->groupName,
+                                                stream->dataName),
+                                  names, types, ringSize);
+      }
+
+      bool DataBrokerShm::openPublished(Stream *stream) {
+        if(!stream->shm.open(shmRegionName(stream->groupName,
+                                           stream->dataName))) {
+          return false;
+        }
+        stream->package.clear();
+        for(unsigned int i=0; i<stream->shm.getNumItems(); ++i) {
+          addItem(&stream->package, stream->shm.getItemName(i),
+                  stream->shm.getItemType(i));
+        }
+        stream->values.resize(stream->shm.getNumItems());
+        stream->nextRead = stream->shm.getWriteCount();
+        stream->pushId = 0;
+        return true;
+      }
+
+      void DataBrokerShm::pushPublished(Stream *stream) {
+        uint64_t written = stream->shm.getWriteCount();
+        uint64_t ringSize = stream->shm.getRingSize();
+        // skip the frames that were already overwritten
+        if(written - stream->nextRead > ringSize) {
+          stream->nextRead = written - ringSize;
+        }
+        double time;
+        for(; stream->nextRead < written; ++stream->nextRead) {
+          if(!stream->shm.read(stream->nextRead, &time,
+                               stream->values.data())) continue;
+          for(size_t i=0; i<stream->values.size(); ++i) {
+            setItemValue(&stream->package[i], stream->values[i]);
+          }
+          if(stream->pushId) {
+            control->dataBroker->pushData(stream->pushId, stream->package, this);
+          }
+          else {
+            stream->pushId = control->dataBroker->pushData(stream->groupName,
+                                                           stream->dataName,
+                                                           stream->package,
+                                                           this,
+                                                           DATA_PACKAGE_READ_FLAG);
+          }
+        }
+      }
+
+      void DataBrokerShm::update(sReal time_ms) {
+        MutexLocker locker(&streamMutex);
+        bool tryOpen = (openCounter++ % openInterval == 0);
+        for(size_t i=0; i<publishStreams.size(); ++i) {
+          Stream *stream = publishStreams[i];
+          if(stream->shm.isOpen() && stream->shm.isClosed()) {
+            // the writer went away, wait for it to create a new region
+            stream->shm.close();
+          }
+          if(!stream->shm.isOpen()) {
+            if(!tryOpen || !openPublished(stream)) continue;
+          }
+          pushPublished(stream);
+        }
+      }
+
+      void DataBrokerShm::receiveData(const data_broker::DataInfo& info,
+                                      const data_broker::DataPackage& package,
+                                      int id) {
+        if(id == simTimeCallback) {
+          package.get(0, &simTime);
+          return;
+        }
+        MutexLocker locker(&streamMutex);
+        if(id < 0 || id >= (int)mirrorStreams.size()) return;
+        Stream *stream = mirrorStreams[id];
+        if(stream->failed) return;
+        if(!stream->shm.isOpen() || stream->packageSize != package.size()) {
+          if(!createMirror(stream, package)) {
+            fprintf(stderr, "DataBrokerShm: stop mirroring \"%s/%s\"\n",
+                    stream->groupName.c_str(), stream->dataName.c_str());
+            stream->failed = true;
+            return;
+          }
+        }
+        for(size_t i=0; i<stream->itemIndices.size(); ++i) {
+          getItemValue(package[stream->itemIndices[i]], &stream->values[i]);
+        }
+        stream->shm.write(simTime, stream->values.data());
+      }
+
+      void DataBrokerShm::cfgUpdateProperty(cfg_manager::cfgPropertyStruct _property) {
+
+        if(_property.paramId == cfgMirror.paramId) {
+          cfgMirror.sValue = _property.sValue;
+          setMirrorStreams(cfgMirror.sValue);
+        }
+        else if(_property.paramId == cfgPublish.paramId) {
+          cfgPublish.sValue = _property.sValue;
+          setPublishStreams(cfgPublish.sValue);
+        }
+        else if(_property.paramId == cfgRingSize.paramId) {
+          cfgRingSize.iValue = _property.iValue;
+        }
+      }
+
+    } // end of namespace data_broker_shm
+  } // end of namespace plugins
+} // end of namespace mars
+
+DESTROY_LIB(mars::plugins::data_broker_shm::DataBrokerShm);
+CREATE_LIB(mars::plugins::data_broker_shm::DataBrokerShm);
@@ -0,0 +1,124 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file DataBrokerShm.h
+ * \brief Mirrors DataBroker streams into POSIX shared memory and pushes
+ *        streams written by other processes into the DataBroker.
+ *
+ * The streams are selected with the cfg properties
+ * "DataBrokerShm/mirror" and "DataBrokerShm/publish". Both take a list of
+ * "groupName/dataName" entries separated by ';'. The group name is the part
+ * before the first '/', e.g. "mars_sim/Sensors/imu". See ShmStream for the
+ * client side.
+ */
+
+#ifndef MARS_PLUGINS_DATA_BROKER_SHM_H
+#define MARS_PLUGINS_DATA_BROKER_SHM_H
+
+#ifdef _PRINT_HEADER_
+  #warning "DataBrokerShm.h"
+#endif
+
+#include "ShmStream.h"
+
+#include <mars/interfaces/sim/MarsPluginTemplate.h>
+#include <mars/interfaces/MARSDefs.h>
+#include <mars/data_broker/ReceiverInterface.h>
+#include <mars/data_broker/DataPackage.h>
+#include <mars/cfg_manager/CFGManagerInterface.h>
+#include <mars/utils/Mutex.h>
+
+#include <string>
+#include <vector>
+
+namespace mars {
+
+  namespace plugins {
+    namespace data_broker_shm {
+
+      class DataBrokerShm: public mars::interfaces::MarsPluginTemplate,
+        public mars::data_broker::ReceiverInterface,
+        public mars::cfg_manager::CFGClient {
+
+      public:
+        DataBrokerShm(lib_manager::LibManager *theManager);
+        ~DataBrokerShm();
+
+        // LibInterface methods
+        int getLibVersion() const
+        { return 1; }
+        const std::string getLibName() const
+        { return std::string("data_broker_shm"); }
+        CREATE_MODULE_INFO();
+
+        // MarsPlugin methods
+        void init();
+        void reset();
+        void update(mars::interfaces::sReal time_ms);
+
+        // DataBrokerReceiver methods
+        virtual void receiveData(const data_broker::DataInfo &info,
+                                 const data_broker::DataPackage &package,
+                                 int callbackParam);
+        // CFGClient methods
+        virtual void cfgUpdateProperty(cfg_manager::cfgPropertyStruct _property);
+
+      private:
+        struct Stream {
+          std::string groupName, dataName;
+          ShmStream shm;
+          // package indices of the mirrored items
+          std::vector<long> itemIndices;
+          size_t packageSize;
+          std::vector<double> values;
+          data_broker::DataPackage package;
+          unsigned long pushId;
+          uint64_t nextRead;
+          // set if the region could not be created; the stream is not
+          // retried until the stream list is configured again
+          bool failed;
+        };
+
+        cfg_manager::cfgPropertyStruct cfgMirror, cfgPublish, cfgRingSize;
+        std::vector<Stream*> mirrorStreams, publishStreams;
+        // guards the stream lists against cfg changes from other threads
+        utils::Mutex streamMutex;
+        double simTime;
+        int openCounter;
+
+        void setMirrorStreams(const std::string &list);
+        void setPublishStreams(const std::string &list);
+        void clearMirrorStreams();
+        void clearPublishStreams();
+        void parseStreamList(const std::string &list,
+                             std::vector<Stream*> *streams);
+        bool createMirror(Stream *stream,
+                          const data_broker::DataPackage &package);
+        bool openPublished(Stream *stream);
+        void pushPublished(Stream *stream);
+
+      }; // end of class definition DataBrokerShm
+
+    } // end of namespace data_broker_shm
+  } // end of namespace plugins
+} // end of namespace mars
+
+#endif // MARS_PLUGINS_DATA_BROKER_SHM_H
@@ -0,0 +1,120 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file ShmLayout.h
+ * \brief Memory layout of a DataBroker stream mirrored into a POSIX
+ *        shared memory region.
+ *
+ * Every stream lives in its own region which is created by its single
+ * writer. The region starts with a ShmHeader, followed by numItems ShmItem
+ * descriptors and a ring of ringSize frames. A frame is a ShmFrame directly
+ * followed by numItems doubles. Each frame is guarded by its own sequence
+ * counter (seqlock): the writer makes the counter odd while it writes the
+ * frame, so readers never block the writer and simply retry or skip a frame
+ * that was modified while they copied it.
+ *
+ * The header only depends on the C++ standard library so that external
+ * tools can use it without the MARS headers.
+ */
+
+#ifndef MARS_PLUGINS_DATA_BROKER_SHM_LAYOUT_H
+#define MARS_PLUGINS_DATA_BROKER_SHM_LAYOUT_H
+
+#include <atomic>
+#include <cstddef>
+#include <stdint.h>
+#include <string>
+
+namespace mars {
+  namespace plugins {
+    namespace data_broker_shm {
+
+      const uint32_t SHM_MAGIC = 0x4d415253; // "MARS"
+      const uint32_t SHM_VERSION = 1;
+      const size_t SHM_ITEM_NAME_SIZE = 64;
+
+      struct ShmHeader {
+        // set last by the writer once the region is initialized
+        std::atomic<uint32_t> magic;
+        uint32_t version;
+        uint32_t numItems;
+        uint32_t ringSize;
+        uint64_t frameSize;
+        uint64_t regionSize;
+        // number of frames written so far
+        std::atomic<uint64_t> writeCount;
+        // set by the writer when it closes the region
+        std::atomic<uint32_t> closed;
+        uint32_t pad;
+      };
+
+      struct ShmItem {
+        char name[SHM_ITEM_NAME_SIZE];
+        // the data_broker::DataType of the mirrored DataItem
+        int32_t type;
+        uint32_t pad;
+      };
+
+      struct ShmFrame {
+        std::atomic<uint64_t> seq;
+        // the writeCount of the frame, used to detect overwritten frames
+        uint64_t count;
+        // simulation time in ms
+        double time;
+        double values[1];
+      };
+
+      inline uint64_t shmFrameSize(uint32_t numItems) {
+        return offsetof(ShmFrame, values) + sizeof(double)*(numItems ? numItems : 1);
+      }
+
+      inline uint64_t shmItemsOffset() {
+        return sizeof(ShmHeader);
+      }
+
+      inline uint64_t shmFramesOffset(uint32_t numItems) {
+        return shmItemsOffset() + sizeof(ShmItem)*numItems;
+      }
+
+      inline uint64_t shmRegionSize(uint32_t numItems, uint32_t ringSize) {
+        return shmFramesOffset(numItems) + shmFrameSize(numItems)*ringSize;
+      }
+
+      /**
+       * \brief Returns the shared memory name of a DataBroker stream.
+       *
+       * POSIX only allows one leading slash, so the slashes of the
+       * DataBroker names are replaced by dots.
+       */
+      inline std::string shmRegionName(const std::string &groupName,
+                                       const std::string &dataName) {
+        std::string name = "/mars." + groupName + "." + dataName;
+        for(size_t i=1; i<name.size(); ++i) {
+          if(name[i] == '/') name[i] = '.';
+        }
+        return name;
+      }
+
+    } // end of namespace data_broker_shm
+  } // end of namespace plugins
+} // end of namespace mars
+
+#endif // MARS_PLUGINS_DATA_BROKER_SHM_LAYOUT_H
@@ -0,0 +1,219 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ShmStream.h"
+
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace mars {
+  namespace plugins {
+    namespace data_broker_shm {
+
+      // give up on a frame that stays locked, e.g. if the writer died
+      static const int maxReadRetries = 1000;
+
+      ShmStream::ShmStream() : header(0), mappedSize(0), writer(false) {
+      }
+
+      ShmStream::~ShmStream() {
+        close();
+      }
+
+      bool ShmStream::create(const std::string &name_,
+                             const std::vector<std::string> &itemNames,
+                             const std::vector<int> &itemTypes,
+                             unsigned int ringSize) {
+        close();
+        if(itemNames.size() != itemTypes.size() || ringSize == 0) return false;
+        uint32_t numItems = (uint32_t)itemNames.size();
+        size_t size = shmRegionSize(numItems, ringSize);
+
+        shm_unlink(name_.c_str());
+        int fd = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if(fd == -1) {
+          fprintf(stderr, "ShmStream: could not create \"%s\"\n", name_.c_str());
+          return false;
+        }
+        if(ftruncate(fd, size) == -1) {
+          fprintf(stderr, "ShmStream: could not resize \"%s\"\n", name_.c_str());
+          ::close(fd);
+          shm_unlink(name_.c_str());
+          return false;
+        }
+        void *mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if(mem == MAP_FAILED) {
+          shm_unlink(name_.c_str());
+          return false;
+        }
+
+        // the new region is zero filled
+        header = new(mem) ShmHeader;
+        header->version = SHM_VERSION;
+        header->numItems = numItems;
+        header->ringSize = ringSize;
+        header->frameSize = shmFrameSize(numItems);
+        header->regionSize = size;
+        header->writeCount.store(0);
+        header->closed.store(0);
+        ShmItem *items = (ShmItem*)((char*)mem + shmItemsOffset());
+        for(uint32_t i=0; i<numItems; ++i) {
+          strncpy(items[i].name, itemNames[i].c_str(), SHM_ITEM_NAME_SIZE-1);
+          items[i].type = itemTypes[i];
+        }
+        name = name_;
+        mappedSize = size;
+        writer = true;
+        for(uint32_t i=0; i<ringSize; ++i) {
+          ShmFrame *frame = getFrame(i);
+          new(&frame->seq) std::atomic<uint64_t>(0);
+        }
+        header->magic.store(SHM_MAGIC, std::memory_order_release);
+        return true;
+      }
+
+      bool ShmStream::open(const std::string &name_) {
+        close();
+        int fd = shm_open(name_.c_str(), O_RDONLY, 0);
+        if(fd == -1) return false;
+        struct stat st;
+        if(fstat(fd, &st) == -1 || (size_t)st.st_size < sizeof(ShmHeader)) {
+          ::close(fd);
+          return false;
+        }
+        size_t size = st.st_size;
+        void *mem = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if(mem == MAP_FAILED) return false;
+
+        ShmHeader *h = (ShmHeader*)mem;
+        if(h->magic.load(std::memory_order_acquire) != SHM_MAGIC ||
+           h->version != SHM_VERSION || h->regionSize > size ||
+           shmRegionSize(h->numItems, h->ringSize) != h->regionSize) {
+          munmap(mem, size);
+          return false;
+        }
+        header = h;
+        name = name_;
+        mappedSize = size;
+        writer = false;
+        return true;
+      }
+
+      void ShmStream::close() {
+        if(!header) return;
+        if(writer) {
+          header->closed.store(1, std::memory_order_release);
+          shm_unlink(name.c_str());
+        }
+        munmap((void*)header, mappedSize);
+        header = 0;
+        mappedSize = 0;
+        writer = false;
+      }
+
+      bool ShmStream::isClosed() const {
+        return !header || header->closed.load(std::memory_order_acquire);
+      }
+
+      unsigned int ShmStream::getNumItems() const {
+        return header ? header->numItems : 0;
+      }
+
+      unsigned int ShmStream::getRingSize() const {
+        return header ? header->ringSize : 0;
+      }
+
+      std::string ShmStream::getItemName(unsigned int index) const {
+        if(!header || index >= header->numItems) return std::string();
+        const ShmItem *items = (const ShmItem*)((const char*)header + shmItemsOffset());
+        return std::string(items[index].name,
+                           strnlen(items[index].name, SHM_ITEM_NAME_SIZE));
+      }
+
+      int ShmStream::getItemType(unsigned int index) const {
+        if(!header || index >= header->numItems) return 0;
+        const ShmItem *items = (const ShmItem*)((const char*)header + shmItemsOffset());
+        return items[index].type;
+      }
+
+      uint64_t ShmStream::getWriteCount() const {
+        return header ? header->writeCount.load(std::memory_order_acquire) : 0;
+      }
+
+      ShmFrame* ShmStream::getFrame(uint64_t count) const {
+        return (ShmFrame*)((char*)header + shmFramesOffset(header->numItems) +
+                           header->frameSize*(count % header->ringSize));
+      }
+
+      void ShmStream::write(double time, const double *values) {
+        if(!header || !writer) return;
+        uint64_t count = header->writeCount.load(std::memory_order_relaxed);
+        ShmFrame *frame = getFrame(count);
+        uint64_t seq = frame->seq.load(std::memory_order_relaxed);
+        frame->seq.store(seq+1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        frame->count = count;
+        frame->time = time;
+        memcpy(frame->values, values, sizeof(double)*header->numItems);
+        frame->seq.store(seq+2, std::memory_order_release);
+        header->writeCount.store(count+1, std::memory_order_release);
+      }
+
+      bool ShmStream::read(uint64_t count, double *time, double *values) const {
+        if(!header) return false;
+        uint64_t written = header->writeCount.load(std::memory_order_acquire);
+        if(count >= written || written - count > header->ringSize) return false;
+        const ShmFrame *frame = getFrame(count);
+        for(int i=0; i<maxReadRetries; ++i) {
+          uint64_t seq = frame->seq.load(std::memory_order_acquire);
+          if(seq & 1) continue;
+          uint64_t frameCount = frame->count;
+          *time = frame->time;
+          memcpy(values, frame->values, sizeof(double)*header->numItems);
+          std::atomic_thread_fence(std::memory_order_acquire);
+          if(frame->seq.load(std::memory_order_relaxed) == seq) {
+            return (frameCount == count);
+          }
+        }
+        return false;
+      }
+
+      bool ShmStream::readLatest(double *time, double *values) const {
+        uint64_t written = getWriteCount();
+        while(written) {
+          if(read(written-1, time, values)) return true;
+          // the writer lapped us, try the new latest frame
+          uint64_t now = getWriteCount();
+          if(now == written) return false;
+          written = now;
+        }
+        return false;
+      }
+
+    } // end of namespace data_broker_shm
+  } // end of namespace plugins
+} // end of namespace mars
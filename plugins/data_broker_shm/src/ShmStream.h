@@ -0,0 +1,121 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file ShmStream.h
+ * \brief Client side access to a DataBroker stream in shared memory.
+ *
+ * The class is used by the DataBrokerShm plugin and by external processes.
+ * A stream has exactly one writer which creates the region. Any number of
+ * readers can open it. Readers never block the writer.
+ *
+ * Example of an external reader:
+ * \code
+ *   ShmStream stream;
+ *   if(stream.open(shmRegionName("mars_sim", "Sensors/imu"))) {
+ *     std::vector<double> values(stream.getNumItems());
+ *     uint64_t next = stream.getWriteCount();
+ *     double time;
+ *     while(!stream.isClosed()) {
+ *       for(; next < stream.getWriteCount(); ++next) {
+ *         if(stream.read(next, &time, values.data())) {
+ *           // handle sample
+ *         }
+ *       }
+ *     }
+ *   }
+ * \endcode
+ */
+
+#ifndef MARS_PLUGINS_DATA_BROKER_SHM_STREAM_H
+#define MARS_PLUGINS_DATA_BROKER_SHM_STREAM_H
+
+#include "ShmLayout.h"
+
+#include <string>
+#include <vector>
+
+namespace mars {
+  namespace plugins {
+    namespace data_broker_shm {
+
+      class ShmStream {
+      public:
+        ShmStream();
+        ~ShmStream();
+
+        /**
+         * \brief Creates the region \a name as its writer. An existing
+         *        region of the same name is replaced.
+         * \param itemNames The names of the values of a frame.
+         * \param itemTypes The data_broker::DataType of each value.
+         */
+        bool create(const std::string &name,
+                    const std::vector<std::string> &itemNames,
+                    const std::vector<int> &itemTypes,
+                    unsigned int ringSize);
+
+        /** \brief Opens the existing region \a name for reading. */
+        bool open(const std::string &name);
+
+        /** \brief Unmaps the region. The writer also removes it. */
+        void close();
+
+        bool isOpen() const {return header != 0;}
+        bool isWriter() const {return writer;}
+        /** \brief True if the writer closed the region after we opened it. */
+        bool isClosed() const;
+
+        const std::string& getName() const {return name;}
+        unsigned int getNumItems() const;
+        unsigned int getRingSize() const;
+        std::string getItemName(unsigned int index) const;
+        int getItemType(unsigned int index) const;
+
+        /** \brief Number of frames written so far. */
+        uint64_t getWriteCount() const;
+
+        /** \brief Appends a frame. Only allowed for the writer. */
+        void write(double time, const double *values);
+
+        /**
+         * \brief Copies the frame with the given write count.
+         * \return \c false if the frame was not written yet or was already
+         *         overwritten by the writer.
+         */
+        bool read(uint64_t count, double *time, double *values) const;
+
+        /** \brief Copies the last complete frame. */
+        bool readLatest(double *time, double *values) const;
+
+      private:
+        std::string name;
+        ShmHeader *header;
+        size_t mappedSize;
+        bool writer;
+
+        ShmFrame* getFrame(uint64_t count) const;
+      };
+
+    } // end of namespace data_broker_shm
+  } // end of namespace plugins
+} // end of namespace mars
+
+#endif // MARS_PLUGINS_DATA_BROKER_SHM_STREAM_H
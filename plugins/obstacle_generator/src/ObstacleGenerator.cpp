@@ -36,6 +36,9 @@
 #include <mars/interfaces/MaterialData.h>
 #include <mars/utils/Color.h>
 
+#include <sstream>
+#include <cstdlib>
+
 namespace mars {
   namespace plugins {
     namespace obstacle_generator {
@@ -46,6 +49,7 @@ namespace mars {
       ObstacleGenerator::ObstacleGenerator(lib_manager::LibManager *theManager)
         : MarsPluginTemplate(theManager, "ObstacleGenerator") {
         sigma = 0.001;
+        seed = 0;
       }
   
       void ObstacleGenerator::init() {
@@ -65,6 +69,9 @@ namespace mars {
         params["obstacle_number"] = 100.0;
         params["incline_angle"] = 0.0;
         params["ground_level"] = 0.0;
+        // 0 keeps the global random state, any other value makes the
+        // generated field reproducible
+        params["seed"] = 0.0;
         textures["ground"] = "moon_surface_small.jpg";
         textures["ground_bump"] = "";
         textures["ground_norm"] = "";
@@ -119,6 +126,55 @@ namespace mars {
           control->nodes->removeNode(*it);
         }
         oldNodeIDs.clear();
+        obstacleIDs.clear();
+        obstacleSpecs.clear();
+      }
+
+      void ObstacleGenerator::regenerateObstacleField(unsigned int newSeed) {
+        seed = newSeed;
+        if(seed) srand(seed);
+        std::vector<ObstacleSpec> specs;
+        generateObstacles(&specs);
+
+        bool inPlace = (specs.size() == obstacleSpecs.size() &&
+                        specs.size() == obstacleIDs.size());
+        for(size_t i=0; inPlace && i<specs.size(); ++i) {
+          inPlace = (specs[i].type == obstacleSpecs[i].type);
+        }
+        if(!inPlace) {
+          clearObstacleField();
+          createObstacleField();
+          return;
+        }
+
+        // only update what changed; static nodes don't need the joint
+        // handling of the generic editNode position path
+        for(size_t i=0; i<specs.size(); ++i) {
+          const ObstacleSpec &spec = specs[i];
+          const ObstacleSpec &old = obstacleSpecs[i];
+          if(spec.size != old.size) {
+            NodeData obstacle = control->nodes->getFullNode(obstacleIDs[i]);
+            obstacle.pos = spec.position;
+            obstacle.rot = spec.orientation;
+            obstacle.ext = spec.size;
+            control->nodes->editNode(&obstacle, EDIT_NODE_SIZE);
+          }
+          control->nodes->setPosition(obstacleIDs[i], spec.position);
+          if(spec.orientation.coeffs() != old.orientation.coeffs()) {
+            control->nodes->setRotation(obstacleIDs[i], spec.orientation);
+          }
+        }
+        obstacleSpecs.swap(specs);
+      }
+
+      bool ObstacleGenerator::fieldStructureChanged(const std::string &param) const {
+        // these parameters only move or resize the existing obstacles
+        return !(param == "seed" || param == "field_width" ||
+                 param == "field_length" || param == "field_distance" ||
+                 param.find("_obstacle_") != std::string::npos ||
+                 param == "incline_angle" || param == "ground_level") ||
+          bool_params.find("use_grid")->second ||
+          bool_params.find("support_platform")->second;
       }
 
 
@@ -209,14 +265,28 @@ namespace mars {
           oldNodeIDs.push_back(platform.index);
         }
         // create obstacles
+        seed = (unsigned int)params["seed"];
+        if(seed) srand(seed);
+        std::vector<ObstacleSpec> specs;
+        generateObstacles(&specs);
+        addObstacles(specs);
+      }
+
+      void ObstacleGenerator::generateObstacles(std::vector<ObstacleSpec> *specs) {
+        double obstacle_length = params["mean_obstacle_length"];
+        if (!bool_params["use_boxes"]) {obstacle_length = params["mean_obstacle_width"];}
+        double field_width = params["field_width"];
+        if (bool_params["use_grid"]) {
+            field_width = params["mean_obstacle_width"] * params["field_width"];
+        }
+        specs->clear();
         if (bool_params["use_grid"]) {
             params["obstacle_number"] = params["field_width"]*params["field_length"];
+            specs->reserve(static_cast<size_t>(params["obstacle_number"]));
             for (int w = 0; w < params["field_width"]; w++) {
                 for (int l = 0; l < params["field_length"]; l++) {
-                    std::string name = "obstacle_";
-                    std::string numstring = "";
-                    std::istringstream(numstring) >> l >>  w;
-                    name = name.append(numstring);
+                    std::stringstream name;
+                    name << "obstacle_" << l << "_" << w;
 
                     //create position
                     double pos_x = (0.5+l) * obstacle_length;
@@ -227,17 +297,17 @@ namespace mars {
                           params["min_obstacle_height"], params["max_obstacle_height"]);
 
                     //create obstacle
-                    createObstacle(name, pos_x, pos_y, params["mean_obstacle_width"], params["mean_obstacle_length"], height);
+                    specs->push_back(computeObstacle(name.str(), pos_x, pos_y, params["mean_obstacle_width"],
+                                                     params["mean_obstacle_length"], height));
                     }
                 }
         }
         else {
             int n = static_cast<int>(params["obstacle_number"]);
+            specs->reserve(n);
             for (int i = 0; i < n; i++) {
-              std::string name = "obstacle_";
-              std::string numstring = "";
-              std::istringstream(numstring) >> i;
-              name = name.append(numstring);
+              std::stringstream name;
+              name << "obstacle_" << i;
 
               //create position
               double pos_x = random_number(0, params["field_length"], 3);
@@ -252,12 +322,41 @@ namespace mars {
                                     params["min_obstacle_width"], params["max_obstacle_width"]);
 
               //create obstacle
-              createObstacle(name, pos_x, pos_y, radius, length, height);
+              specs->push_back(computeObstacle(name.str(), pos_x, pos_y, radius, length, height));
             }
         }
       }
 
-      void ObstacleGenerator::createObstacle(std::string name, double pos_x, double pos_y, double width, double length, double height) {
+      void ObstacleGenerator::addObstacles(const std::vector<ObstacleSpec> &specs) {
+        // every obstacle is still its own node with its own geom and
+        // drawable; only the regeneration reuses them
+        for(std::vector<ObstacleSpec>::const_iterator it=specs.begin();
+            it!=specs.end(); ++it) {
+           NodeData obstacle(it->name, it->position, it->orientation);
+           obstacle.initPrimitive(it->type, it->size, 1.0);
+           // the material keeps its default unique name, the graphics
+           // ignore a material with a known name and a rebuilt field
+           // would not pick up changed textures
+           obstacle.material.texturename = textures["obstacle"];
+           obstacle.material.diffuseFront = Color(1.0, 1.0, 1.0, 1.0);
+           if (textures["obstacle_bump"] != "") {
+             obstacle.material.bumpmap = textures["obstacle_bump"];
+           }
+           if (textures["obstacle_norm"] != "") {
+              obstacle.material.normalmap = textures["obstacle_norm"];
+           }
+           // static obstacles don't need to publish their pose
+           obstacle.map["noDataPackage"] = true;
+           NodeId id = control->nodes->addNode(&obstacle, false);
+           oldNodeIDs.push_back(id);
+           obstacleIDs.push_back(id);
+        }
+        obstacleSpecs.insert(obstacleSpecs.end(), specs.begin(), specs.end());
+      }
+
+      ObstacleSpec ObstacleGenerator::computeObstacle(const std::string &name, double pos_x,
+                                                      double pos_y, double width,
+                                                      double length, double height) {
           Quaternion orientation(1.0, 0.0, 0.0, 0.0);
           double pos_z=params["ground_level"];
           // NOTE: lots of geometrical problems related to rotation can be avoided if the object
@@ -313,23 +412,13 @@ namespace mars {
                    size[1] = 2*height-width;
                }
            }
-           NodeData obstacle(name, position, orientation);
-           if (bool_params["use_boxes"]) {
-               obstacle.initPrimitive(NODE_TYPE_BOX, size, 1.0);
-           }
-           else {
-               obstacle.initPrimitive(NODE_TYPE_CAPSULE, size, 1.0);
-           }
-           obstacle.material.texturename = textures["obstacle"];
-           obstacle.material.diffuseFront = Color(1.0, 1.0, 1.0, 1.0);
-           if (textures["obstacle_bump"] != "") {
-             obstacle.material.bumpmap = textures["obstacle_bump"];
-           }
-           if (textures["obstacle_bump"] != "") {
-              obstacle.material.normalmap = textures["obstacle_norm"];
-           }
-           control->nodes->addNode(&obstacle, false);
-           oldNodeIDs.push_back(obstacle.index);
+           ObstacleSpec spec;
+           spec.name = name;
+           spec.type = bool_params["use_boxes"] ? NODE_TYPE_BOX : NODE_TYPE_CAPSULE;
+           spec.position = position;
+           spec.orientation = orientation;
+           spec.size = size;
+           return spec;
       }
 
       ObstacleGenerator::~ObstacleGenerator() {
@@ -362,8 +451,15 @@ namespace mars {
             bool_params[bool_paramIds[_property.paramId]] = _property.bValue;
             break;
         }
-        clearObstacleField();
-        createObstacleField();
+        std::string param = (_property.propertyType == cfg_manager::boolProperty) ?
+          bool_paramIds[_property.paramId] : paramIds[_property.paramId];
+        if(fieldStructureChanged(param)) {
+          clearObstacleField();
+          createObstacleField();
+        }
+        else {
+          regenerateObstacleField((unsigned int)params["seed"]);
+        }
       }
 
     } // end of namespace obstacle_generator
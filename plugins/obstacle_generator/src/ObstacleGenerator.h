@@ -39,9 +39,12 @@
 #include <mars/data_broker/ReceiverInterface.h>
 #include <mars/cfg_manager/CFGManagerInterface.h>
 #include <mars/interfaces/MARSDefs.h>
+#include <mars/utils/Vector.h>
+#include <mars/utils/Quaternion.h>
 //#include <mars/common/utils/Vector.h> //we need this for positioning of the obstacle field
 
 #include <string>
+#include <vector>
 #include <math.h>
 
 namespace mars {
@@ -53,6 +56,20 @@ namespace mars {
   namespace plugins {
     namespace obstacle_generator {
 
+      /**
+       * Geometry of one generated obstacle. The obstacle field is first
+       * generated as a list of these and then either added to the
+       * simulation as one node per obstacle or applied to the existing
+       * obstacle nodes.
+       */
+      struct ObstacleSpec {
+        std::string name;
+        mars::interfaces::NodeType type;
+        mars::utils::Vector position;
+        mars::utils::Quaternion orientation;
+        mars::utils::Vector size;
+      };
+
       // inherit from MarsPluginTemplateGUI for extending the gui
       class ObstacleGenerator: public mars::interfaces::MarsPluginTemplate,
         public mars::data_broker::ReceiverInterface,
@@ -71,11 +88,23 @@ namespace mars {
 
         // MarsPlugin methods
         void init();
+        /** Moves the existing obstacles to new random positions. */
         void reset();
         void update(mars::interfaces::sReal time_ms);
+        /**
+         * Creates the platforms and obstacles. Each obstacle is added as
+         * its own static node with NodeManager::addNode; there is no bulk,
+         * compound or instanced creation path.
+         */
         void createObstacleField();
         void clearObstacleField();
-        void createObstacle(std::string name, double pos_x, double pos_y, double width, double length, double height);
+        /**
+         * Regenerates the obstacles from the given seed when a property
+         * changed. If the structure of the field (number and type of
+         * obstacles) did not change, the existing obstacle nodes are moved
+         * and resized in place instead of being removed and recreated.
+         */
+        void regenerateObstacleField(unsigned int seed);
 
         // DataBrokerReceiver methods
         virtual void receiveData(const data_broker::DataInfo &info,
@@ -90,6 +119,17 @@ namespace mars {
         // ObstacleGenerator methods
 
       private:
+        ObstacleSpec computeObstacle(const std::string &name, double pos_x,
+                                     double pos_y, double width,
+                                     double length, double height);
+        void generateObstacles(std::vector<ObstacleSpec> *specs);
+        void addObstacles(const std::vector<ObstacleSpec> &specs);
+        bool fieldStructureChanged(const std::string &param) const;
+
+        std::vector<mars::interfaces::NodeId> obstacleIDs;
+        std::vector<ObstacleSpec> obstacleSpecs;
+        unsigned int seed;
+
         std::map<std::string, double> params;
         std::map<cfg_manager::cfgParamId, std::string> paramIds;
         std::vector<mars::interfaces::NodeId> oldNodeIDs;
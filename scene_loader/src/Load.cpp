@@ -19,7 +19,6 @@
  */
 
 #include "Load.h"
-#include "zipit.h"
 
 
 #include <QtXml>
@@ -38,6 +37,7 @@
 #include <mars/interfaces/sim/EntityManagerInterface.h>
 #include <mars/interfaces/sim/LoadSceneInterface.h>
 #include <mars/utils/misc.h>
+#include <mars/utils/SceneArchive.h>
 #include <mars/interfaces/Logging.hpp>
 
 //#define DEBUG_PARSE 1
@@ -76,9 +76,11 @@ namespace mars {
         control->entities->addEntity(mRobotName);
       }
 
-      // need to unzip into a temporary directory
+      // the archive is mounted at the temporary directory, so its files
+      // are read in place by the loaders instead of being extracted
       if (mFileSuffix == ".scn" || mFileSuffix == ".zip") {
-        if(unzip(tmpPath, mFileName) == 0)
+        LOG_INFO("Load: mounting scene archive: %s", mFileName.c_str());
+        if(!utils::SceneArchive::mount(mFileName, tmpPath))
           return 0;
       }
       else {
@@ -105,18 +107,6 @@ namespace mars {
       return 1;
     }
 
-    unsigned int Load::unzip(const std::string& destinationDir,
-                             const std::string& zipFilename) {
-      if(!utils::createDirectory(destinationDir)) return 0;
-
-      Zipit myZipFile(zipFilename);
-      LOG_INFO("Load: unzipping scene: %s", zipFilename.c_str());
-
-      if (!myZipFile.unpackWholeZipTo(destinationDir)) return 0;
-
-      return 1;
-    }
-
     unsigned int Load::parseScene() {
       if(useYAML) return parseYamlScene();
 
@@ -126,15 +116,13 @@ namespace mars {
       QString xmlErrorMsg="";
       int xmlErrorLine, xmlErrorCol =0;
 
-      //creating a handle for the xmlfile
-      QFile file(sceneFilename.c_str());
-
       QLocale::setDefault(QLocale::C);
 
       LOG_INFO("Load: loading scene: %s", sceneFilename.c_str());
 
-      //test to open the xmlfile
-      if (!file.open(QIODevice::ReadOnly)) {
+      //read the xmlfile from the scene archive or the file system
+      std::string content;
+      if (!utils::SceneArchive::readMountedFile(sceneFilename, &content)) {
         std::cout<<"Error while opening scene file content "
                  << sceneFilename << " in Load.cpp->parseScene"
                  << std::endl;
@@ -146,9 +134,8 @@ namespace mars {
 
       //test to pass the content from the xmlfile to the DOM-Object
       QDomDocument doc;
-      if (!doc.setContent(&file, false, &xmlErrorMsg,
-                          &xmlErrorLine, &xmlErrorCol)) {
-        file.close();
+      if (!doc.setContent(QByteArray(content.data(), (int)content.size()),
+                          false, &xmlErrorMsg, &xmlErrorLine, &xmlErrorCol)) {
         std::cout<<"error passing the file content in->Load.cpp->parseScene"
                  <<std::endl;
         std::cout<<"Message: "<<xmlErrorMsg.toStdString()<<"\n"<<"Line: "
@@ -220,8 +207,6 @@ namespace mars {
         getGenericConfig(&graphicList, xmlnodelist.at(0).toElement());
       }
 
-      file.close();
-
       return 1;
     }
 
@@ -517,36 +502,19 @@ namespace mars {
     }
 
     void Load::checkEncodings(){
-        bool existing = true;
-        QString str("<xml><easter_egg>3.1418</easter_egg></xml>");
-        QString tmpFilename = QString(tmpPath.c_str()) + QString("mars-encoding-check");
-        QFile tmpFile(tmpFilename);
-        if(!QFile::exists(tmpFilename)){
-            tmpFile.open(QIODevice::WriteOnly);
-            QTextStream out(&tmpFile);
-            out << str;
-            tmpFile.close();
-            existing = false;
-        }
-        if(!tmpFile.open(QIODevice::ReadOnly)){
-            LOG_FATAL("Cannot open language checking file\n");
-            exit(-1);
-        }
+        // the scene may be read from an archive, so the check does not
+        // write into the temporary directory
+        QByteArray str("<xml><easter_egg>3.1418</easter_egg></xml>");
         QDomDocument doc;
-        if(!doc.setContent(&tmpFile, false)){
-            LOG_FATAL("Cannot parse language checking file\n");
+        if(!doc.setContent(str, false)){
+            LOG_FATAL("Cannot parse language checking document\n");
             exit(-2);
         }
         QDomElement root = doc.documentElement();
-        QDomElement tmpElement;
         if(root.elementsByTagName(QString("easter_egg")).at(0).toElement().text().toDouble() != 3.1418){
             LOG_ERROR("Encoding of the system is invalid, therefore Scene loading will fail quitting here to prevent errors later");
             exit(-3);
         }
-        tmpFile.close();
-        if(!existing){
-           tmpFile.remove();
-        }
     }
 
   } // end of namespace scene_loader
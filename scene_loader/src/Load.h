@@ -68,9 +68,6 @@ namespace mars {
       unsigned long groupIDOffset;
       bool useYAML;
 
-      unsigned int unzip(const std::string& destinationDir,
-                         const std::string& zipFilename);
-
       void getGenericConfig(std::vector<configmaps::ConfigMap> *configList,
                             const QDomElement &elementNode);
       void getGenericConfig(configmaps::ConfigMap *config,
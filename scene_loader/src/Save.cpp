@@ -228,6 +228,8 @@ namespace mars {
           utils::removeFilenamePrefix(&s_filename);
           v_filenames.push_back(s_filename);
         }
+        // files of a scene loaded from an archive are only mounted at
+        // the temporary path, addToZip reads them from the archive
         if (zipfile.addToZip(v_filenames, v_fullfilenames)!=0) {
           return 0;
         }
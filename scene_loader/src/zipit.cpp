@@ -21,6 +21,7 @@
 #include "zipit.h"
 
 #include <mars/utils/misc.h>
+#include <mars/utils/SceneArchive.h>
 #include <mars/interfaces/sim/ControlCenter.h>
 #include <mars/interfaces/Logging.hpp>
 
@@ -97,6 +98,8 @@ namespace mars {
      * addToZip(string fileNameToZip, bool zipWithFolders, vector<string> listOfFiles)
      * adds all the files in vector<string> listOfFiles to the zipfile
      * after this, it closes the zipfilehandle
+     * Files of a mounted scene archive (see utils::SceneArchive) are not on
+     * disk and are written from memory.
      */
     int Zipit::addToZip(const vector<string> &listOfFiles,
                         const vector<string> &sourceListOfFiles) {
@@ -115,45 +118,40 @@ namespace mars {
           zipError(ZIPIT_FILE_IN_ZIP_CREATION_ERR);
           return 1;
         }
-        std::ifstream inFile;
-        inFile.open(sourceListOfFiles[i].c_str(),
-                    std::ios::out|std::ios::binary);
-        if (!inFile.is_open()) {
-          closeZipHandle();
-          remove(zipFileName.c_str());
-          zipError(ZIPIT_NO_HANDLE_FOR_FILE);
-          return 1;
-        }
-        //bestimmen der groese der Datei
-        inFile.seekg(0, std::ios::end);
-        int fileLength = inFile.tellg();
-        inFile.seekg(0, std::ios::beg);
-        //neuen speicher holen
-        char *pBuffer = new char[fileLength];//sollte das speicher holen nicht funktionieren, wird abgebrochen
-        if (pBuffer==NULL) {
-          zipError(ZIPIT_NO_BUFFER);
-          zipCloseFileInZip(zipHandle);
-          delete[] pBuffer;
-          closeZipHandle();
-          remove(zipFileName.c_str());
-          return 1;
+        const char *data = NULL;
+        size_t size = 0;
+        std::vector<char> buffer;
+        if (!utils::SceneArchive::getMountedFile(sourceListOfFiles[i], &data,
+                                                 &size, &buffer)) {
+          std::ifstream inFile;
+          inFile.open(sourceListOfFiles[i].c_str(),
+                      std::ios::in|std::ios::binary);
+          if (!inFile.is_open()) {
+            zipCloseFileInZip(zipHandle);
+            closeZipHandle();
+            remove(zipFileName.c_str());
+            zipError(ZIPIT_NO_HANDLE_FOR_FILE);
+            return 1;
+          }
+          //bestimmen der groese der Datei
+          inFile.seekg(0, std::ios::end);
+          size = inFile.tellg();
+          inFile.seekg(0, std::ios::beg);
+          //die gesammte datei wird in den speicher gelesen
+          buffer.resize(size);
+          if (size) inFile.read(&buffer[0], size);
+          inFile.close();
+          data = buffer.empty() ? NULL : &buffer[0];
         }
-        //wenn es funktioniert haben sollte, wird die datei gelesen
-        //hier noch die jeweiligen fehler abfangen
-        inFile.read(pBuffer, fileLength); //die gesammte datei wird in den speicher gelesen.
-        zipitError=zipWriteInFileInZip(zipHandle, pBuffer, fileLength);//der inhalt des Speichers wird in die Datei im Zip geschrieben
+        zipitError=zipWriteInFileInZip(zipHandle, data, size);//der inhalt des Speichers wird in die Datei im Zip geschrieben
         if (zipitError!=ZIP_OK) {
           zipError(ZIPIT_FILE_NOT_WROTE_IN_ZIP);
           zipCloseFileInZip(zipHandle);
-          delete[] pBuffer;
-          inFile.close();
           closeZipHandle();
           remove(zipFileName.c_str());
           return 1;
         }
         zipCloseFileInZip(zipHandle);
-        delete[] pBuffer;
-        inFile.close();
       }
       closeZipHandle();
       return 0;
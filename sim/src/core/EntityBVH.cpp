@@ -0,0 +1,207 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "EntityBVH.h"
+
+#include <algorithm>
+#include <float.h>
+
+namespace mars {
+  namespace sim {
+
+    using namespace utils;
+
+    // leaves hold up to this many boxes
+    static const int maxLeafSize = 4;
+    // rebuild the tree if refitting grew the root volume by this factor
+    static const double maxRefitGrowth = 4.0;
+
+    EntityBVH::Box::Box() : min(DBL_MAX, DBL_MAX, DBL_MAX),
+                            max(-DBL_MAX, -DBL_MAX, -DBL_MAX) {
+    }
+
+    EntityBVH::Box::Box(const Vector &min, const Vector &max) :
+      min(min), max(max) {
+    }
+
+    bool EntityBVH::Box::isEmpty() const {
+      return (min.x() > max.x() || min.y() > max.y() || min.z() > max.z());
+    }
+
+    void EntityBVH::Box::expand(const Box &other) {
+      if(other.isEmpty()) return;
+      min = min.cwiseMin(other.min);
+      max = max.cwiseMax(other.max);
+    }
+
+    double EntityBVH::Box::volume() const {
+      if(isEmpty()) return 0.0;
+      Vector d = max - min;
+      return d.x()*d.y()*d.z();
+    }
+
+    EntityBVH::EntityBVH() : builtVolume(0.0) {
+    }
+
+    void EntityBVH::clear() {
+      nodes.clear();
+      items.clear();
+      ids.clear();
+      order.clear();
+      builtVolume = 0.0;
+    }
+
+    void EntityBVH::build(const std::vector<unsigned long> &ids_,
+                          const std::vector<Box> &boxes) {
+      clear();
+      ids = ids_;
+      items = boxes;
+      order.resize(items.size());
+      for(size_t i=0; i<order.size(); ++i) order[i] = (int)i;
+      if(items.empty()) return;
+      nodes.reserve(2*items.size()/maxLeafSize + 1);
+      buildNode(0, (int)items.size());
+      builtVolume = nodes[0].box.volume();
+    }
+
+    int EntityBVH::buildNode(int first, int count) {
+      int index = (int)nodes.size();
+      nodes.push_back(Node());
+      Box box, centers;
+      for(int i=first; i<first+count; ++i) {
+        const Box &b = items[order[i]];
+        box.expand(b);
+        if(!b.isEmpty()) {
+          Vector c = (b.min + b.max)*0.5;
+          centers.expand(Box(c, c));
+        }
+      }
+      nodes[index].box = box;
+      nodes[index].left = nodes[index].right = -1;
+      nodes[index].first = first;
+      nodes[index].count = count;
+      if(count <= maxLeafSize || centers.isEmpty()) return index;
+
+      // split at the median of the box centers along the longest axis
+      Vector d = centers.max - centers.min;
+      int axis = 0;
+      if(d.y() > d[axis]) axis = 1;
+      if(d.z() > d[axis]) axis = 2;
+      int half = count/2;
+      std::nth_element(order.begin()+first, order.begin()+first+half,
+                       order.begin()+first+count,
+                       [this, axis](int a, int b) {
+                         return (items[a].min[axis] + items[a].max[axis] <
+                                 items[b].min[axis] + items[b].max[axis]);
+                       });
+      int left = buildNode(first, half);
+      int right = buildNode(first+half, count-half);
+      nodes[index].left = left;
+      nodes[index].right = right;
+      nodes[index].count = 0;
+      return index;
+    }
+
+    bool EntityBVH::refit(const std::vector<Box> &boxes) {
+      if(boxes.size() != items.size()) return false;
+      items = boxes;
+      refitNodes();
+      if(nodes.empty()) return true;
+      double v = nodes[0].box.volume();
+      if(builtVolume > 0.0 && v > builtVolume*maxRefitGrowth) return false;
+      return true;
+    }
+
+    void EntityBVH::refitNodes() {
+      // children are always stored behind their parent
+      for(int n=(int)nodes.size()-1; n>=0; --n) {
+        Node &node = nodes[n];
+        node.box = Box();
+        if(node.count) {
+          for(int i=node.first; i<node.first+node.count; ++i) {
+            node.box.expand(items[order[i]]);
+          }
+        }
+        else {
+          node.box.expand(nodes[node.left].box);
+          node.box.expand(nodes[node.right].box);
+        }
+      }
+    }
+
+    template <typename Test>
+    void EntityBVH::query(const Test &test,
+                          std::vector<unsigned long> *result) const {
+      if(nodes.empty()) return;
+      int stack[64];
+      int top = 0;
+      stack[top++] = 0;
+      while(top) {
+        const Node &node = nodes[stack[--top]];
+        if(node.box.isEmpty() || !test(node.box)) continue;
+        if(node.count) {
+          for(int i=node.first; i<node.first+node.count; ++i) {
+            const Box &b = items[order[i]];
+            if(!b.isEmpty() && test(b)) result->push_back(ids[order[i]]);
+          }
+        }
+        else {
+          stack[top++] = node.left;
+          stack[top++] = node.right;
+        }
+      }
+    }
+
+    void EntityBVH::queryBox(const Box &box,
+                             std::vector<unsigned long> *result) const {
+      query([&box](const Box &b) {
+          return (b.min.x() <= box.max.x() && b.max.x() >= box.min.x() &&
+                  b.min.y() <= box.max.y() && b.max.y() >= box.min.y() &&
+                  b.min.z() <= box.max.z() && b.max.z() >= box.min.z());
+        }, result);
+    }
+
+    void EntityBVH::querySphere(const Vector &center, double radius,
+                                std::vector<unsigned long> *result) const {
+      double r2 = radius*radius;
+      query([&center, r2](const Box &b) {
+          Vector closest = center.cwiseMax(b.min).cwiseMin(b.max);
+          return (closest - center).squaredNorm() <= r2;
+        }, result);
+    }
+
+    void EntityBVH::queryFrustum(const std::vector<Plane> &planes,
+                                 std::vector<unsigned long> *result) const {
+      query([&planes](const Box &b) {
+          // a box is outside if its corner furthest along the plane
+          // normal lies behind one of the planes
+          for(size_t i=0; i<planes.size(); ++i) {
+            const Vector &n = planes[i].normal;
+            Vector p((n.x() >= 0) ? b.max.x() : b.min.x(),
+                     (n.y() >= 0) ? b.max.y() : b.min.y(),
+                     (n.z() >= 0) ? b.max.z() : b.min.z());
+            if(n.dot(p - planes[i].point) < 0) return false;
+          }
+          return true;
+        }, result);
+    }
+
+  } // end of namespace sim
+} // end of namespace mars
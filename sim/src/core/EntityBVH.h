@@ -0,0 +1,101 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file EntityBVH.h
+ * \brief A bounding volume hierarchy over axis aligned boxes used by the
+ *        EntityManager for spatial queries.
+ *
+ * The tree is built once for a set of boxes and afterwards only refitted
+ * when the boxes move. It is rebuilt if the set of boxes changes or if the
+ * refitted tree degenerated too much.
+ */
+
+#ifndef MARS_SIM_ENTITY_BVH_H
+#define MARS_SIM_ENTITY_BVH_H
+
+#include <mars/utils/Vector.h>
+#include <mars/utils/Geometry.hpp>
+
+#include <vector>
+
+namespace mars {
+  namespace sim {
+
+    class EntityBVH {
+    public:
+      struct Box {
+        Box();
+        Box(const utils::Vector &min, const utils::Vector &max);
+        bool isEmpty() const;
+        void expand(const Box &other);
+        double volume() const;
+
+        utils::Vector min;
+        utils::Vector max;
+      };
+
+      EntityBVH();
+
+      /** Rebuilds the tree. ids[i] is reported for boxes[i] by the queries. */
+      void build(const std::vector<unsigned long> &ids,
+                 const std::vector<Box> &boxes);
+
+      /**
+       * Updates the boxes of the items, given in the order of the last build,
+       * and refits the inner nodes. Returns false if the tree degenerated and
+       * should be rebuilt.
+       */
+      bool refit(const std::vector<Box> &boxes);
+
+      void clear();
+      size_t size() const {return items.size();}
+
+      void queryBox(const Box &box, std::vector<unsigned long> *result) const;
+      void querySphere(const utils::Vector &center, double radius,
+                       std::vector<unsigned long> *result) const;
+      /** The plane normals have to point to the inside of the frustum. */
+      void queryFrustum(const std::vector<utils::Plane> &planes,
+                        std::vector<unsigned long> *result) const;
+
+    private:
+      struct Node {
+        Box box;
+        int left, right;
+        // leaves reference count items starting at first in order
+        int first, count;
+      };
+
+      std::vector<Node> nodes;
+      std::vector<Box> items;
+      std::vector<unsigned long> ids;
+      std::vector<int> order;
+      double builtVolume;
+
+      int buildNode(int first, int count);
+      void refitNodes();
+      template <typename Test>
+      void query(const Test &test, std::vector<unsigned long> *result) const;
+    };
+
+  } // end of namespace sim
+} // end of namespace mars
+
+#endif // MARS_SIM_ENTITY_BVH_H
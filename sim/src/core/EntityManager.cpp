@@ -23,6 +23,7 @@
 #include <configmaps/ConfigData.h>
 #include <mars/interfaces/graphics/GraphicsManagerInterface.h>
 #include <mars/interfaces/sim/EntitySubscriberInterface.h>
+#include <mars/interfaces/sim/SimulatorInterface.h>
 #include <mars/utils/MutexLocker.h>
 #include <mars/utils/misc.h>
 
@@ -39,6 +40,7 @@ namespace mars {
 
       control = c;
       next_entity_id = 1;
+      boundsDirty = bvhStructureDirty = true;
       if (control->graphics)
         control->graphics->addEventClient((GraphicsEventClient*) this);
     }
@@ -47,6 +49,7 @@ namespace mars {
       unsigned long id = 0;
       MutexLocker locker(&iMutex);
       entities[id = getNextId()] = new SimEntity(control, name);
+      bvhStructureDirty = true;
       notifySubscribers(entities[id]);
       return id;
     }
@@ -55,6 +58,7 @@ namespace mars {
       unsigned long id = 0;
       MutexLocker locker(&iMutex);
       entities[id = getNextId()] = entity;
+      bvhStructureDirty = true;
       notifySubscribers(entity);
       return id;
     }
@@ -68,6 +72,7 @@ namespace mars {
         for (auto it = entities.begin(); it != entities.end(); ++it) {
           if (it->second == entity) {
             entities.erase(it);
+            bvhStructureDirty = true;
             break;
           }
         }
@@ -102,6 +107,7 @@ namespace mars {
           if (it->second == p) {
             fprintf(stderr, "Deleting entity %s\n", p->getName().c_str());
             entities.erase(it);
+            bvhStructureDirty = true;
             break;
           }
         }
@@ -138,6 +144,7 @@ namespace mars {
       }
       if (entity) {
         MutexLocker locker(&iMutex);
+        boundsDirty = true;
         entity->addNode(nodeId, nodeName);
       }
     }
@@ -390,5 +397,91 @@ namespace mars {
       }
     }
 
+    void EntityManager::invalidateBoundingVolumes() {
+      boundsDirty = true;
+    }
+
+    /**updates the cached entity bounding boxes and the bvh over them; has to
+     * be called with iMutex locked
+     */
+    void EntityManager::updateBoundingVolumes() {
+      // cleared before the boxes are read, so nodes moved meanwhile mark
+      // them outdated again
+      bool dirty = boundsDirty.exchange(false);
+      if(!dirty && !bvhStructureDirty) return;
+
+      std::vector<EntityBVH::Box> boxes;
+      boxes.reserve(entities.size());
+      if(bvhStructureDirty) {
+        bvhIds.clear();
+        entityBounds.clear();
+        for(auto iter: entities) bvhIds.push_back(iter.first);
+      }
+      for(size_t i=0; i<bvhIds.size(); ++i) {
+        EntityBounds &b = entityBounds[bvhIds[i]];
+        entities[bvhIds[i]]->getBoundingBox(b.center, b.rotation, b.extent);
+        if(b.extent.minCoeff() < 0) {
+          // entity without nodes
+          boxes.push_back(EntityBVH::Box());
+          continue;
+        }
+        // world aligned box around the oriented box
+        Vector half = (b.rotation.toRotationMatrix().cwiseAbs() * b.extent)*0.5;
+        boxes.push_back(EntityBVH::Box(b.center - half, b.center + half));
+      }
+      if(bvhStructureDirty || !bvh.refit(boxes)) {
+        bvh.build(bvhIds, boxes);
+      }
+      bvhStructureDirty = false;
+    }
+
+    void EntityManager::getEntitiesInBox(const Vector &min, const Vector &max,
+                                         std::vector<unsigned long> *ids) {
+      MutexLocker locker(&iMutex);
+      updateBoundingVolumes();
+      bvh.queryBox(EntityBVH::Box(min, max), ids);
+    }
+
+    void EntityManager::getEntitiesInSphere(const Vector &center, double radius,
+                                            std::vector<unsigned long> *ids) {
+      MutexLocker locker(&iMutex);
+      updateBoundingVolumes();
+      bvh.querySphere(center, radius, ids);
+    }
+
+    void EntityManager::getEntitiesInFrustum(const std::vector<Plane> &planes,
+                                             std::vector<unsigned long> *ids) {
+      MutexLocker locker(&iMutex);
+      updateBoundingVolumes();
+      bvh.queryFrustum(planes, ids);
+    }
+
+    bool EntityManager::getEntityBoundingBox(unsigned long id,
+                                             std::vector<Vector> *vertices,
+                                             Vector *center) {
+      MutexLocker locker(&iMutex);
+      updateBoundingVolumes();
+      std::map<unsigned long, EntityBounds>::const_iterator it = entityBounds.find(id);
+      if(it == entityBounds.end()) return false;
+      const EntityBounds &b = it->second;
+      const Vector &e = b.extent;
+      Vector corners[8] = {
+        e,
+        Vector(-e.x(), e.y(), e.z()),
+        Vector(e.x(), -e.y(), e.z()),
+        Vector(e.x(), e.y(), -e.z()),
+        -e,
+        Vector(e.x(), -e.y(), -e.z()),
+        Vector(-e.x(), e.y(), -e.z()),
+        Vector(-e.x(), -e.y(), e.z())
+      };
+      vertices->clear();
+      for(int i=0; i<8; ++i) {
+        vertices->push_back(b.rotation * (corners[i]*0.5) + b.center);
+      }
+      *center = b.center;
+      return true;
+    }
+
   } // end of namespace sim
 } // end of namespace mars
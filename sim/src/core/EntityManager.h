@@ -37,11 +37,14 @@
 #define ENTITY_MANAGER_H
 
 #include <map>
+#include <atomic>
 #include <mars/interfaces/sim/ControlCenter.h>
 #include <mars/interfaces/graphics/GraphicsEventClient.h>
 #include <mars/interfaces/sim/EntityManagerInterface.h>
 #include <mars/utils/Mutex.h>
 #include <configmaps/ConfigData.h>
+#include <mars/utils/Quaternion.h>
+#include "EntityBVH.h"
 
 namespace mars {
   namespace sim {
@@ -131,6 +134,16 @@ namespace mars {
       virtual unsigned long getEntityJoint(const std::string &entityName,
           const std::string &jointName);
 
+      virtual void getEntitiesInBox(const utils::Vector &min, const utils::Vector &max,
+                                    std::vector<unsigned long> *ids);
+      virtual void getEntitiesInSphere(const utils::Vector &center, double radius,
+                                       std::vector<unsigned long> *ids);
+      virtual void getEntitiesInFrustum(const std::vector<utils::Plane> &planes,
+                                        std::vector<unsigned long> *ids);
+      virtual bool getEntityBoundingBox(unsigned long id, std::vector<utils::Vector> *vertices,
+                                        utils::Vector *center);
+      virtual void invalidateBoundingVolumes();
+
       //from graphics event client
       virtual void selectEvent(unsigned long id, bool mode);
 
@@ -156,6 +169,24 @@ namespace mars {
       // a mutex for the sensor containers
       mutable utils::Mutex iMutex;
 
+      /**oriented bounding box of an entity as returned by
+       * SimEntity::getBoundingBox*/
+      struct EntityBounds {
+        utils::Vector center;
+        utils::Quaternion rotation;
+        utils::Vector extent;
+      };
+
+      // bounding volumes of the entities, they are updated on the first
+      // query after a step or node edit and rebuilt if entities were added
+      // or removed; boundsDirty is set by the NodeManager without iMutex
+      EntityBVH bvh;
+      std::vector<unsigned long> bvhIds;
+      std::map<unsigned long, EntityBounds> entityBounds;
+      std::atomic<bool> boundsDirty;
+      bool bvhStructureDirty;
+      void updateBoundingVolumes();
+
     };
 
   } // end of namespace sim
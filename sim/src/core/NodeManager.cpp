@@ -33,6 +33,7 @@
 
 #include <mars/interfaces/sim/LoadCenter.h>
 #include <mars/interfaces/sim/SimulatorInterface.h>
+#include <mars/interfaces/sim/EntityManagerInterface.h>
 #include <mars/interfaces/graphics/GraphicsManagerInterface.h>
 #include <mars/interfaces/terrainStruct.h>
 #include <mars/interfaces/Logging.hpp>
@@ -704,6 +705,7 @@ namespace mars {
         }
         tmpNode.reset();
       }
+      invalidateEntityBounds();
       control->sim->sceneHasChanged(false);
     }
 
@@ -715,6 +717,7 @@ namespace mars {
       NodeMap::iterator iter = simNodes.find(id);
       if (iter != simNodes.end())
         iter->second->setPhysicalState(state);
+      invalidateEntityBounds();
     }
 
     /**
@@ -757,6 +760,7 @@ namespace mars {
         iter->second->setPosition(pos, 1);
         nodesToUpdate[id] = iter->second;
       }
+      invalidateEntityBounds();
     }
 
 
@@ -779,6 +783,16 @@ namespace mars {
       return q;
     }
 
+    bool NodeManager::getNodeBounds(NodeId id, Vector *pos, Quaternion *rot,
+                                    Vector *ext) const {
+      MutexLocker locker(&iMutex);
+      NodeMap::const_iterator iter = simNodes.find(id);
+      if (iter == simNodes.end())
+        return false;
+      iter->second->getBounds(pos, rot, ext);
+      return true;
+    }
+
 
     const Vector NodeManager::getLinearVelocity(NodeId id) const {
       Vector vel(0.0,0.0,0.0);
@@ -828,6 +842,7 @@ namespace mars {
       NodeMap::iterator iter = simNodes.find(id);
       if (iter != simNodes.end())
         iter->second->setRotation(rot, 1);
+      invalidateEntityBounds();
     }
 
     /**
@@ -1169,6 +1184,7 @@ namespace mars {
       editedNode->setPosition(pos, false);
       editedNode->setRotation(q, false);
       nodesToUpdate[id] = iter->second;
+      invalidateEntityBounds();
     }
 
     void NodeManager::rotateNodeRecursive(NodeId id,
@@ -1288,6 +1304,12 @@ namespace mars {
       for(iter = simNodesDyn.begin(); iter != simNodesDyn.end(); iter++) {
         iter->second->update(calc_ms, physics_thread);
       }
+      invalidateEntityBounds();
+    }
+
+    void NodeManager::invalidateEntityBounds() {
+      // the entity bounding boxes are derived from the node poses
+      if(control->entities) control->entities->invalidateBoundingVolumes();
     }
 
     void NodeManager::preGraphicsUpdate() {
@@ -1453,6 +1475,7 @@ namespace mars {
       NodeMap::iterator iter = simNodes.find(id);
       if (iter != simNodes.end())
         iter->second->addRotation(q);
+      invalidateEntityBounds();
     }
 
 
@@ -2009,6 +2032,7 @@ namespace mars {
         maxGroupID = nodeS->groupID;
       }
       nodesToUpdate[sNode.index] = editedNode;
+      invalidateEntityBounds();
     }
 
     void NodeManager::addContact(NodeId id, Vector &point, Vector &normal,
@@ -88,6 +88,9 @@ namespace mars {
       virtual const utils::Vector getPosition(interfaces::NodeId id) const;
       virtual void setRotation(interfaces::NodeId id, const utils::Quaternion &rot);
       virtual const utils::Quaternion getRotation(interfaces::NodeId id) const;
+      virtual bool getNodeBounds(interfaces::NodeId id, utils::Vector *pos,
+                                 utils::Quaternion *rot,
+                                 utils::Vector *ext) const;
       virtual const utils::Vector getLinearVelocity(interfaces::NodeId id) const;
       virtual const utils::Vector getAngularVelocity(interfaces::NodeId id) const;
       virtual const utils::Vector getLinearAcceleration(interfaces::NodeId id) const;
@@ -167,6 +170,7 @@ namespace mars {
                               interfaces::sReal depth, interfaces::contact_params &c_params_other);
 
     private:
+      void invalidateEntityBounds();
       interfaces::NodeId next_node_id;
       bool update_all_nodes;
       int visual_rep;
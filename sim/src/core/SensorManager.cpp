@@ -252,6 +252,29 @@ namespace mars {
       return 0;
     }
 
+    int SensorManager::getSensorHistory(unsigned long id, double since,
+                                        std::vector<double> *times,
+                                        std::vector<double> *data) const {
+      MutexLocker locker(&iMutex);
+      map<unsigned long, BaseSensor*>::const_iterator iter;
+
+      iter = simSensors.find(id);
+      if (iter != simSensors.end())
+        return iter->second->getHistory(since, times, data);
+      return 0;
+    }
+
+    bool SensorManager::getSensorDataAt(unsigned long id, double time,
+                                        std::vector<double> *data) const {
+      MutexLocker locker(&iMutex);
+      map<unsigned long, BaseSensor*>::const_iterator iter;
+
+      iter = simSensors.find(id);
+      if (iter != simSensors.end())
+        return iter->second->getSensorDataAt(time, data);
+      return false;
+    }
+
 
     /**
      *\brief Returns the number of sensors that are currently present in the simulation.
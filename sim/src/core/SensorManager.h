@@ -176,6 +176,11 @@ namespace mars {
        * \param index The index of the sensor to get the data
        */
       virtual int getSensorData(unsigned long id, interfaces::sReal **data) const;
+      virtual int getSensorHistory(unsigned long id, double since,
+                                   std::vector<double> *times,
+                                   std::vector<double> *data) const;
+      virtual bool getSensorDataAt(unsigned long id, double time,
+                                   std::vector<double> *data) const;
 
       /**
        *\brief Returns the number of sensors that are currently present in the simulation.
@@ -194,32 +194,39 @@ namespace mars {
     void SimEntity::getBoundingBox(utils::Vector &center, utils::Quaternion &rotation, utils::Vector &extent) {
       utils::Vector maxVertex(-DBL_MAX, -DBL_MAX, -DBL_MAX);
       utils::Vector minVertex(DBL_MAX, DBL_MAX, DBL_MAX);
-      NodeData root = control->nodes->getFullNode(getRootestId());
-      NodeData node;
+      utils::Vector rootPos, rootExt, pos, ext;
+      utils::Quaternion rootRot, rot;
+      // only the spatial state is needed, so avoid copying full NodeData
+      if(!control->nodes->getNodeBounds(getRootestId(), &rootPos, &rootRot,
+                                        &rootExt)) {
+        rootPos.setZero();
+        rootRot.setIdentity();
+      }
+      const Eigen::Matrix3d toEntity = rootRot.toRotationMatrix().transpose();
       for (std::map<unsigned long, std::string>::const_iterator iter = nodeIds.begin();
           iter != nodeIds.end(); ++iter) {
-        if (!control->nodes->exists(iter->first)) {
+        if (!control->nodes->getNodeBounds(iter->first, &pos, &rot, &ext)) {
           continue;
         }
-        node = control->nodes->getFullNode(iter->first);
+        const Eigen::Matrix3d toWorld = rot.toRotationMatrix();
         utils::Vector vertices[8] = {
-          node.ext,
-          utils::Vector(-node.ext[0], node.ext[1], node.ext[2]),
-          utils::Vector(node.ext[0], -node.ext[1], node.ext[2]),
-          utils::Vector(node.ext[0], node.ext[1], -node.ext[2]),
-          -node.ext,
-          utils::Vector(node.ext[0], -node.ext[1], -node.ext[2]),
-          utils::Vector(-node.ext[0], node.ext[1], -node.ext[2]),
-          utils::Vector(-node.ext[0], -node.ext[1], node.ext[2])
+          ext,
+          utils::Vector(-ext[0], ext[1], ext[2]),
+          utils::Vector(ext[0], -ext[1], ext[2]),
+          utils::Vector(ext[0], ext[1], -ext[2]),
+          -ext,
+          utils::Vector(ext[0], -ext[1], -ext[2]),
+          utils::Vector(-ext[0], ext[1], -ext[2]),
+          utils::Vector(-ext[0], -ext[1], ext[2])
         };
         for(int v=0;v<8;v++) {
           vertices[v] /= 2;
-          vertices[v] = node.rot.toRotationMatrix() * vertices[v];
-          vertices[v] += node.pos;
+          vertices[v] = toWorld * vertices[v];
+          vertices[v] += pos;
           //till here the bounding box is world frame
           //now we transform to entity frame
-          vertices[v] -= root.pos;
-          vertices[v] = root.rot.toRotationMatrix().transpose() * vertices[v];
+          vertices[v] -= rootPos;
+          vertices[v] = toEntity * vertices[v];
           //now we calculate the extent
           for(int i=0;i<3;i++) {
             maxVertex[i] = fmax(vertices[v][i],maxVertex[i]);
@@ -230,8 +237,8 @@ namespace mars {
       extent = maxVertex - minVertex;
       center = (maxVertex + minVertex) / 2;
       //transform center to world frame
-      center += root.pos;
-      rotation = root.rot;
+      center += rootPos;
+      rotation = rootRot;
     }
 
     /**returns the vertices of the boundingbox
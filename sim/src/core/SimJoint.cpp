@@ -26,6 +26,7 @@
 #include <mars/interfaces/sim/ControlCenter.h>
 #include <mars/interfaces/sim/NodeManagerInterface.h>
 #include <mars/utils/mathUtils.h>
+#include <mars/utils/MutexLocker.h>
 
 #include <iostream>
 #include <cstdio>
@@ -41,6 +42,7 @@ namespace mars {
       : control(c) {
 
       physical_joint = 0;
+      stepGeneration = frameGeneration = loadGeneration = 0;
       setSJoint(sJoint_);
 
       pushToDataBroker = 2;
@@ -147,6 +149,8 @@ namespace mars {
     }
 
     const Vector SimJoint::getAnchor() const {
+      MutexLocker locker(&iMutex);
+      updateFrame();
       return anchor;
     }
 
@@ -169,6 +173,8 @@ namespace mars {
     }
 
     const utils::Vector SimJoint::getAxis(unsigned char axis_index) const {
+      MutexLocker locker(&iMutex);
+      updateFrame();
       return axis_index == 1 ? axis1 : axis2;
     }
 
@@ -230,20 +236,11 @@ namespace mars {
         double ode_position1 = (sJoint.angle1_offset + invert*physical_joint->getPosition());
         double ode_position2 = (sJoint.angle2_offset + invert*physical_joint->getPosition2());
 
-        physical_joint->getAnchor(&anchor);
-        physical_joint->getAxis(&axis1);
-        physical_joint->getAxis2(&axis2);
-        physical_joint->getForce1(&f1);
-        physical_joint->getForce2(&f2);
-        physical_joint->getTorque1(&t1);
-        physical_joint->getTorque2(&t2);
         physical_joint->update();
-        physical_joint->getAxisTorque(&axis1_torque);
-        physical_joint->getAxis2Torque(&axis2_torque);
-        physical_joint->getJointLoad(&joint_load);
-        axis1_torque *= invert;
-        axis2_torque *= invert;
-        joint_load *= invert;
+        // anchor, axes, forces and loads are evaluated on demand
+        iMutex.lock();
+        ++stepGeneration;
+        iMutex.unlock();
         velocity1 = invert*physical_joint->getVelocity();
         velocity2 = invert*physical_joint->getVelocity2();
         if(sJoint.type == JOINT_TYPE_SLIDER) {
@@ -269,7 +266,32 @@ namespace mars {
       }
     }
 
+    // updateFrame and updateLoads expect iMutex to be locked by the caller
+    void SimJoint::updateFrame(void) const {
+      if(frameGeneration == stepGeneration || !physical_joint) return;
+      physical_joint->getAnchor(&anchor);
+      physical_joint->getAxis(&axis1);
+      physical_joint->getAxis2(&axis2);
+      frameGeneration = stepGeneration;
+    }
+
+    void SimJoint::updateLoads(void) const {
+      if(loadGeneration == stepGeneration || !physical_joint) return;
+      physical_joint->getForce1(&f1);
+      physical_joint->getForce2(&f2);
+      physical_joint->getTorque1(&t1);
+      physical_joint->getTorque2(&t2);
+      physical_joint->getAxisTorque(&axis1_torque);
+      physical_joint->getAxis2Torque(&axis2_torque);
+      physical_joint->getJointLoad(&joint_load);
+      axis1_torque *= invert;
+      axis2_torque *= invert;
+      joint_load *= invert;
+      loadGeneration = stepGeneration;
+    }
+
     void SimJoint::setSJoint(const JointData &sJoint) {
+      MutexLocker locker(&iMutex);
       this->sJoint = sJoint;
       id = sJoint.index;
       anchor = sJoint.anchor;
@@ -290,6 +312,8 @@ namespace mars {
       upperLimit1 = sJoint.highStopAxis1;
       lowerLimit2 = sJoint.lowStopAxis2;
       upperLimit2 = sJoint.highStopAxis2;
+      // the values above are valid until the next step
+      frameGeneration = loadGeneration = stepGeneration;
       if(sJoint.invertAxis) {
         invert = -1;
       }
@@ -308,6 +332,8 @@ namespace mars {
     }
 
     const JointData SimJoint::getSJoint(void) const {
+      MutexLocker locker(&iMutex);
+      updateFrame();
       JointData tmp = sJoint;
 
       tmp.axis1 = axis1;
@@ -404,6 +430,8 @@ namespace mars {
     }
 
     void SimJoint::getCoreExchange(core_objects_exchange *obj) const {
+      MutexLocker locker(&iMutex);
+      updateFrame();
       obj->index = sJoint.index;
       obj->name = sJoint.name;
       obj->groupID = 0;
@@ -413,6 +441,8 @@ namespace mars {
     }
 
     const utils::Vector SimJoint::getForceVector(unsigned char axis_index) const {
+      MutexLocker locker(&iMutex);
+      updateLoads();
       return axis_index == 1 ? f1 : f2;
     }
 
@@ -425,6 +455,8 @@ namespace mars {
     }
 
     const Vector SimJoint::getTorqueVector(unsigned char axis_index) const {
+      MutexLocker locker(&iMutex);
+      updateLoads();
       return axis_index == 1 ? t1 : t2;
     }
 
@@ -441,6 +473,8 @@ namespace mars {
     }
 
     const Vector SimJoint::getTorqueVectorAroundAxis(unsigned char axis_index) const {
+      MutexLocker locker(&iMutex);
+      updateLoads();
       return axis_index == 1 ? axis1_torque : axis2_torque;
     }
 
@@ -453,6 +487,8 @@ namespace mars {
     }
 
     const Vector SimJoint::getJointLoad(void) const {
+      MutexLocker locker(&iMutex);
+      updateLoads();
       return joint_load;
     }
 
@@ -606,6 +642,10 @@ namespace mars {
     void SimJoint::produceData(const data_broker::DataInfo &info,
                                data_broker::DataPackage *dbPackage,
                                int callbackParam) {
+      // only called if the package has receivers
+      MutexLocker locker(&iMutex);
+      updateFrame();
+      updateLoads();
       dbPackageMapping.writePackage(dbPackage);
     }
 
@@ -30,6 +30,8 @@
 #include <mars/data_broker/ProducerInterface.h>
 #include <mars/data_broker/DataPackageMapping.h>
 
+#include <mars/utils/Mutex.h>
+
 namespace mars {
   
   namespace interfaces {
@@ -203,16 +205,25 @@ namespace mars {
       interfaces::sReal position1, position2;
       interfaces::sReal velocity1, velocity2;
       interfaces::sReal lowerLimit1, lowerLimit2, upperLimit1, upperLimit2;
-      utils::Vector anchor;
-      utils::Vector axis1, axis2; // axes
-      utils::Vector f1, f2; // forces
-      utils::Vector t1, t2; // torques
-      utils::Vector axis1_torque, axis2_torque, joint_load;
+      // the following values are only pulled from the physics when they are
+      // requested; the generation counters mark the step they belong to
+      mutable utils::Vector anchor;
+      mutable utils::Vector axis1, axis2; // axes
+      mutable utils::Vector f1, f2; // forces
+      mutable utils::Vector t1, t2; // torques
+      mutable utils::Vector axis1_torque, axis2_torque, joint_load;
+      unsigned long stepGeneration;
+      mutable unsigned long frameGeneration, loadGeneration;
+      // the getters are also called from the GUI and DataBroker threads
+      mutable utils::Mutex iMutex;
       interfaces::sReal motor_torque, invert;
       utils::Vector axis1InNode1;
       utils::Vector node1ToAnchor;
       int pushToDataBroker;
 
+      void updateFrame(void) const;
+      void updateLoads(void) const;
+
       // for dataBroker communication
       void setupDataPackageMapping();
       data_broker::DataPackageMapping dbPackageMapping;
@@ -70,6 +70,10 @@ namespace mars {
       a_vel = Vector(0.0, 0.0, 0.0);
       f = Vector(0.0, 0.0, 0.0);
       t = Vector(0.0, 0.0, 0.0);
+      l_acc = Vector(0.0, 0.0, 0.0);
+      a_acc = Vector(0.0, 0.0, 0.0);
+      last_calc_ms = 0;
+      stepGeneration = dynamicsGeneration = 0;
       ground_contact = 0;
       ground_contact_force = 0;
       i_velocity_sum = 0.0;
@@ -180,6 +184,11 @@ namespace mars {
     void SimNode::produceData(const data_broker::DataInfo &info,
                               data_broker::DataPackage *dbPackage,
                               int callbackParam) {
+      // only called if the package has receivers
+      if(pushToDataBroker > 1) {
+        MutexLocker locker(&iMutex);
+        updateDynamics();
+      }
       dbPackageMapping.writePackage(dbPackage);
     }
 
@@ -323,10 +332,12 @@ namespace mars {
     }
     const Vector SimNode::getLinearAcceleration() const {
       MutexLocker locker(&iMutex);
+      updateDynamics();
       return l_acc;
     }
     const Vector SimNode::getAngularAcceleration() const {
       MutexLocker locker(&iMutex);
+      updateDynamics();
       return a_acc;
     }
     const Vector SimNode::getForce() const {
@@ -450,6 +461,13 @@ namespace mars {
       return sNode.ext;
     }
 
+    void SimNode::getBounds(Vector *pos, Quaternion *rot, Vector *ext) const {
+      MutexLocker locker(&iMutex);
+      *pos = sNode.pos;
+      *rot = sNode.rot;
+      *ext = sNode.ext;
+    }
+
     void SimNode::setInterface(std::shared_ptr<NodeInterface> _interface) {
       MutexLocker locker(&iMutex);
       my_interface = _interface;
@@ -536,6 +554,23 @@ namespace mars {
         control->graphics->setDrawObjectMaterial(graphics_id,sNode.material);
     }
 
+    /**
+     * Derives the accelerations from the velocities of the last two updates
+     * if this was not yet done since the last update. Has to be called with
+     * iMutex locked.
+     */
+    void SimNode::updateDynamics() const {
+      if(dynamicsGeneration == stepGeneration) return;
+      if(last_calc_ms > 0) {
+        l_acc = (l_vel - last_l_vel) / (last_calc_ms / 1000.);
+        a_acc = (a_vel - last_a_vel) / (last_calc_ms / 1000.);
+      } else {
+        l_acc = Vector(0, 0, 0);
+        a_acc = Vector(0, 0, 0);
+      }
+      dynamicsGeneration = stepGeneration;
+    }
+
     /**
      * pre:
      *     - interface != 0
@@ -553,17 +588,15 @@ namespace mars {
         my_interface->getRotation(&sNode.rot);
         my_interface->getLinearVelocity(&l_vel);
         my_interface->getAngularVelocity(&a_vel);
+        // read right after the step, before plugins and controllers add
+        // the forces of the next step
         my_interface->getForce(&f);
         my_interface->getTorque(&t);
         ground_contact = my_interface->getGroundContact();
         ground_contact_force = my_interface->getGroundContactForce();
-        if(calc_ms > 0) {
-          l_acc = (l_vel - last_l_vel) / (calc_ms / 1000.);
-          a_acc = (a_vel - last_a_vel) / (calc_ms / 1000.);
-        } else {
-          l_acc = Vector(0, 0, 0);
-          a_acc = Vector(0, 0, 0);
-        }
+        // the accelerations are derived on demand
+        last_calc_ms = calc_ms;
+        ++stepGeneration;
         //i_velocity_sum -= i_velocity[vel_ptr];
         //i_velocity[vel_ptr] = fabs(a_vel.length());
         //i_velocity_sum += i_velocity[vel_ptr];
@@ -110,6 +110,8 @@ namespace mars {
       //int getSpace(void); ///< Returns the collision space of the node.
       const std::string getTexture(void) const; ///< Returns the name of the nodes texture.
       const utils::Vector getExtent(void) const; ///< returns the bounding extent of the node
+      void getBounds(utils::Vector *pos, utils::Quaternion *rot,
+                     utils::Vector *ext) const; ///< position, rotation and extent at once
       bool isMovable(void) const; ///< returns if node is a movable node
       unsigned long getGraphicsID2(void) const;
       int getGroupID(void) const;
@@ -206,8 +208,13 @@ namespace mars {
       utils::Vector last_l_vel;
       utils::Vector a_vel;
       utils::Vector last_a_vel;
-      utils::Vector l_acc;
-      utils::Vector a_acc;
+      // the accelerations are only derived when they are requested;
+      // dynamicsGeneration marks the step they belong to
+      mutable utils::Vector l_acc;
+      mutable utils::Vector a_acc;
+      interfaces::sReal last_calc_ms;
+      unsigned long stepGeneration;
+      mutable unsigned long dynamicsGeneration;
       bool ground_contact;
       interfaces::sReal ground_contact_force;
       std::shared_ptr<interfaces::NodeInterface> my_interface;
@@ -228,6 +235,7 @@ namespace mars {
 
       void addToDataBroker();
       void removeFromDataBroker();
+      void updateDynamics() const;
 
     };
 
@@ -38,6 +38,7 @@
 #include "Controller.h"
 
 #include <mars/utils/misc.h>
+#include <mars/utils/SceneArchive.h>
 #include <mars/interfaces/SceneParseException.h>
 #include <mars/interfaces/graphics/GraphicsManagerInterface.h>
 #include <mars/interfaces/sim/LoadCenter.h>
@@ -51,6 +52,7 @@
 #include <stdexcept>
 #include <algorithm>
 #include <cctype> // for tolower()
+#include <chrono>
 
 #ifdef __linux__
 #include <time.h>
@@ -72,6 +74,23 @@ namespace mars {
       exit(signal);
     }
 
+    typedef std::chrono::steady_clock PhaseClock;
+
+    static const char *stepPhaseNames[] = {
+      "physics", "nodes", "joints", "motors", "controllers", "data_broker",
+      "plugins"
+    };
+
+    /**
+     * \brief Adds the time since \a *start to \a *phaseMs and restarts
+     * \a *start for the next phase.
+     */
+    static void takePhaseTime(double *phaseMs, PhaseClock::time_point *start) {
+      PhaseClock::time_point now = PhaseClock::now();
+      *phaseMs += std::chrono::duration<double, std::milli>(now - *start).count();
+      *start = now;
+    }
+
 
     Simulator *Simulator::activeSimulator = 0;
 
@@ -85,6 +104,7 @@ namespace mars {
       calc_time = 0;
       avg_step_time = avg_log_time = 0;
       count = 0;
+      resetStepPhaseTimes();
       config_dir = ".";
 
       std_port = 1600;
@@ -97,6 +117,7 @@ namespace mars {
       sim_fault = false;
       // set the calculation step size in ms
       calc_ms      = 10; //defaultCFG->getInt("physics", "calc_ms", 10);
+      physics_substeps = 1;
       avg_count_steps = 20;
       my_real_time = 0;
       // to synchronise drawing and physics
@@ -325,8 +346,7 @@ namespace mars {
         physics -> setPhysicsPlugins(physicsPlugins); 
       }
       physics->initTheWorld();
-      // the physics step_size is in seconds
-      physics->step_size = calc_ms/1000.;
+      updateStepSize();
       physics->fast_step = cfgFaststep.bValue;
 
       physics->world_erp = cfgWorldErp.dValue;
@@ -337,6 +357,8 @@ namespace mars {
       gravity.z() = cfgGZ.dValue;
       physics->world_gravity = gravity;
       physics->draw_contact_points = cfgDrawContact.bValue;
+      physics->contact_merge_distance = cfgContactMergeDistance.dValue;
+      physics->contact_reuse_tolerance = cfgContactReuseTolerance.dValue;
 #ifndef __linux__
       this->setStackSize(16777216);
       fprintf(stderr, "INFO: set physics stack size to: %lu\n", getStackSize());
@@ -430,18 +452,42 @@ namespace mars {
       }
 
       time = utils::getTime();
+      double phaseMs[NUM_STEP_PHASES] = {0.0};
+      PhaseClock::time_point phaseStart = PhaseClock::now();
 
       if(control->dataBroker) {
         control->dataBroker->trigger("mars_sim/prePhysicsUpdate");
       }
-      physics->stepTheWorld();
+      // Between the physics sub-steps only the joint states and the motor
+      // efforts are updated. Everything else runs once per calc_ms.
+      sReal sub_ms = calc_ms / physics_substeps;
+      for(int i=0; i<physics_substeps; ++i) {
+        if(i > 0) {
+          control->joints->updateJoints(sub_ms);
+          takePhaseTime(&phaseMs[PHASE_JOINTS], &phaseStart);
+          control->motors->updateMotors(sub_ms);
+          takePhaseTime(&phaseMs[PHASE_MOTORS], &phaseStart);
+        }
+        physics->stepTheWorld();
+        takePhaseTime(&phaseMs[PHASE_PHYSICS], &phaseStart);
+      }
+      physics->clearExternalContacts();
+      takePhaseTime(&phaseMs[PHASE_PHYSICS], &phaseStart);
 
       avg_step_time += getTimeDiff(time);
 
       control->nodes->updateDynamicNodes(calc_ms); //Moved update to here, otherwise RaySensor is one step behind the world every time
-      control->joints->updateJoints(calc_ms);
-      control->motors->updateMotors(calc_ms);
+      takePhaseTime(&phaseMs[PHASE_NODES], &phaseStart);
+      control->joints->updateJoints(sub_ms);
+      takePhaseTime(&phaseMs[PHASE_JOINTS], &phaseStart);
+      control->motors->updateMotors(sub_ms);
+      takePhaseTime(&phaseMs[PHASE_MOTORS], &phaseStart);
       control->controllers->updateControllers(calc_ms);
+      takePhaseTime(&phaseMs[PHASE_CONTROLLERS], &phaseStart);
+      if(control->entities) {
+        control->entities->invalidateBoundingVolumes();
+      }
+      takePhaseTime(&phaseMs[PHASE_NODES], &phaseStart);
 
       time = utils::getTime();
 
@@ -453,6 +499,7 @@ namespace mars {
                                       dbSimTimePackage);
         control->dataBroker->stepTimer("mars_sim/simTimer", calc_ms);
       }
+      takePhaseTime(&phaseMs[PHASE_DATA_BROKER], &phaseStart);
 
       avg_log_time += getTimeDiff(time);
       if(++count > avg_count_steps) {
@@ -493,6 +540,7 @@ namespace mars {
         }
       }
       pluginLocker.unlock();
+      takePhaseTime(&phaseMs[PHASE_PLUGINS], &phaseStart);
       if(control->dataBroker) {
         control->dataBroker->pushData(dbSimDebugId,
                                       dbSimDebugPackage);
@@ -509,6 +557,14 @@ namespace mars {
       if(control->dataBroker) {
         control->dataBroker->trigger("mars_sim/postPhysicsUpdate");
       }
+      takePhaseTime(&phaseMs[PHASE_DATA_BROKER], &phaseStart);
+
+      phaseTimeMutex.lock();
+      for(int i=0; i<NUM_STEP_PHASES; ++i) {
+        phaseTimeMs[i] += phaseMs[i];
+      }
+      ++phaseTimeSteps;
+      phaseTimeMutex.unlock();
 
       if(setState) {
         simulationStatus = oldState;
@@ -882,6 +938,10 @@ namespace mars {
           control->graphics->reset();
         }
       }
+      // a reset reloads the nodes from the mounted scene archives
+      if(clear_all) {
+        utils::SceneArchive::unmountAll();
+      }
 
       sceneHasChanged(true);
       physics->freeTheWorld();
@@ -1355,12 +1415,25 @@ namespace mars {
       }
     }
 
+    void Simulator::updateStepSize(void) {
+      if(!physics) return;
+      // the physics step_size is in seconds
+      physics->step_size = calc_ms/physics_substeps/1000.;
+      physics->num_sub_steps = physics_substeps;
+      if(control->joints) control->joints->changeStepSize();
+    }
+
     void Simulator::cfgUpdateProperty(cfg_manager::cfgPropertyStruct _property) {
 
       if(_property.paramId == cfgCalcMs.paramId) {
         calc_ms = _property.dValue;
-        if(physics) physics->step_size = calc_ms*0.001; // The physics step_size is defined in seconds.
-        if(control->joints) control->joints->changeStepSize();
+        updateStepSize();
+        return;
+      }
+
+      if(_property.paramId == cfgPhysicsSubsteps.paramId) {
+        physics_substeps = std::max(1, _property.iValue);
+        updateStepSize();
         return;
       }
 
@@ -1389,6 +1462,16 @@ namespace mars {
         return;
       }
 
+      if(_property.paramId == cfgContactMergeDistance.paramId) {
+        if(physics) physics->contact_merge_distance = _property.dValue;
+        return;
+      }
+
+      if(_property.paramId == cfgContactReuseTolerance.paramId) {
+        if(physics) physics->contact_reuse_tolerance = _property.dValue;
+        return;
+      }
+
       if(_property.paramId == cfgGX.paramId) {
         gravity.x() = _property.dValue;
         physics->world_gravity = gravity;
@@ -1453,6 +1536,12 @@ namespace mars {
       cfgDrawContact = control->cfg->getOrCreateProperty("Simulator", "draw contacts",
                                                          false, this);
 
+      cfgContactMergeDistance = control->cfg->getOrCreateProperty("Simulator", "contact merge distance",
+                                                                  0.0, this);
+
+      cfgContactReuseTolerance = control->cfg->getOrCreateProperty("Simulator", "contact reuse tolerance",
+                                                                   0.0, this);
+
       cfgGX = control->cfg->getOrCreateProperty("Simulator", "Gravity x",
                                                 0.0, this);
 
@@ -1477,6 +1566,10 @@ namespace mars {
       cfgAvgCountSteps = control->cfg->getOrCreateProperty("Simulator", "avg count steps",
                                                            avg_count_steps, this);
       avg_count_steps = cfgAvgCountSteps.iValue;
+
+      cfgPhysicsSubsteps = control->cfg->getOrCreateProperty("Simulator", "physics substeps",
+                                                             physics_substeps, this);
+      physics_substeps = std::max(1, cfgPhysicsSubsteps.iValue);
       control->cfg->getOrCreateProperty("Simulator", "onPhysicsError",
                                         "abort", this);
 
@@ -1546,6 +1639,25 @@ namespace mars {
       return returnTime;
     }
 
+    void Simulator::getStepPhaseTimes(std::map<std::string, double> *phaseMs,
+                                      unsigned long *steps) {
+      phaseTimeMutex.lock();
+      for(int i=0; i<NUM_STEP_PHASES; ++i) {
+        (*phaseMs)[stepPhaseNames[i]] = phaseTimeMs[i];
+      }
+      *steps = phaseTimeSteps;
+      phaseTimeMutex.unlock();
+    }
+
+    void Simulator::resetStepPhaseTimes() {
+      phaseTimeMutex.lock();
+      for(int i=0; i<NUM_STEP_PHASES; ++i) {
+        phaseTimeMs[i] = 0.0;
+      }
+      phaseTimeSteps = 0;
+      phaseTimeMutex.unlock();
+    }
+
 
   } // end of namespace sim
 
@@ -218,6 +218,10 @@ namespace mars {
        */
       virtual unsigned long getTime();
 
+      virtual void getStepPhaseTimes(std::map<std::string, double> *phaseMs,
+                                     unsigned long *steps);
+      virtual void resetStepPhaseTimes();
+
     private:
 
       struct LoadOptions {
@@ -266,11 +270,25 @@ namespace mars {
       int physics_mutex_count;
       double avg_log_time, avg_step_time;
       int count, avg_count_steps;
+      enum StepPhase {
+        PHASE_PHYSICS,
+        PHASE_NODES,
+        PHASE_JOINTS,
+        PHASE_MOTORS,
+        PHASE_CONTROLLERS,
+        PHASE_DATA_BROKER,
+        PHASE_PLUGINS,
+        NUM_STEP_PHASES
+      };
+      utils::Mutex phaseTimeMutex;
+      double phaseTimeMs[NUM_STEP_PHASES]; ///< Summed wall time per phase of step().
+      unsigned long phaseTimeSteps;
       interfaces::sReal calc_time;
       
       // physics
       std::shared_ptr<interfaces::PhysicsInterface> physics;
       double calc_ms;
+      int physics_substeps;
       int load_option;
       int std_port; ///< Controller port (default value: 1600)
       utils::Vector gravity;
@@ -297,10 +315,13 @@ namespace mars {
 
       // configuration
       void initCfgParams(void);
+      void updateStepSize(void);
       std::string config_dir;
       cfg_manager::cfgPropertyStruct cfgCalcMs, cfgFaststep;
       cfg_manager::cfgPropertyStruct cfgRealtime, cfgDebugTime;
       cfg_manager::cfgPropertyStruct cfgSyncGui, cfgDrawContact;
+      cfg_manager::cfgPropertyStruct cfgContactMergeDistance;
+      cfg_manager::cfgPropertyStruct cfgContactReuseTolerance;
       cfg_manager::cfgPropertyStruct cfgGX, cfgGY, cfgGZ;
       cfg_manager::cfgPropertyStruct cfgWorldErp, cfgWorldCfm;
       cfg_manager::cfgPropertyStruct cfgVisRep;
@@ -308,6 +329,7 @@ namespace mars {
       cfg_manager::cfgPropertyStruct configPath;
       cfg_manager::cfgPropertyStruct cfgUseNow;
       cfg_manager::cfgPropertyStruct cfgAvgCountSteps;
+      cfg_manager::cfgPropertyStruct cfgPhysicsSubsteps;
       
       // data
       data_broker::DataPackage dbPhysicsUpdatePackage;
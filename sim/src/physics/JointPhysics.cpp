@@ -55,6 +55,8 @@ namespace mars {
       spring = 0;
       body1 = 0;
       body2 = 0;
+      motor_torque = 0;
+      loadsDirty = false;
     }
 
     /**
@@ -894,12 +896,16 @@ namespace mars {
      *     normal[2] *= dot*radius;
      */
     void JointPhysics::getAxisTorque(Vector *t) const {
+      MutexLocker locker(&(theWorld->iMutex));
+      if(loadsDirty) computeLoads();
       t->x() = axis1_torque.x();
       t->y() = axis1_torque.y();
       t->z() = axis1_torque.z();
     }
 
     void JointPhysics::getAxis2Torque(Vector *t) const {
+      MutexLocker locker(&(theWorld->iMutex));
+      if(loadsDirty) computeLoads();
       t->x() = axis2_torque.x();
       t->y() = axis2_torque.y();
       t->z() = axis2_torque.z();
@@ -911,12 +917,23 @@ namespace mars {
      *
      */
     void JointPhysics::update(void) {
+      MutexLocker locker(&(theWorld->iMutex));
+      motor_torque = feedback.lambda;
+      // the axis torques and the joint load are only derived from the
+      // feedback if someone asks for them in this step
+      loadsDirty = true;
+    }
+
+    /**
+     * The getters are called from the GUI and DataBroker threads as well,
+     * so this has to be called with theWorld->iMutex locked.
+     */
+    void JointPhysics::computeLoads(void) const {
       const dReal *b1_pos, *b2_pos;
       dReal anchor[4], axis[4], axis2[4];
       int calc1 = 0, calc2 = 0;
       dReal radius, dot, torque;
       dReal v1[3], normal[3], load[3], tmp1[3], axis_force[3];
-      MutexLocker locker(&(theWorld->iMutex));
 
       switch(joint_type) {
       case  JOINT_TYPE_HINGE:
@@ -949,7 +966,7 @@ namespace mars {
         // no correct type is spezified, so no physically node will be created
         break;
       }
-      motor_torque = feedback.lambda;
+      loadsDirty = false;
       axis1_torque.x() = axis1_torque.y() = axis1_torque.z() = 0;
       axis2_torque.x() = axis2_torque.y() = axis2_torque.z() = 0;
       joint_load.x() = joint_load.y() = joint_load.z() = 0;
@@ -1065,6 +1082,8 @@ namespace mars {
     }
 
     void JointPhysics::getJointLoad(Vector *t) const {
+      MutexLocker locker(&(theWorld->iMutex));
+      if(loadsDirty) computeLoads();
       t->x() = joint_load.x();
       t->y() = joint_load.y();
       t->z() = joint_load.z();
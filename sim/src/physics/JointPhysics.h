@@ -98,9 +98,13 @@ namespace mars {
       dReal cfm, cfm1, cfm2, erp1, erp2;
       dReal lo1, lo2, hi1, hi2;
       dReal damping, spring, jointCFM;
-      utils::Vector axis1_torque, axis2_torque, joint_load;
+      // derived from the joint feedback on demand, see computeLoads()
+      mutable utils::Vector axis1_torque, axis2_torque, joint_load;
+      mutable bool loadsDirty;
       dReal motor_torque;
 
+      void computeLoads(void) const;
+
       void calculateCfmErp(const interfaces::JointData *jointS);
 
       ///create a joint from type Hing
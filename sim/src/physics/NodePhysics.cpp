@@ -44,7 +44,7 @@
 #include <mars/interfaces/sensor_bases.h>
 #include <mars/interfaces/terrainStruct.h>
 #include <cmath>
-#include <set>
+#include <algorithm>
 
 #include <mars/interfaces/Logging.hpp>
 
@@ -1272,19 +1272,15 @@ namespace mars {
     void NodePhysics::getContactPoints(std::vector<Vector> *contact_points) const {
       contact_points->clear();
       if(nGeom) {
-        std::vector<Vector>::const_iterator iter;
-
-        for(iter=node_data.contact_points.begin();
-            iter!=node_data.contact_points.end(); ++iter)
-
-          contact_points->push_back((*iter));
+        contact_points->assign(node_data.contact_points.begin(),
+                               node_data.contact_points.end());
       }
     }
 
     void NodePhysics::getContactIDs(std::list<interfaces::NodeId> *ids) const {
       ids->clear();
       if(nGeom) {
-        *ids = node_data.contact_ids;
+        ids->assign(node_data.contact_ids.begin(), node_data.contact_ids.end());
       }
     }
 
@@ -1382,8 +1378,35 @@ namespace mars {
       return (dReal)height_data[(y*terrain->width)+x]*terrain->scale;
     }
 
+    /**
+     * \brief Returns true if the parameters combined for a contact pair
+     *   differ. Only the presence of a friction direction is compared since
+     *   the direction itself is read for every contact.
+     */
+    static bool pairParamsChanged(const contact_params &a,
+                                  const contact_params &b) {
+      return (a.max_num_contacts != b.max_num_contacts ||
+              a.erp != b.erp || a.cfm != b.cfm ||
+              a.friction1 != b.friction1 || a.friction2 != b.friction2 ||
+              (a.friction_direction1 == 0) != (b.friction_direction1 == 0) ||
+              a.motion1 != b.motion1 || a.motion2 != b.motion2 ||
+              a.fds1 != b.fds1 || a.fds2 != b.fds2 ||
+              a.bounce != b.bounce || a.bounce_vel != b.bounce_vel ||
+              a.approx_pyramid != b.approx_pyramid ||
+              a.depth_correction != b.depth_correction ||
+              a.rolling_friction != b.rolling_friction ||
+              a.rolling_friction2 != b.rolling_friction2 ||
+              a.spinning_friction != b.spinning_friction);
+    }
+
     void NodePhysics::setContactParams(contact_params& c_params) {
       MutexLocker locker(&(theWorld->iMutex));
+      // nodes with a friction direction node call this every step, keep the
+      // id and thus the cached pair parameters if nothing else changed
+      if(!node_data.params_id ||
+         pairParamsChanged(node_data.c_params, c_params)) {
+        node_data.params_id = theWorld->newContactParamsId();
+      }
       node_data.c_params = c_params;
       if(nGeom) {
         dGeomSetCollideBits(nGeom, c_params.coll_bitmask);
@@ -1426,11 +1449,15 @@ namespace mars {
       if(polarSensor){
         sle.sensor = sensor;
         sle.updateTime = 0.0;
+        sle.polarSensor = polarSensor;
+        sle.gridSensor = NULL;
+        sle.rotatingSensor = NULL;
         //sensor.count_data = sensor.resolution;
         //sensor.data = (sReal*)malloc(sensor.resolution * sizeof(sReal));
    
         mars::sim::RotatingRaySensor* rotRaySensor = dynamic_cast<RotatingRaySensor*>(sensor);
         if(rotRaySensor){
+            sle.rotatingSensor = rotRaySensor;
             int N = rotRaySensor->getNumberRays();
             std::vector<utils::Vector>& directions = rotRaySensor->getDirections();
             assert(N == directions.size());
@@ -1514,6 +1541,9 @@ namespace mars {
       if(polarGridSensor){
         sle.sensor = sensor;
         sle.updateTime = 0.0;
+        sle.polarSensor = NULL;
+        sle.gridSensor = polarGridSensor;
+        sle.rotatingSensor = NULL;
         int cols, rows;
         dVector3 dir={0,0,0,0}, xStep={0,0,0,0}, 
             yStep={0,0,0,0}, xOffset={0,0,0,0}, yOffset={0,0,0,0};
@@ -1544,6 +1574,7 @@ namespace mars {
       
             gd->ray_sensor = 1;
             gd->parent_geom = nGeom;
+            gd->parent_body = nBody;
             sle.geom = dCreateRay(theWorld->getSpace(),
                                   polarGridSensor->maxDistance);
             dGeomRaySetClosestHit(sle.geom, 1);
@@ -1611,121 +1642,157 @@ namespace mars {
     void NodePhysics::handleSensorData(bool physics_thread) {
       if(!physics_thread) return;
       MutexLocker locker(&(theWorld->iMutex));
-      std::vector<sensor_list_element>::iterator iter;
       const dReal* pos = dGeomGetPosition(nGeom);
       const dReal* rot = dGeomGetRotation(nGeom);
-      dVector3 dest, tmp, posOffset;
-      dReal steps_size = 1.0, length = 0.0;
-      bool done = false;
-      int steps = 0;
-      dReal worldStep = theWorld->getWorldStep();
-      // RotatingRaySensor
-      utils::Vector tmpV;
-      utils::Quaternion turnrotation;
-      turnrotation.setIdentity();
-      std::set<unsigned long> ids_rotating_ray_sensors;
-
-      //New Code
-      int i=0;
-      for(iter = sensor_list.begin(); iter != sensor_list.end(); iter++) {
-        i+=1;
-        if((double)iter->sensor->updateRate * 0.001 > worldStep) {
-          iter->updateTime += worldStep;
-          if(iter->updateTime < 0.001*iter->sensor->updateRate) continue;
-          iter->updateTime -= 0.001*iter->sensor->updateRate;
+      // the sensors are handled once per simulation step
+      dReal worldStep = theWorld->getWorldStep()*theWorld->num_sub_steps;
+      Eigen::Matrix3d nodeRot;
+      nodeRot << rot[0], rot[1], rot[2],
+                 rot[4], rot[5], rot[6],
+                 rot[8], rot[9], rot[10];
+
+      // The rays of one sensor are stored consecutively in the sensor_list.
+      // They share the update timing and the transformation into the world
+      // frame, so both are handled once per sensor.
+      size_t numElements = sensor_list.size();
+      size_t first, last;
+      for(first=0; first<numElements; first=last) {
+        sensor_list_element &head = sensor_list[first];
+        for(last=first+1; last<numElements &&
+              sensor_list[last].sensor == head.sensor; ++last) ;
+
+        if((double)head.sensor->updateRate * 0.001 > worldStep) {
+          head.updateTime += worldStep;
+          if(head.updateTime < 0.001*head.sensor->updateRate) continue;
+          head.updateTime -= 0.001*head.sensor->updateRate;
         }
-        BasePolarIntersectionSensor *polarSensor = dynamic_cast<BasePolarIntersectionSensor*>((*iter).sensor);
-        if(polarSensor){
-          sensor_list_element elem = *iter;
-
-          tmpV[0] = elem.ray_direction.x();
-          tmpV[1] = elem.ray_direction.y();
-          tmpV[2] = elem.ray_direction.z();
-          
-          // Applies orientation_offset (z-Rotation) to the laser rays.
-          mars::sim::RotatingRaySensor *rotRaySensor = dynamic_cast<RotatingRaySensor*>((*iter).sensor);
-          if(rotRaySensor){
-              std::set<unsigned long>::iterator it = ids_rotating_ray_sensors.find(rotRaySensor->id);
-              // Takes care that each rotating ray sensor is only turned once (sensor_list contains each ray independently).
-              if(it == ids_rotating_ray_sensors.end()) {
-                  //turnrotation.setIdentity(); // If we set it to identity first, receiveSensorData will not be called anymore.. wtf!?
-                  turnrotation = rotRaySensor->turn();
-                  ids_rotating_ray_sensors.insert(rotRaySensor->id);
-              }
-              //fprintf(stderr, "tmp[%i]: %f, %f, %f\n", i, tmpV.x(), tmpV.y(), tmpV.z());
-              tmpV = turnrotation * tmpV;
-              //fprintf(stderr, "tmp[%i]: %f, %f, %f\n", i, tmpV.x(), tmpV.y(), tmpV.z());
+
+        if(head.polarSensor) {
+          if(head.rotatingSensor) {
+            // Applies orientation_offset (z-Rotation) to the laser rays.
+            // turn() may regenerate the ray directions, so they are read
+            // from the sensor afterwards.
+            utils::Quaternion turnrotation = head.rotatingSensor->turn();
+            std::vector<utils::Vector> &directions = head.rotatingSensor->getDirections();
+            size_t n = std::min(directions.size(), last-first);
+            if(!n) continue;
+            Eigen::Map<const Eigen::Matrix<double, 3, Eigen::Dynamic> >
+              localDirections(directions[0].data(), 3, n);
+            rayDirections.noalias() = (nodeRot * turnrotation.toRotationMatrix()) * localDirections;
           }
-          tmp[0] = tmpV.x();//elem.ray_direction.x();
-          tmp[1] = tmpV.y();//elem.ray_direction.y();
-          tmp[2] = tmpV.z();//elem.ray_direction.z();
-          dMULTIPLY0_331(dest, rot, tmp);
-
-          if(physics_thread) {
-            steps = 0;
-            length = 0.0;
-            done = false;
-            dGeomEnable(elem.geom);
-            // make here the collision check
-            while (!done) {
-              dGeomRaySet(elem.geom,
-                          pos[0] + dest[0]*steps_size*steps,
-                          pos[1] + dest[1]*steps_size*steps,
-                          pos[2] + dest[2]*steps_size*steps,
-                          dest[0], dest[1], dest[2]);
-              if(length + steps_size < polarSensor->maxDistance) {
-                steps++;
-                dGeomRaySetLength(elem.geom, steps_size);
-              }
-              else {
-                dGeomRaySetLength(elem.geom, polarSensor->maxDistance- length);
-                done = true;
-              }
-              if(theWorld->handleCollision(elem.geom)) {
-                elem.gd->value += length;
-                done = true;
-              }
-              if(!done) length = steps_size*steps;
+          else {
+            rayDirections.resize(3, last-first);
+            for(size_t i=first; i<last; ++i) {
+              rayDirections.col(i-first) = sensor_list[i].ray_direction;
             }
-            dGeomDisable(elem.geom);
+            rayDirections = nodeRot * rayDirections;
+          }
+          // the rays are only tested against the geoms within their range
+          resetRayAABB(rayAABB, pos);
+          for(int i=0; i<rayDirections.cols(); ++i) {
+            addRayToAABB(rayAABB, pos, rayDirections.col(i),
+                         head.polarSensor->maxDistance);
+          }
+          theWorld->getRayCandidates(rayAABB, nGeom, nBody, &rayCandidates);
+          for(size_t i=first; i<first+rayDirections.cols(); ++i) {
+            castPolarRay(sensor_list[i], pos, rayDirections.col(i-first));
           }
-          (*polarSensor)[elem.index] = elem.gd->value;
-          elem.gd->value = polarSensor->maxDistance;
         }
-    
-        BaseGridIntersectionSensor *polarGridSensor;
-        polarGridSensor = dynamic_cast<BaseGridIntersectionSensor*>(iter->sensor);
+        else if(head.gridSensor) {
+          resetRayAABB(rayAABB, pos);
+          for(size_t i=first; i<last; ++i) {
+            utils::Vector offset = nodeRot * sensor_list[i].ray_pos_offset;
+            dReal start[3] = {pos[0] + offset[0], pos[1] + offset[1],
+                              pos[2] + offset[2]};
+            addRayToAABB(rayAABB, start,
+                         nodeRot * sensor_list[i].ray_direction,
+                         head.gridSensor->maxDistance);
+          }
+          theWorld->getRayCandidates(rayAABB, nGeom, nBody, &rayCandidates);
+          for(size_t i=first; i<last; ++i) {
+            castGridRay(sensor_list[i], pos, nodeRot);
+          }
+        }
+      }
+    }
 
-        if(polarGridSensor) {
-          sensor_list_element elem = *iter;
+    void NodePhysics::resetRayAABB(dReal *aabb, const dReal *pos) {
+      for(int k=0; k<3; ++k) {
+        aabb[2*k] = aabb[2*k+1] = pos[k];
+      }
+    }
 
-          if(physics_thread) {
-        
-            tmp[0] = elem.ray_direction.x();
-            tmp[1] = elem.ray_direction.y();
-            tmp[2] = elem.ray_direction.z();
-            dMULTIPLY0_331(dest, rot, tmp);
+    void NodePhysics::addRayToAABB(dReal *aabb, const dReal *start,
+                                   const utils::Vector &direction,
+                                   dReal length) {
+      // ODE normalizes the direction of a ray
+      double norm = direction.norm();
+      if(norm > 0.0) length /= norm;
+      for(int k=0; k<3; ++k) {
+        dReal a = start[k], b = start[k] + direction[k]*length;
+        if(a > b) std::swap(a, b);
+        if(a < aabb[2*k]) aabb[2*k] = a;
+        if(b > aabb[2*k+1]) aabb[2*k+1] = b;
+      }
+    }
+
+    void NodePhysics::castPolarRay(const sensor_list_element &elem,
+                                   const dReal *pos,
+                                   const utils::Vector &dest) {
+      dReal steps_size = 1.0, length = 0.0, depth;
+      bool done = false;
+      int steps = 0;
 
-            tmp[0] = elem.ray_pos_offset.x();
-            tmp[1] = elem.ray_pos_offset.y();
-            tmp[2] = elem.ray_pos_offset.z();
-            dMULTIPLY0_331(posOffset, rot, tmp);
+      dGeomEnable(elem.geom);
+      // make here the collision check
+      while (!done) {
+        dGeomRaySet(elem.geom,
+                    pos[0] + dest[0]*steps_size*steps,
+                    pos[1] + dest[1]*steps_size*steps,
+                    pos[2] + dest[2]*steps_size*steps,
+                    dest[0], dest[1], dest[2]);
+        if(length + steps_size < elem.polarSensor->maxDistance) {
+          steps++;
+          dGeomRaySetLength(elem.geom, steps_size);
+        }
+        else {
+          dGeomRaySetLength(elem.geom, elem.polarSensor->maxDistance- length);
+          done = true;
+        }
+        if(theWorld->collideRay(elem.geom, rayCandidates, &depth)) {
+          if(depth < elem.gd->value) elem.gd->value = depth;
+          elem.gd->value += length;
+          done = true;
+        }
+        if(!done) length = steps_size*steps;
+      }
+      dGeomDisable(elem.geom);
+      (*elem.polarSensor)[elem.index] = elem.gd->value;
+      elem.gd->value = elem.polarSensor->maxDistance;
+    }
 
-            dGeomEnable(elem.geom);
+    void NodePhysics::castGridRay(const sensor_list_element &elem,
+                                  const dReal *pos,
+                                  const Eigen::Matrix3d &nodeRot) {
+      utils::Vector dest = nodeRot * elem.ray_direction;
+      utils::Vector posOffset = nodeRot * elem.ray_pos_offset;
+      dReal depth;
 
-            dGeomRaySet(elem.geom, pos[0] + posOffset[0],
-                        pos[1] + posOffset[1],
-                        pos[2] + posOffset[2],
-                        dest[0], dest[1], dest[2]);
+      dGeomEnable(elem.geom);
 
-            dGeomRaySetLength(elem.geom, polarGridSensor->maxDistance);
-            theWorld->handleCollision(elem.geom);
-            dGeomDisable(elem.geom);        
-          }
-          (*polarGridSensor)[elem.index] = elem.gd->value;
-          elem.gd->value = polarGridSensor->maxDistance;      
-        }
-      } // end for loop.
+      dGeomRaySet(elem.geom, pos[0] + posOffset[0],
+                  pos[1] + posOffset[1],
+                  pos[2] + posOffset[2],
+                  dest[0], dest[1], dest[2]);
+
+      dGeomRaySetLength(elem.geom, elem.gridSensor->maxDistance);
+      if(theWorld->collideRay(elem.geom, rayCandidates, &depth) &&
+         depth < elem.gd->value) {
+        elem.gd->value = depth;
+      }
+      dGeomDisable(elem.geom);
+      (*elem.gridSensor)[elem.index] = elem.gd->value;
+      elem.gd->value = elem.gridSensor->maxDistance;
     }
 
     /**
@@ -1833,7 +1900,7 @@ namespace mars {
         //if(contactsPtr->operator[](0).geom.depth < 0.0) contactsPtr->operator[](0).geom.depth = 0.0; // Why 0 and not i ?
         dJointID c=dJointCreateContact(world, contactgroup, &contactsPtr->operator[](i));
         dJointFeedback *fb;
-        fb = (dJointFeedback*)malloc(sizeof(dJointFeedback));
+        fb = theWorld->newContactFeedback();
         dJointSetFeedback(c, fb); // ODE
         #ifdef DEBUG_ADD_CONTACTS
           if (isnan(abs(fb->f1[0]))||isnan(abs(fb->f1[1]))||isnan(abs(fb->f1[2])) || isnan(abs(fb->f1[3])) ||
@@ -41,8 +41,15 @@
 #endif
 
 namespace mars {
+  namespace interfaces {
+    class BasePolarIntersectionSensor;
+    class BaseGridIntersectionSensor;
+  }
+
   namespace sim {
 
+    class RotatingRaySensor;
+
     /*
      * we need a data structure to handle different collision parameter
      * and we need to save the collision_data somewhere
@@ -58,6 +65,7 @@ namespace mars {
         filter_depth = -1.;
         filter_angle = -1.;
         filter_radius = -1.0;
+        params_id = 0;
       }
 
       geom_data(){
@@ -66,7 +74,8 @@ namespace mars {
       unsigned long id;
       int num_ground_collisions;
       std::vector<utils::Vector> contact_points;
-      std::list<unsigned long> contact_ids;
+      // vectors keep their capacity when they are cleared every step
+      std::vector<unsigned long> contact_ids;
       std::vector<dJointFeedback*> ground_feedbacks;
       bool node1;
       interfaces::contact_params c_params;
@@ -77,6 +86,10 @@ namespace mars {
       dBodyID parent_body;
       dReal filter_depth, filter_angle, filter_radius;
       utils::Vector filter_sphere;
+      // identifies the current contact parameters and filters, a new id is
+      // assigned when they change (except for the friction direction value);
+      // 0 means the geom has no id yet
+      unsigned long params_id;
     };
 
     struct sensor_list_element {
@@ -87,6 +100,10 @@ namespace mars {
       utils::Vector ray_pos_offset;
       unsigned int index;
       dReal updateTime;
+      // the sensor casted once to the interface the rays are handled by
+      interfaces::BasePolarIntersectionSensor *polarSensor;
+      interfaces::BaseGridIntersectionSensor *gridSensor;
+      RotatingRaySensor *rotatingSensor;
     };
 
     /**
@@ -156,6 +173,11 @@ namespace mars {
       interfaces::terrainStruct *terrain;
       dReal *height_data;
       std::vector<sensor_list_element> sensor_list;
+      // world frame ray directions of the sensor handled at the moment
+      Eigen::Matrix<double, 3, Eigen::Dynamic> rayDirections;
+      // the range of the sensor handled at the moment and the geoms in it
+      dReal rayAABB[6];
+      std::vector<dGeomID> rayCandidates;
       bool createMesh(interfaces::NodeData *node);
       bool createBox(interfaces::NodeData *node);
       bool createSphere(interfaces::NodeData *node);
@@ -165,6 +187,13 @@ namespace mars {
       bool createHeightfield(interfaces::NodeData *node);
       void setProperties(interfaces::NodeData *node);
       void setInertiaMass(interfaces::NodeData *node);
+      void castPolarRay(const sensor_list_element &elem, const dReal *pos,
+                        const utils::Vector &dest);
+      void castGridRay(const sensor_list_element &elem, const dReal *pos,
+                       const Eigen::Matrix3d &nodeRot);
+      static void resetRayAABB(dReal *aabb, const dReal *pos);
+      static void addRayToAABB(dReal *aabb, const dReal *start,
+                               const utils::Vector &direction, dReal length);
     };
 
   } // end of namespace sim
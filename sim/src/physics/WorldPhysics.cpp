@@ -48,6 +48,10 @@
 #include <mars/interfaces/sim/NodeManagerInterface.h>
 #include <mars/interfaces/Logging.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
 
 
 #define EPSILON 1e-10
@@ -64,6 +68,9 @@ namespace mars {
 
     PhysicsError WorldPhysics::error = PHYSICS_NO_ERROR;
 
+    // the pair cache is cleared when it grows beyond this size
+    static const size_t maxContactPairCacheSize = 4096;
+
     void myMessageFunction(int errnum, const char *msg, va_list ap) {
       CPP_UNUSED(errnum);
       LOG_INFO(msg, ap);
@@ -96,6 +103,8 @@ namespace mars {
 
       this->control = control;
       draw_contact_points = 0;
+      contactsDrawn = false;
+      contactDraw.lineWidth = 10;
       fast_step = 0;
       world_cfm = 1e-10;
       world_erp = 0.1;
@@ -112,9 +121,14 @@ namespace mars {
       log_contacts = 0;
       max_angular_speed = 10.0; // I guess this is rad/s
       max_correcting_vel = 5.0;
+      contact_merge_distance = 0.0;
+      contact_reuse_tolerance = 0.0;
+      numContactFeedbacks = 0;
+      lastContactParamsId = 0;
 
       // the step size in seconds
       step_size = 0.01;
+      num_sub_steps = 1;
       // dInitODE is relevant for using trimesh objects as correct as
       // possible in the ode implementation
       MutexLocker locker(&iMutex);
@@ -202,10 +216,6 @@ namespace mars {
         // if usefull for some tests a ground can be created here
         plane = 0; //dCreatePlane (space,0,0,1,0);
         world_init = 1;
-        drawStruct draw;
-        draw.ptr_draw = (DrawInterface*)this;
-        if(control->graphics)
-          control->graphics->addDrawItems(&draw);
       }
     }
 
@@ -228,6 +238,15 @@ namespace mars {
         dWorldDestroy(world);
         world_init = 0;
       }
+      contactPairCache.clear();
+      contactCache.clear();
+      lastContactCache.clear();
+      contactFeedbackPool.clear();
+      numContactFeedbacks = 0;
+      if(contactsDrawn && control->graphics) {
+        control->graphics->removeDebugDraw("physics/contacts");
+      }
+      contactsDrawn = false;
       // else debug something
     }
 
@@ -299,15 +318,10 @@ namespace mars {
         data->ground_feedbacks.clear();
       }
 
-      std::vector<dJointFeedback*>::iterator iter;
       // Clear Previous Contact Feedback
-      for(iter = contact_feedback_list.begin();
-          iter != contact_feedback_list.end(); iter++) {
-        free((*iter));
-      }
-      contact_feedback_list.clear();
-      // Clear draw_intern
-      draw_intern.clear();
+      numContactFeedbacks = 0;
+      // Clear the contact visualization
+      contactDraw.clear();
 
       // Clear contacts
       dJointGroupEmpty(contactgroup);
@@ -315,28 +329,13 @@ namespace mars {
 
     void WorldPhysics::draw_contacts(const mars::sim::ContactsPhysics & colContacts)
     {
+      if(!draw_contact_points) return;
       for(int i=0; i<colContacts.numContacts; i++)
       {
-        draw_item item;
-        item.id = 0;
-        item.type = DRAW_LINE;
-        item.draw_state = DRAW_STATE_CREATE;
-        item.point_size = 10;
-        item.myColor.r = 1;
-        item.myColor.g = 0;
-        item.myColor.b = 0;
-        item.myColor.a = 1;
-        item.label = "";
-        item.t_width = item.t_height = 0;
-        item.texture = "";
-        item.get_light = 0;
-        item.start.x() = colContacts.contactsPtr->operator[](i).geom.pos[0];
-        item.start.y() = colContacts.contactsPtr->operator[](i).geom.pos[1];
-        item.start.z() = colContacts.contactsPtr->operator[](i).geom.pos[2];
-        item.end.x() = colContacts.contactsPtr->operator[](i).geom.pos[0] + colContacts.contactsPtr->operator[](i).geom.normal[0];
-        item.end.y() = colContacts.contactsPtr->operator[](i).geom.pos[1] + colContacts.contactsPtr->operator[](i).geom.normal[1];
-        item.end.z() = colContacts.contactsPtr->operator[](i).geom.pos[2] + colContacts.contactsPtr->operator[](i).geom.normal[2];
-        draw_intern.push_back(item);
+        const dContactGeom &geom = colContacts.contactsPtr->operator[](i).geom;
+        Vector start(geom.pos[0], geom.pos[1], geom.pos[2]);
+        Vector normal(geom.normal[0], geom.normal[1], geom.normal[2]);
+        contactDraw.addLine(start, start+normal, Color(1, 0, 0, 1));
       }
     }
 
@@ -357,12 +356,6 @@ namespace mars {
         std::shared_ptr<NodePhysics> nodePhysPtr = std::dynamic_pointer_cast<NodePhysics>(nodeIfPtr);
         std::vector<dJointFeedback*> contactFeedbacks =
           nodePhysPtr->addContacts(colContacts, world, contactgroup);
-        std::vector<utils::Vector> * contactPoints = new std::vector<utils::Vector>();
-        nodePhysPtr->getContactPoints(contactPoints);
-        for (auto it = std::begin(contactFeedbacks); it !=std::end(contactFeedbacks); ++it)
-        {
-          contact_feedback_list.push_back(*it);
-        }
         // Some feedback joints might not be set even if contacts exists if
         // errors are detected.
         // Currently though all are used but for future potential fixes that do
@@ -427,18 +420,29 @@ namespace mars {
         if (create_contacts){
           setContactsFromPlugins();
         }
-        // add external contacts
+        // add external contacts, they are kept for all sub-steps
         for(auto it=externalContacts.begin(); it!=externalContacts.end(); ++it) {
           dJointID joint=dJointCreateContact(world, contactgroup, &(it->contact));
           dJointAttach(joint, it->body, 0);
         }
-        externalContacts.clear();
 
+        // the contacts of the last step can be reused for pairs that
+        // did not move, pairs that are not colliding anymore are dropped
+        lastContactCache.swap(contactCache);
+        contactCache.clear();
         dSpaceCollide(space,this, &WorldPhysics::callbackForward);
 
-        drawLock.lock();
-        draw_extern.swap(draw_intern);
-        drawLock.unlock();
+        // the contacts of this step replace the ones of the last step
+        if(control->graphics) {
+          if(draw_contact_points) {
+            control->graphics->swapDebugDraw("physics/contacts", &contactDraw);
+            contactsDrawn = true;
+          }
+          else if(contactsDrawn) {
+            control->graphics->removeDebugDraw("physics/contacts");
+            contactsDrawn = false;
+          }
+        }
 
         /// then calculate the next state for a time of step_size seconds
         try {
@@ -587,6 +591,283 @@ namespace mars {
       return step_size;
     }
 
+    /**
+     * \brief Merges contacts that are closer than maxDistance and have a
+     *   similar normal. The deepest contact of a group is kept.
+     *
+     * \return The number of remaining contacts at the front of the array.
+     */
+    static int mergeContacts(dContact *contact, int numc, dReal maxDistance) {
+      dReal maxDistance2 = maxDistance*maxDistance;
+      int count = 0;
+      for(int i=0; i<numc; ++i) {
+        bool merged = false;
+        for(int j=0; j<count; ++j) {
+          dVector3 d;
+          d[0] = contact[i].geom.pos[0] - contact[j].geom.pos[0];
+          d[1] = contact[i].geom.pos[1] - contact[j].geom.pos[1];
+          d[2] = contact[i].geom.pos[2] - contact[j].geom.pos[2];
+          if(dDOT(d, d) < maxDistance2 &&
+             dDOT(contact[i].geom.normal, contact[j].geom.normal) > 0.9) {
+            if(contact[i].geom.depth > contact[j].geom.depth) {
+              contact[j].geom = contact[i].geom;
+            }
+            merged = true;
+            break;
+          }
+        }
+        if(!merged) {
+          if(count != i) contact[count].geom = contact[i].geom;
+          ++count;
+        }
+      }
+      return count;
+    }
+
+    /**
+     * \brief Combines the contact parameters of two geoms into the surface
+     *   parameters and contact filters used for their contacts.
+     */
+    void WorldPhysics::computeContactPairParams(geom_data *geom_data1,
+                                                geom_data *geom_data2,
+                                                contact_pair_params *params) {
+      memset(&params->surface, 0, sizeof(dSurfaceParameters));
+      params->max_num_contacts = geom_data1->c_params.max_num_contacts;
+      if(geom_data2->c_params.max_num_contacts < params->max_num_contacts) {
+        params->max_num_contacts = geom_data2->c_params.max_num_contacts;
+      }
+      params->fdir1_geom = 0;
+      params->depth_correction = (geom_data1->c_params.depth_correction +
+                                  geom_data2->c_params.depth_correction);
+
+      params->filter_depth = -1.0;
+      if(geom_data1->filter_depth > params->filter_depth) {
+        params->filter_depth = geom_data1->filter_depth;
+      }
+      if(geom_data2->filter_depth > params->filter_depth) {
+        params->filter_depth = geom_data2->filter_depth;
+      }
+      params->filter_radius = -1.0;
+      params->filter_sphere = Vector(0.0, 0.0, 0.0);
+      if(geom_data1->filter_radius > params->filter_radius) {
+        params->filter_radius = geom_data1->filter_radius;
+        params->filter_sphere = geom_data1->filter_sphere;
+      }
+      if(geom_data2->filter_radius > params->filter_radius) {
+        params->filter_radius = geom_data2->filter_radius;
+        params->filter_sphere = geom_data2->filter_sphere;
+      }
+
+      // frist we set the softness values:
+      params->surface.mode = dContactSoftERP | dContactSoftCFM;
+      params->surface.soft_cfm = (geom_data1->c_params.cfm +
+                                  geom_data2->c_params.cfm)/2;
+      params->surface.soft_erp = (geom_data1->c_params.erp +
+                                  geom_data2->c_params.erp)/2;
+      // then check if one of the geoms want to use the pyramid approximation
+      if(geom_data1->c_params.approx_pyramid ||
+         geom_data2->c_params.approx_pyramid)
+        params->surface.mode |= dContactApprox1;
+
+      // Then check the friction for both directions
+      params->surface.mu = (geom_data1->c_params.friction1 +
+                            geom_data2->c_params.friction1)/2;
+      params->surface.mu2 = (geom_data1->c_params.friction2 +
+                             geom_data2->c_params.friction2)/2;
+
+      if(params->surface.mu != params->surface.mu2)
+        params->surface.mode |= dContactMu2;
+
+      if(geom_data1->c_params.rolling_friction > EPSILON ||
+         geom_data2->c_params.rolling_friction > EPSILON) {
+        params->surface.mode |= dContactRolling;
+        params->surface.rho = geom_data1->c_params.rolling_friction + geom_data2->c_params.rolling_friction;
+        // fprintf(stderr, "set rolling friction to: %g\n", params->surface.rho);
+        if(geom_data1->c_params.rolling_friction2 > EPSILON ||
+           geom_data2->c_params.rolling_friction2 > EPSILON) {
+          params->surface.rho2 = geom_data1->c_params.rolling_friction2 + geom_data2->c_params.rolling_friction2;
+        }
+        else {
+          params->surface.rho2 = geom_data1->c_params.rolling_friction + geom_data2->c_params.rolling_friction;
+        }
+        if(geom_data1->c_params.spinning_friction > EPSILON ||
+           geom_data2->c_params.spinning_friction > EPSILON) {
+          params->surface.rhoN = geom_data1->c_params.spinning_friction + geom_data2->c_params.spinning_friction;
+        }
+        else {
+          params->surface.rhoN = 0.0;
+        }
+      }
+
+      // check if we have to calculate friction direction1
+      if(geom_data1->c_params.friction_direction1 ||
+         geom_data2->c_params.friction_direction1) {
+        // here the calculation becomes more complicated
+        // maybe we should make some restrictions
+        // so -> we only use friction motion in friction direction 1
+        // the friction motion is only set if a local vector for friction
+        // direction 1 is given
+        // the steps for the calculation:
+        // 1. rotate the local vectors to global coordinates
+        // 2. scale the vectors to the length of the motion if given
+        // 3. vector 3 =  vector 1 - vector 2
+        // 4. get the length of vector 3
+        // 5. set vector 3 as friction direction 1
+        // 6. set motion 1 to the length
+        params->surface.mode |= dContactFDir1;
+        if(!geom_data2->c_params.friction_direction1) {
+          params->fdir1_geom = 1;
+          if(geom_data1->c_params.motion1) {
+            params->surface.mode |= dContactMotion1;
+            params->surface.motion1 = geom_data1->c_params.motion1;
+          }
+        }
+        else if(!geom_data1->c_params.friction_direction1) {
+          params->fdir1_geom = 2;
+          if(geom_data2->c_params.motion1) {
+            params->surface.mode |= dContactMotion1;
+            params->surface.motion1 = geom_data2->c_params.motion1;
+          }
+        }
+        else {
+          // the calculation steps as mentioned above
+          fprintf(stderr, "the calculation for friction directen set for both nodes is not done yet.\n");
+        }
+      }
+
+      // then check for fds
+      if(geom_data1->c_params.fds1 || geom_data2->c_params.fds1) {
+        params->surface.mode |= dContactSlip1;
+        params->surface.slip1 = (geom_data1->c_params.fds1 +
+                                 geom_data2->c_params.fds1);
+      }
+      if(geom_data1->c_params.fds2 || geom_data2->c_params.fds2) {
+        params->surface.mode |= dContactSlip2;
+        params->surface.slip2 = (geom_data1->c_params.fds2 +
+                                 geom_data2->c_params.fds2);
+      }
+      if(geom_data1->c_params.bounce || geom_data2->c_params.bounce) {
+        params->surface.mode |= dContactBounce;
+        params->surface.bounce = (geom_data1->c_params.bounce +
+                                  geom_data2->c_params.bounce);
+        if(geom_data1->c_params.bounce_vel > geom_data2->c_params.bounce_vel)
+          params->surface.bounce_vel = geom_data1->c_params.bounce_vel;
+        else
+          params->surface.bounce_vel = geom_data2->c_params.bounce_vel;
+      }
+    }
+
+    /**
+     * \brief Returns the combined parameters of a geom pair. They are only
+     *   recalculated if the contact parameters of one of the geoms changed.
+     */
+    const contact_pair_params& WorldPhysics::getContactPairParams(geom_data *geom_data1,
+                                                                  geom_data *geom_data2) {
+      static contact_pair_params uncached;
+      if(!geom_data1->params_id || !geom_data2->params_id) {
+        computeContactPairParams(geom_data1, geom_data2, &uncached);
+        return uncached;
+      }
+      std::pair<unsigned long, unsigned long> key(geom_data1->params_id,
+                                                  geom_data2->params_id);
+      std::map<std::pair<unsigned long, unsigned long>,
+               contact_pair_params>::iterator it = contactPairCache.find(key);
+      if(it != contactPairCache.end()) return it->second;
+
+      // entries of outdated ids are never used again
+      if(contactPairCache.size() >= maxContactPairCacheSize) {
+        contactPairCache.clear();
+      }
+      contact_pair_params &params = contactPairCache[key];
+      computeContactPairParams(geom_data1, geom_data2, &params);
+      return params;
+    }
+
+    static void getGeomPose(dGeomID geom, dReal *pos, dReal *rot) {
+      // planes are not placeable and can't move
+      if(dGeomGetClass(geom) == dPlaneClass) {
+        memset(pos, 0, 3*sizeof(dReal));
+        memset(rot, 0, 12*sizeof(dReal));
+        return;
+      }
+      memcpy(pos, dGeomGetPosition(geom), 3*sizeof(dReal));
+      memcpy(rot, dGeomGetRotation(geom), 12*sizeof(dReal));
+    }
+
+    static bool geomMoved(dGeomID geom, const dReal *pos, const dReal *rot,
+                          dReal tolerance) {
+      dReal p[3], r[12];
+      getGeomPose(geom, p, r);
+      dReal d0 = p[0]-pos[0], d1 = p[1]-pos[1], d2 = p[2]-pos[2];
+      if(d0*d0 + d1*d1 + d2*d2 > tolerance*tolerance) return true;
+      for(int i=0; i<12; ++i) {
+        if(fabs(r[i]-rot[i]) > tolerance) return true;
+      }
+      return false;
+    }
+
+    /**
+     * \brief Copies the contacts of the last step into contact if both
+     *   geoms of the pair did not move since they were calculated.
+     *
+     * \return The number of contacts or -1 if the narrow phase has to run.
+     */
+    int WorldPhysics::getCachedContacts(dGeomID o1, dGeomID o2,
+                                        geom_data *geom_data1,
+                                        geom_data *geom_data2,
+                                        dContact *contact, int maxNumContacts) {
+      std::pair<dGeomID, dGeomID> key(o1, o2);
+      std::map<std::pair<dGeomID, dGeomID>, contact_cache_entry>::iterator it;
+      it = lastContactCache.find(key);
+      if(it == lastContactCache.end()) return -1;
+      contact_cache_entry &entry = it->second;
+      if(entry.params_id1 != geom_data1->params_id ||
+         entry.params_id2 != geom_data2->params_id ||
+         (int)entry.contacts.size() > maxNumContacts ||
+         geomMoved(o1, entry.pos1, entry.rot1, contact_reuse_tolerance) ||
+         geomMoved(o2, entry.pos2, entry.rot2, contact_reuse_tolerance)) {
+        return -1;
+      }
+      int numc = (int)entry.contacts.size();
+      for(int i=0; i<numc; ++i) {
+        contact[i].geom = entry.contacts[i];
+      }
+      // keep the poses of the original calculation to not accumulate
+      // the motion over several steps
+      std::swap(contactCache[key], entry);
+      return numc;
+    }
+
+    void WorldPhysics::cacheContacts(dGeomID o1, dGeomID o2,
+                                     geom_data *geom_data1,
+                                     geom_data *geom_data2,
+                                     dContact *contact, int numc) {
+      contact_cache_entry &entry = contactCache[std::make_pair(o1, o2)];
+      entry.params_id1 = geom_data1->params_id;
+      entry.params_id2 = geom_data2->params_id;
+      getGeomPose(o1, entry.pos1, entry.rot1);
+      getGeomPose(o2, entry.pos2, entry.rot2);
+      entry.contacts.resize(numc);
+      for(int i=0; i<numc; ++i) {
+        entry.contacts[i] = contact[i].geom;
+      }
+    }
+
+    unsigned long WorldPhysics::newContactParamsId(void) {
+      return ++lastContactParamsId;
+    }
+
+    /**
+     * \brief Returns a feedback struct for a contact joint of the current
+     *   step. The structs are reused after clearPreviousStep.
+     */
+    dJointFeedback* WorldPhysics::newContactFeedback(void) {
+      if(numContactFeedbacks == contactFeedbackPool.size()) {
+        contactFeedbackPool.push_back(dJointFeedback());
+      }
+      return &contactFeedbackPool[numContactFeedbacks++];
+    }
+
     /**
      * \brief In this function the collision handling from ode is performed.
      *
@@ -608,7 +889,7 @@ namespace mars {
       int numc;
       //up to MAX_CONTACTS contact per Box-box
       //dContact contact[MAX_CONTACTS];
-      dVector3 v1, v;
+      dVector3 v;
       //dMatrix3 R;
       dReal dot;
 
@@ -666,217 +947,45 @@ namespace mars {
 
       if(!b1 && !b2 && !geom_data1->ray_sensor && !geom_data2->ray_sensor) return;
 
-      int maxNumContacts = 0;
-      if(geom_data1->c_params.max_num_contacts <
-         geom_data2->c_params.max_num_contacts) {
-        maxNumContacts = geom_data1->c_params.max_num_contacts;
-      }
-      else {
-        maxNumContacts = geom_data2->c_params.max_num_contacts;
+      const contact_pair_params &pair = getContactPairParams(geom_data1,
+                                                             geom_data2);
+      int maxNumContacts = pair.max_num_contacts;
+      if(maxNumContacts < 1) return;
+      if((int)contactBuffer.size() < maxNumContacts) {
+        contactBuffer.resize(maxNumContacts);
       }
-      dContact *contact = new dContact[maxNumContacts];
-
-      double filter_depth = -1.0;
-      if(geom_data1->filter_depth > filter_depth) {
-        filter_depth = geom_data1->filter_depth;
-      }
-      if(geom_data2->filter_depth > filter_depth) {
-        filter_depth = geom_data2->filter_depth;
-      }
-      double filter_angle = 0.5;
-      if(geom_data1->filter_angle > 0.0) {
-        filter_angle = geom_data1->filter_angle;
-      }
-      if(geom_data2->filter_angle > 0.0 and  geom_data2->filter_angle > geom_data1->filter_angle) {
-        filter_angle = geom_data2->filter_angle;
-      }
-
-      double filter_radius = -1.0;
-      Vector filter_sphere;
-      if(geom_data1->filter_radius > filter_radius) {
-        filter_radius = geom_data1->filter_radius;
-        filter_sphere = geom_data1->filter_sphere;
-      }
-      if(geom_data2->filter_radius > filter_radius) {
-        filter_radius = geom_data2->filter_radius;
-        filter_sphere = geom_data2->filter_sphere;
-      }
-
-
-      //for granular test
-      //if( (plane != o2) && (plane !=o1)) return ;
-
-
-      /*
-     /// we use the geomData to handle some special cases
-     void* geom_data1 = dGeomGetData(o1);
-     void* geom_data2 = dGeomGetData(o2);
-
-     /// one case is, that we don't wont to handle a collision between some special
-     /// geoms beweet each other and the ground
-     if((geom_data1 && ((robot_geom*)geom_data1)->type & 16)) {
-     if(plane == o2) return;
-     if((geom_data2 && ((robot_geom*)geom_data2)->type & 16)) return;
-     }
-     else if((geom_data2 && ((robot_geom*)geom_data2)->type & 16) && (plane == o1)) return;
-
-     /// an other case is a ray geom that we use simulate ray sensors
-     /// this geom has to be handled in a different way
-     if((geom_data1 && ((robot_geom*)geom_data1)->type & 8) ||
-     (geom_data2 && ((robot_geom*)geom_data2)->type & 8)) {
-     int n;
-     const int N = MAX_CONTACTS;
-     dContactGeom contact[N];
-
-     n = dCollide (o2,o1,N,contact,sizeof(dContactGeom));
-     if (n > 0) {
-     //const dReal ss[3] = {1,0.01,0.01};
-     for (i=0; i<n; i++) {
-     contact[i].pos[2] += Z_OFFSET;
-     if(contact[i].depth > 0.01){
-     if(geom_data1 && ((robot_geom*)geom_data1)->type & 8)
-     ((robot_geom*)geom_data1)->i_length = contact[0].depth;
-     if(geom_data2 && ((robot_geom*)geom_data2)->type & 8)
-     ((robot_geom*)geom_data2)->i_length = contact[0].depth;
-     }
-     }
-     }
-     return;
-     }
-      */
-
-
-
-      // frist we set the softness values:
-      contact[0].surface.mode = dContactSoftERP | dContactSoftCFM;
-      contact[0].surface.soft_cfm = (geom_data1->c_params.cfm +
-                                     geom_data2->c_params.cfm)/2;
-      contact[0].surface.soft_erp = (geom_data1->c_params.erp +
-                                     geom_data2->c_params.erp)/2;
-      // then check if one of the geoms want to use the pyramid approximation
-      if(geom_data1->c_params.approx_pyramid ||
-         geom_data2->c_params.approx_pyramid)
-        contact[0].surface.mode |= dContactApprox1;
-
-      // Then check the friction for both directions
-      contact[0].surface.mu = (geom_data1->c_params.friction1 +
-                               geom_data2->c_params.friction1)/2;
-      contact[0].surface.mu2 = (geom_data1->c_params.friction2 +
-                                geom_data2->c_params.friction2)/2;
-
-      if(contact[0].surface.mu != contact[0].surface.mu2)
-        contact[0].surface.mode |= dContactMu2;
-
-      if(geom_data1->c_params.rolling_friction > EPSILON ||
-         geom_data2->c_params.rolling_friction > EPSILON) {
-        contact[0].surface.mode |= dContactRolling;
-        contact[0].surface.rho = geom_data1->c_params.rolling_friction + geom_data2->c_params.rolling_friction;
-        // fprintf(stderr, "set rolling friction to: %g\n", contact[0].surface.rho);
-        if(geom_data1->c_params.rolling_friction2 > EPSILON ||
-           geom_data2->c_params.rolling_friction2 > EPSILON) {
-          contact[0].surface.rho2 = geom_data1->c_params.rolling_friction2 + geom_data2->c_params.rolling_friction2;
-        }
-        else {
-          contact[0].surface.rho2 = geom_data1->c_params.rolling_friction + geom_data2->c_params.rolling_friction;
-        }
-        if(geom_data1->c_params.spinning_friction > EPSILON ||
-           geom_data2->c_params.spinning_friction > EPSILON) {
-          contact[0].surface.rhoN = geom_data1->c_params.spinning_friction + geom_data2->c_params.spinning_friction;
-        }
-        else {
-          contact[0].surface.rhoN = 0.0;
+      dContact *contact = &contactBuffer[0];
+      const Vector *fdir1 = 0;
+      if(pair.fdir1_geom == 1) fdir1 = geom_data1->c_params.friction_direction1;
+      else if(pair.fdir1_geom == 2) fdir1 = geom_data2->c_params.friction_direction1;
+      for (i=0;i<maxNumContacts;i++){
+        contact[i].surface = pair.surface;
+        if(fdir1) {
+          contact[i].fdir1[0] = fdir1->x();
+          contact[i].fdir1[1] = fdir1->y();
+          contact[i].fdir1[2] = fdir1->z();
         }
       }
-
-      // check if we have to calculate friction direction1
-      if(geom_data1->c_params.friction_direction1 ||
-         geom_data2->c_params.friction_direction1) {
-        // here the calculation becomes more complicated
-        // maybe we should make some restrictions
-        // so -> we only use friction motion in friction direction 1
-        // the friction motion is only set if a local vector for friction
-        // direction 1 is given
-        // the steps for the calculation:
-        // 1. rotate the local vectors to global coordinates
-        // 2. scale the vectors to the length of the motion if given
-        // 3. vector 3 =  vector 1 - vector 2
-        // 4. get the length of vector 3
-        // 5. set vector 3 as friction direction 1
-        // 6. set motion 1 to the length
-        contact[0].surface.mode |= dContactFDir1;
-        if(!geom_data2->c_params.friction_direction1) {
-          // get the orientation of the geom
-          //dGeomGetQuaternion(o1, v);
-          //dRfromQ(R, v);
-          // copy the friction direction
-          v1[0] = geom_data1->c_params.friction_direction1->x();
-          v1[1] = geom_data1->c_params.friction_direction1->y();
-          v1[2] = geom_data1->c_params.friction_direction1->z();
-          // translate the friction direction to global coordinates
-          // and set friction direction for contact
-          //dMULTIPLY0_331(contact[0].fdir1, R, v1);
-          contact[0].fdir1[0] = v1[0];
-          contact[0].fdir1[1] = v1[1];
-          contact[0].fdir1[2] = v1[2];
-          if(geom_data1->c_params.motion1) {
-            contact[0].surface.mode |= dContactMotion1;
-            contact[0].surface.motion1 = geom_data1->c_params.motion1;
-          }
-        }
-        else if(!geom_data1->c_params.friction_direction1) {
-          // get the orientation of the geom
-          //dGeomGetQuaternion(o2, v);
-          //dRfromQ(R, v);
-          // copy the friction direction
-          v1[0] = geom_data2->c_params.friction_direction1->x();
-          v1[1] = geom_data2->c_params.friction_direction1->y();
-          v1[2] = geom_data2->c_params.friction_direction1->z();
-          // translate the friction direction to global coordinates
-          // and set friction direction for contact
-          //dMULTIPLY0_331(contact[0].fdir1, R, v1);
-          contact[0].fdir1[0] = v1[0];
-          contact[0].fdir1[1] = v1[1];
-          contact[0].fdir1[2] = v1[2];
-          if(geom_data2->c_params.motion1) {
-            contact[0].surface.mode |= dContactMotion1;
-            contact[0].surface.motion1 = geom_data2->c_params.motion1;
-          }
+      double filter_depth = pair.filter_depth;
+      double filter_radius = pair.filter_radius;
+      const Vector &filter_sphere = pair.filter_sphere;
+
+      numc = -1;
+      if(create_contacts && contact_reuse_tolerance > 0.0) {
+        numc = getCachedContacts(o1, o2, geom_data1, geom_data2,
+                                 contact, maxNumContacts);
+      }
+      if(numc < 0) {
+        numc=dCollide(o1,o2, maxNumContacts, &contact[0].geom,sizeof(dContact));
+        if(numc > 1 && contact_merge_distance > 0.0) {
+          numc = mergeContacts(contact, numc, contact_merge_distance);
         }
-        else {
-          // the calculation steps as mentioned above
-          fprintf(stderr, "the calculation for friction directen set for both nodes is not done yet.\n");
+        if(create_contacts && contact_reuse_tolerance > 0.0) {
+          cacheContacts(o1, o2, geom_data1, geom_data2, contact, numc);
         }
       }
-
-      // then check for fds
-      if(geom_data1->c_params.fds1 || geom_data2->c_params.fds1) {
-        contact[0].surface.mode |= dContactSlip1;
-        contact[0].surface.slip1 = (geom_data1->c_params.fds1 +
-                                    geom_data2->c_params.fds1);
-      }
-      if(geom_data1->c_params.fds2 || geom_data2->c_params.fds2) {
-        contact[0].surface.mode |= dContactSlip2;
-        contact[0].surface.slip2 = (geom_data1->c_params.fds2 +
-                                    geom_data2->c_params.fds2);
-      }
-      if(geom_data1->c_params.bounce || geom_data2->c_params.bounce) {
-        contact[0].surface.mode |= dContactBounce;
-        contact[0].surface.bounce = (geom_data1->c_params.bounce +
-                                     geom_data2->c_params.bounce);
-        if(geom_data1->c_params.bounce_vel > geom_data2->c_params.bounce_vel)
-          contact[0].surface.bounce_vel = geom_data1->c_params.bounce_vel;
-        else
-          contact[0].surface.bounce_vel = geom_data2->c_params.bounce_vel;
-      }
-
-      for (i=1;i<maxNumContacts;i++){
-        contact[i] = contact[0];
-      }
-
-      numc=dCollide(o1,o2, maxNumContacts, &contact[0].geom,sizeof(dContact));
       if(numc){
         dJointFeedback *fb;
-        draw_item item;
         Vector contact_point;
 
         // todo: add depth handling here too
@@ -906,18 +1015,6 @@ namespace mars {
         }
         if(create_contacts) {
           fb = 0;
-          item.id = 0;
-          item.type = DRAW_LINE;
-          item.draw_state = DRAW_STATE_CREATE;
-          item.point_size = 10;
-          item.myColor.r = 1;
-          item.myColor.g = 0;
-          item.myColor.b = 0;
-          item.myColor.a = 1;
-          item.label = "";
-          item.t_width = item.t_height = 0;
-          item.texture = "";
-          item.get_light = 0;
 
           for(i=0;i<numc;i++) {
             // filter_depth is used to filter heightmaps contact under the surface
@@ -936,15 +1033,15 @@ namespace mars {
                 continue;
               }
             }
-            item.start.x() = contact[i].geom.pos[0];
-            item.start.y() = contact[i].geom.pos[1];
-            item.start.z() = contact[i].geom.pos[2];
-            item.end.x() = contact[i].geom.pos[0] + contact[i].geom.normal[0];
-            item.end.y() = contact[i].geom.pos[1] + contact[i].geom.normal[1];
-            item.end.z() = contact[i].geom.pos[2] + contact[i].geom.normal[2];
-            draw_intern.push_back(item);
-            if(geom_data1->c_params.friction_direction1 ||
-               geom_data2->c_params.friction_direction1) {
+            if(draw_contact_points) {
+              Vector start(contact[i].geom.pos[0], contact[i].geom.pos[1],
+                           contact[i].geom.pos[2]);
+              Vector normal(contact[i].geom.normal[0],
+                            contact[i].geom.normal[1],
+                            contact[i].geom.normal[2]);
+              contactDraw.addLine(start, start+normal, Color(1, 0, 0, 1));
+            }
+            if(pair.use_fdir1) {
               v[0] = contact[i].geom.normal[0];
               v[1] = contact[i].geom.normal[1];
               v[2] = contact[i].geom.normal[2];
@@ -955,8 +1052,7 @@ namespace mars {
               contact[i].fdir1[2] -= v[2];
               dNormalize3(contact[0].fdir1);
             }
-            contact[i].geom.depth += (geom_data1->c_params.depth_correction +
-                                      geom_data2->c_params.depth_correction);
+            contact[i].geom.depth += pair.depth_correction;
 
             if(contact[i].geom.depth < 0.0) contact[i].geom.depth = 0.0;
             dJointID c=dJointCreateContact(world,contactgroup,contact+i);
@@ -976,18 +1072,16 @@ namespace mars {
             //if(dGeomGetClass(o1) == dPlaneClass) {
             fb = 0;
             if(geom_data2->sense_contact_force) {
-              fb = (dJointFeedback*)malloc(sizeof(dJointFeedback));
+              fb = newContactFeedback();
               dJointSetFeedback(c, fb);
-              contact_feedback_list.push_back(fb);
               geom_data2->ground_feedbacks.push_back(fb);
               geom_data2->node1 = false;
             }
             //else if(dGeomGetClass(o2) == dPlaneClass) {
             if(geom_data1->sense_contact_force) {
               if(!fb) {
-                fb = (dJointFeedback*)malloc(sizeof(dJointFeedback));
+                fb = newContactFeedback();
                 dJointSetFeedback(c, fb);
-                contact_feedback_list.push_back(fb);
               }
               geom_data1->ground_feedbacks.push_back(fb);
               geom_data1->node1 = true;
@@ -995,7 +1089,6 @@ namespace mars {
           }
         }
       }
-      delete[] contact;
     }
 
     /**
@@ -1079,20 +1172,6 @@ namespace mars {
       return center;
     }
 
-    void WorldPhysics::update(std::vector<draw_item>* drawItems) {
-      MutexLocker locker(&drawLock);
-      std::vector<draw_item>::iterator iter;
-
-      for(iter=drawItems->begin(); iter!=drawItems->end(); iter++) {
-        iter->draw_state = DRAW_STATE_ERASE;
-      }
-      if(draw_contact_points) {
-        for(iter=draw_extern.begin(); iter!=draw_extern.end(); iter++) {
-          drawItems->push_back(*iter);
-        }
-      }
-    }
-
     int WorldPhysics::handleCollision(dGeomID theGeom) {
       ray_collision = 0;
       dSpaceCollide2(theGeom, (dGeomID)space, this,
@@ -1100,6 +1179,63 @@ namespace mars {
       return ray_collision;
     }
 
+    static bool aabbsOverlap(const dReal *a, const dReal *b) {
+      return !(a[0] > b[1] || a[1] < b[0] ||
+               a[2] > b[3] || a[3] < b[2] ||
+               a[4] > b[5] || a[5] < b[4]);
+    }
+
+    // linear in the number of geoms, the hash space of ODE has no query
+    // for the geoms overlapping a box
+    static void collectRayCandidates(dSpaceID space, const dReal *aabb,
+                                     dGeomID parentGeom, dBodyID parentBody,
+                                     std::vector<dGeomID> *candidates) {
+      dReal other[6];
+      for(int i=0; i<dSpaceGetNumGeoms(space); i++) {
+        dGeomID otherGeom = dSpaceGetGeom(space, i);
+        if(!dGeomIsEnabled(otherGeom) || otherGeom == parentGeom) continue;
+        // the same filter dSpaceCollide2 applies to the sensor rays
+        if(!(dGeomGetCategoryBits(otherGeom) & COLLIDE_MASK_SENSOR) &&
+           !(dGeomGetCollideBits(otherGeom) & COLLIDE_MASK_SENSOR)) continue;
+        dGeomGetAABB(otherGeom, other);
+        if(!aabbsOverlap(aabb, other)) continue;
+        if(dGeomIsSpace(otherGeom)) {
+          collectRayCandidates((dSpaceID)otherGeom, aabb, parentGeom,
+                               parentBody, candidates);
+          continue;
+        }
+        if(parentBody && dGeomGetBody(otherGeom) == parentBody) continue;
+        candidates->push_back(otherGeom);
+      }
+    }
+
+    void WorldPhysics::getRayCandidates(const dReal *aabb, dGeomID parentGeom,
+                                        dBodyID parentBody,
+                                        std::vector<dGeomID> *candidates) const {
+      candidates->clear();
+      collectRayCandidates(space, aabb, parentGeom, parentBody, candidates);
+    }
+
+    bool WorldPhysics::collideRay(dGeomID ray,
+                                  const std::vector<dGeomID> &candidates,
+                                  dReal *depth) const {
+      dContactGeom contact;
+      dReal rayAABB[6], other[6];
+      bool hit = false;
+      dGeomGetAABB(ray, rayAABB);
+      *depth = dGeomRayGetLength(ray);
+      for(size_t i=0; i<candidates.size(); ++i) {
+        dGeomGetAABB(candidates[i], other);
+        if(!aabbsOverlap(rayAABB, other)) continue;
+        if(dCollide(candidates[i], ray, 1|CONTACTS_UNIMPORTANT, &contact,
+                    sizeof(dContactGeom))) {
+          if(contact.depth < *depth) *depth = contact.depth;
+          hit = true;
+        }
+      }
+      return hit;
+    }
+
     double WorldPhysics::getCollisionDepth(dGeomID theGeom) {
       dGeomID otherGeom;
       dContact contact[1];
@@ -1171,6 +1307,80 @@ namespace mars {
       return depth;
     }
 
+    void WorldPhysics::getVectorCollisions(const std::vector<Vector> &pos,
+                                           const Vector &ray,
+                                           std::vector<sReal> *depths) const {
+      MutexLocker locker(&iMutex);
+      dGeomID otherGeom;
+      dContact contact[1];
+      double length = ray.norm();
+      int numc;
+
+      depths->assign(pos.size(), length);
+      if(pos.empty()) return;
+
+      // bounding box of all rays: the start points plus the ray offset
+      dReal aabb[6], probe[6], other[6];
+      for(int k=0; k<3; ++k) {
+        aabb[2*k] = aabb[2*k+1] = pos[0][k];
+      }
+      for(size_t i=0; i<pos.size(); ++i) {
+        for(int k=0; k<3; ++k) {
+          dReal a = pos[i][k], b = pos[i][k] + ray[k];
+          if(a > b) std::swap(a, b);
+          if(a < aabb[2*k]) aabb[2*k] = a;
+          if(b > aabb[2*k+1]) aabb[2*k+1] = b;
+        }
+      }
+
+      // the ray is not inserted into the space; it is only used for
+      // direct dCollide calls against the culled candidates
+      dGeomID theGeom = dCreateRay(0, length);
+      dGeomRaySetClosestHit(theGeom, 1);
+
+      std::vector<dGeomID> candidates;
+      std::vector<dReal> candidateAABBs;
+      for(int i=0; i<dSpaceGetNumGeoms(space); i++) {
+        otherGeom = dSpaceGetGeom(space, i);
+        if(!(dGeomGetCollideBits(theGeom) & dGeomGetCollideBits(otherGeom)))
+          continue;
+        dGeomGetAABB(otherGeom, other);
+        if(other[0] > aabb[1] || other[1] < aabb[0] ||
+           other[2] > aabb[3] || other[3] < aabb[2] ||
+           other[4] > aabb[5] || other[5] < aabb[4])
+          continue;
+        candidates.push_back(otherGeom);
+        candidateAABBs.insert(candidateAABBs.end(), other, other+6);
+      }
+
+      for(size_t i=0; i<pos.size(); ++i) {
+        for(int k=0; k<3; ++k) {
+          probe[2*k] = std::min(pos[i][k], pos[i][k] + ray[k]);
+          probe[2*k+1] = std::max(pos[i][k], pos[i][k] + ray[k]);
+        }
+        bool rayIsSet = false;
+        for(size_t c=0; c<candidates.size(); ++c) {
+          const dReal *b = &candidateAABBs[c*6];
+          if(b[0] > probe[1] || b[1] < probe[0] ||
+             b[2] > probe[3] || b[3] < probe[2] ||
+             b[4] > probe[5] || b[5] < probe[4])
+            continue;
+          if(!rayIsSet) {
+            dGeomRaySet(theGeom, pos[i].x(), pos[i].y(), pos[i].z(),
+                        ray.x(), ray.y(), ray.z());
+            rayIsSet = true;
+          }
+          numc = dCollide(theGeom, candidates[c], 1 | CONTACTS_UNIMPORTANT,
+                          &(contact[0].geom), sizeof(dContact));
+          if(numc && contact[0].geom.depth < (*depths)[i]) {
+            (*depths)[i] = contact[0].geom.depth;
+          }
+        }
+      }
+
+      dGeomDestroy(theGeom);
+    }
+
     void WorldPhysics::getSphereCollision(const Vector &pos,
                                           const double r,
                                           std::vector<utils::Vector> &contacts,
@@ -1237,6 +1447,11 @@ namespace mars {
       dGeomDestroy(theGeom);
     }
 
+    void WorldPhysics::clearExternalContacts(void) {
+      MutexLocker locker(&iMutex);
+      externalContacts.clear();
+    }
+
     void WorldPhysics::addContact(dBodyID b1, Vector &point, Vector &normal, sReal depth,
                                   contact_params &cp1, contact_params &cp2) {
       dContact contact;
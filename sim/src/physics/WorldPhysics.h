@@ -43,6 +43,8 @@
 #include <mars/interfaces/graphics/draw_structs.h>
 #include <mars/interfaces/sim/MarsPluginTemplate.h>
 
+#include <deque>
+#include <map>
 #include <vector>
 
 #include <ode/ode.h>
@@ -86,11 +88,39 @@ namespace mars {
           dContact contact;
       };
 
+    struct geom_data;
+
+    /**
+     * The surface parameters and contact filters combined from the
+     * contact parameters of two geoms.
+     */
+    struct contact_pair_params {
+      dSurfaceParameters surface;
+      // 1 or 2 if the friction direction of that geom is used, else 0; the
+      // direction itself is read from the geom since it may change each step
+      int fdir1_geom;
+      int max_num_contacts;
+      dReal depth_correction;
+      dReal filter_depth, filter_radius;
+      utils::Vector filter_sphere;
+    };
+
+    /**
+     * The contacts generated for a geom pair together with the poses of
+     * both geoms at the time the contacts were calculated.
+     */
+    struct contact_cache_entry {
+      unsigned long params_id1, params_id2;
+      dReal pos1[3], pos2[3];
+      dReal rot1[12], rot2[12];
+      std::vector<dContactGeom> contacts;
+    };
+
     /**
      * Declaration of the physical class, that implements the
      * physics interface.
      */
-    class WorldPhysics : public interfaces::PhysicsInterface, interfaces::DrawInterface {
+    class WorldPhysics : public interfaces::PhysicsInterface {
     public:
       WorldPhysics(interfaces::ControlCenter *control);
       virtual ~WorldPhysics(void);
@@ -98,11 +128,14 @@ namespace mars {
       virtual void initTheWorld(void);
       virtual void freeTheWorld(void);
       virtual void stepTheWorld(void);
+      virtual void clearExternalContacts(void);
       virtual bool existsWorld(void) const;
       virtual const utils::Vector getCenterOfMass(const std::vector<std::shared_ptr<interfaces::NodeInterface>> &nodes)const;
-      virtual void update(std::vector<interfaces::draw_item> *drawItems);
       virtual int checkCollisions(void);
       virtual interfaces::sReal getVectorCollision(const utils::Vector &pos, const utils::Vector &ray) const;
+      virtual void getVectorCollisions(const std::vector<utils::Vector> &pos,
+                                       const utils::Vector &ray,
+                                       std::vector<interfaces::sReal> *depths) const;
       virtual void getSphereCollision(const utils::Vector &pos,
                                       const double r,
                                       std::vector<utils::Vector> &contacts,
@@ -118,7 +151,28 @@ namespace mars {
       void resetCompositeMass(dBodyID theBody);
       void moveCompositeMassCenter(dBodyID theBody, dReal x, dReal y, dReal z);
       int handleCollision(dGeomID theGeom);
+      /**
+       * \brief Collects the geoms a ray sensor may hit within \a aabb.
+       *
+       * The geoms of the sensor's own node, given by \a parentGeom and
+       * \a parentBody, are left out. This still walks over all geoms of
+       * the world space, but only once per sensor update instead of once
+       * per ray segment.
+       */
+      void getRayCandidates(const dReal *aabb, dGeomID parentGeom,
+                            dBodyID parentBody,
+                            std::vector<dGeomID> *candidates) const;
+      /**
+       * \brief Tests \a ray against the candidates without the contact
+       *        handling of the near callback.
+       * \return true if the ray hits, \a depth is the distance to the
+       *         closest hit.
+       */
+      bool collideRay(dGeomID ray, const std::vector<dGeomID> &candidates,
+                      dReal *depth) const;
       interfaces::sReal getCollisionDepth(dGeomID theGeom);
+      unsigned long newContactParamsId(void);
+      dJointFeedback* newContactFeedback(void);
       mutable utils::Mutex iMutex;
       dReal max_angular_speed;
       dReal max_correcting_vel;
@@ -126,7 +180,6 @@ namespace mars {
       static interfaces::PhysicsError error;
 
     private:
-      utils::Mutex drawLock;
       dSpaceID space;
       dWorldID world;
       dGeomID plane;
@@ -137,15 +190,38 @@ namespace mars {
       interfaces::sReal old_cfm, old_erp;
 
       std::vector<body_nbr_tupel> comp_body_list;
-      std::vector<interfaces::draw_item> draw_intern;
-      std::vector<interfaces::draw_item> draw_extern;
-      std::vector<dJointFeedback*> contact_feedback_list;
+      // the contacts of the current step, handed to the graphics at once
+      interfaces::DebugDrawBuffer contactDraw;
+      bool contactsDrawn;
+      // the feedbacks of the contact joints are reused in every step,
+      // a deque keeps the addresses valid while it grows
+      std::deque<dJointFeedback> contactFeedbackPool;
+      size_t numContactFeedbacks;
       std::vector<external_contact> externalContacts;
       bool create_contacts, log_contacts;
       int num_contacts;
       int ray_collision;
+      // combined parameters of the colliding geom pairs keyed by the
+      // params_id of both geom_data structs
+      std::map<std::pair<unsigned long, unsigned long>, contact_pair_params> contactPairCache;
+      unsigned long lastContactParamsId;
+      std::vector<dContact> contactBuffer;
+      // the contacts of the current and the last step keyed by geom pair
+      std::map<std::pair<dGeomID, dGeomID>, contact_cache_entry> contactCache;
+      std::map<std::pair<dGeomID, dGeomID>, contact_cache_entry> lastContactCache;
       // this functions are for the collision implementation
       void nearCallback (dGeomID o1, dGeomID o2);
+      const contact_pair_params& getContactPairParams(geom_data *geom_data1,
+                                                      geom_data *geom_data2);
+      void computeContactPairParams(geom_data *geom_data1,
+                                    geom_data *geom_data2,
+                                    contact_pair_params *params);
+      int getCachedContacts(dGeomID o1, dGeomID o2,
+                            geom_data *geom_data1, geom_data *geom_data2,
+                            dContact *contact, int maxNumContacts);
+      void cacheContacts(dGeomID o1, dGeomID o2,
+                         geom_data *geom_data1, geom_data *geom_data2,
+                         dContact *contact, int numc);
       static void callbackForward(void *data, dGeomID o1, dGeomID o2);
 
       // Step the World auxiliar methods
@@ -177,8 +177,8 @@ namespace mars {
     *  Defines what has to be visible to the camera to get the object
     * \return list of the detected objects
     */
-    /* strategy: iterates through all objects. The viewing frustum is represented as the bounding planes.
-    * checks for the relevant points if they lie on the positive side of the plane normal.
+    /* strategy: culls the entities with the entity bvh, then checks for the relevant points of
+    * the remaining ones if they lie on the positive side of the bounding planes of the frustum.
     */
     void CameraSensor::getEntitiesInView(std::map<unsigned long, SimEntity*> &buffer, unsigned int visVert_threshold) {
       buffer.clear();
@@ -220,21 +220,28 @@ namespace mars {
       p[B] = Plane(cs.pos, view_x * f[L] + temp, view_x * f[R] + temp, Plane::Method::THREE_POINTS);
       p[B].pointNormalTowards(frustum_center);
 
+      //only entities whose bounding volume touches the frustum are candidates
+      std::vector<Plane> planes(p, p+6);
+      std::vector<unsigned long> candidates;
+      control->entities->getEntitiesInFrustum(planes, &candidates);
+
       //declare the boundingbox for the entity
-      Vector center, extent;
-      Quaternion rotation;
+      Vector center;
       std::vector<utils::Vector> vertices;
-      //check for all entities if they are in the view
-      for (std::map<unsigned long, SimEntity*>::const_iterator iter = all_entities->begin();
-          iter != all_entities->end(); ++iter) {
-        iter->second->getBoundingBox(vertices, center);
+      //check for the candidates how many vertices are in the view
+      for (size_t c = 0; c < candidates.size(); ++c) {
+        std::map<unsigned long, SimEntity*>::const_iterator iter = all_entities->find(candidates[c]);
+        if (iter == all_entities->end() ||
+            !control->entities->getEntityBoundingBox(iter->first, &vertices, &center)) {
+          continue;
+        }
         vertices.push_back(center);
         unsigned int visible_vertices = 0;
         for (unsigned int v = 0; v<vertices.size() && visible_vertices < visVert_threshold; v++) {
           bool vertex_in_frustum = true;
           //check for each plane of the frustum if the vertex lies on the inner side
           for (int i = L; i<=F; i++) {
-            if (distance(p[i], vertices[v], false) < 0) {
+            if (p[i].normal.dot(vertices[v] - p[i].point) < 0) {
               vertex_in_frustum = false;
               break;
             }
@@ -257,28 +257,28 @@ namespace mars {
 
     void HapticFieldSensor::computeForces() {
       // FIXME: add mutex here?
+      const size_t n = sensorpoints.size();
+      probeStarts.resize(n);
+      Eigen::Matrix3d rotation = orientation.toRotationMatrix();
+      for (size_t i = 0; i < n; ++i) {
+        probeStarts[i] = position + rotation*sensorpoints[i];
+      }
+      // all probes share the direction, so they are traced in one batch
+      // against a candidate set culled by the bounding box of the field
+      control->sim->getPhysics()->getVectorCollisions(probeStarts,
+                                                      rotation*ray,
+                                                      &probeDepths);
+
       double weightSum = 0;
-      double weight = 0;
-      double distance = 0;
-      Vector pos, ray;
-      int i = 0;
-      //fprintf(stderr, "weights:\n");
-      for (int c = 0; c < config.cols; ++c) {
-        for (int r = 0; r < config.rows; ++r) {
-          i = c*config.rows+r;
-          pos = position + orientation*(sensorpoints.at(i));
-          ray = orientation*this->ray;
-          distance = control->sim->getPhysics()->getVectorCollision(pos, ray);
-          weight = 1 - distance/maxDistance; // = (maxDistance-distance)/maxDistance
-          weights.at(c*config.rows+r) = weight;
-//          fprintf(stderr, "%6g ", weight);
-          weightSum += weight;
-        }
-//        fprintf(stderr, "\n");
+      const double invMaxDistance = 1.0/maxDistance;
+      for (size_t i = 0; i < n; ++i) {
+        // = (maxDistance-distance)/maxDistance
+        weights[i] = 1 - probeDepths[i]*invMaxDistance;
+        weightSum += weights[i];
       }
       double forceQuant = contactForce / weightSum;
-      for (size_t i = 0; i < forces.size(); ++i) {
-        forces.at(i) = weights.at(i) * forceQuant;
+      for (size_t i = 0; i < n; ++i) {
+        forces[i] = weights[i] * forceQuant;
       }
     }
 
@@ -118,6 +118,8 @@ namespace mars {
       utils::Vector ray;
       std::vector<double> forces;
       std::vector<double> weights;
+      std::vector<utils::Vector> probeStarts;
+      std::vector<interfaces::sReal> probeDepths;
       double fieldwidth, fieldheight;
       HapticFieldConfig config;
       data_broker::DataPackage dbPackage;
@@ -58,6 +58,9 @@ namespace mars {
         configmaps::ConfigVector _ids = (*config)["id"];
         unsigned int mapIndex = (*config)["mapIndex"];
         updateRate = (*config)["rate"];
+        if(config->hasKey("history")) {
+          historySize = (*config)["history"];
+        }
         this->config = *config;
         for (it = _ids.begin(); it != _ids.end(); ++it)
         {
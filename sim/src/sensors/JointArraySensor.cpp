@@ -58,6 +58,9 @@ namespace mars {
       cfg["type"] = typeName;
       cfg["index"] = config.id;
       cfg["rate"] = config.updateRate;
+      if(config.historySize) {
+        cfg["history"] = config.historySize;
+      }
 
       for(it=config.ids.begin(); it!= config.ids.end(); ++it) {
         cfg["id"] += *it;
@@ -71,7 +74,7 @@ namespace mars {
                                        bool initArray):
       SensorInterface(control),
       BaseSensor(config.id, config.name),
-      typeName("unknown type"), config(config) {
+      typeName("unknown type"), history(NULL), config(config) {
   
       updateRate = config.updateRate;
       countIDs = 0;
@@ -81,16 +84,23 @@ namespace mars {
       for(it=config.ids.begin(); it!=config.ids.end(); ++it) {
         control->joints->getDataBrokerNames(*it, &groupName, &dataName);
         if (control->dataBroker) {
+          // the history records the data of every step
           control->dataBroker->registerTimedReceiver(this, groupName, dataName,
                                                      "mars_sim/simTimer",
-                                                     updateRate,
+                                                     config.historySize ? 0 : updateRate,
                                                      countIDs++);
         }
         if(initArray) doubleArray.push_back(0.0);
       }
+      // timed receivers are called in the order of their registration, so
+      // the history stores the data after the receivers above updated it
+      if(config.historySize) {
+        history = new SensorHistory(control, this, config.historySize);
+      }
     }
 
     JointArraySensor::~JointArraySensor(void) {
+      delete history;
       if (control->dataBroker) {
         control->dataBroker->unregisterTimedReceiver(this, "*", "*",
                                                      "mars_sim/simTimer");
@@ -125,5 +135,17 @@ namespace mars {
       return i;
     }
 
+    int JointArraySensor::getHistory(double since, std::vector<double> *times,
+                                     std::vector<double> *data) const {
+      if(!history) return 0;
+      return history->getSamples(since, times, data);
+    }
+
+    bool JointArraySensor::getSensorDataAt(double time,
+                                           std::vector<double> *data) const {
+      if(!history) return false;
+      return history->getDataAt(time, data);
+    }
+
   } // end of namespace sim
 } // end of namespace mars
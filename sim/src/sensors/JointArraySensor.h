@@ -39,6 +39,7 @@
 #include <mars/data_broker/DataPackage.h>
 
 #include "IDListConfig.h"
+#include "SensorHistory.h"
 
 namespace mars {
   namespace sim {
@@ -53,6 +54,10 @@ namespace mars {
       virtual ~JointArraySensor(void);
       virtual int getAsciiData(char* data) const ;
       virtual int getSensorData(interfaces::sReal **data) const ;
+      virtual int getHistory(double since, std::vector<double> *times,
+                             std::vector<double> *data) const;
+      virtual bool getSensorDataAt(double time,
+                                   std::vector<double> *data) const;
       virtual void receiveData(const data_broker::DataInfo &info,
                                const data_broker::DataPackage &package,
                                int callbackParam) {}
@@ -65,6 +70,7 @@ namespace mars {
       std::string typeName;
       int countIDs;
       std::vector<double> doubleArray;
+      SensorHistory *history;
 
     private:
       IDListConfig config;
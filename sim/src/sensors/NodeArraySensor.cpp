@@ -58,6 +58,9 @@ namespace mars {
       cfg["type"] = typeName;
       cfg["index"] = config.id;
       cfg["rate"] = config.updateRate;
+      if(config.historySize) {
+        cfg["history"] = config.historySize;
+      }
 
       for(it=config.ids.begin(); it!= config.ids.end(); ++it) {
         cfg["id"] += *it;
@@ -71,7 +74,7 @@ namespace mars {
                                      bool initArray, bool registerReceiver):
       SensorInterface(control),
       BaseSensor(config.id, config.name),
-      typeName("unknown type"), config(config) {
+      typeName("unknown type"), history(NULL), config(config) {
   
       updateRate = config.updateRate;
       if(registerReceiver) {
@@ -82,10 +85,11 @@ namespace mars {
         for(it=config.ids.begin(); it!=config.ids.end(); ++it) {
           control->nodes->getDataBrokerNames(*it, &groupName, &dataName);
           if(control->dataBroker) {
+            // the history records the data of every step
             control->dataBroker->registerTimedReceiver(this, groupName,
                                                        dataName,
                                                        "mars_sim/simTimer",
-                                                       updateRate,
+                                                       config.historySize ? 0 : updateRate,
                                                        countIDs++);
           }
           if(initArray) doubleArray.push_back(0.0);
@@ -97,9 +101,15 @@ namespace mars {
           for(int i=0; i<countIDs; ++i) doubleArray.push_back(0.0);
         }
       }
+      // timed receivers are called in the order of their registration, so
+      // the history stores the data after the receivers above updated it
+      if(config.historySize) {
+        history = new SensorHistory(control, this, config.historySize);
+      }
     }
 
     NodeArraySensor::~NodeArraySensor(void) {
+      delete history;
       if(control->dataBroker) {
         control->dataBroker->unregisterTimedReceiver(this, "*", "*",
                                                      "mars_sim/simTimer");
@@ -134,5 +144,17 @@ namespace mars {
       return i;
     }
 
+    int NodeArraySensor::getHistory(double since, std::vector<double> *times,
+                                    std::vector<double> *data) const {
+      if(!history) return 0;
+      return history->getSamples(since, times, data);
+    }
+
+    bool NodeArraySensor::getSensorDataAt(double time,
+                                          std::vector<double> *data) const {
+      if(!history) return false;
+      return history->getDataAt(time, data);
+    }
+
   } // end of namespace sim
 } // end of namespace mars
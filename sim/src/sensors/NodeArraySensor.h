@@ -38,6 +38,7 @@
 #include <mars/data_broker/ReceiverInterface.h>
 
 #include "IDListConfig.h"
+#include "SensorHistory.h"
 
 namespace mars {
   namespace sim {
@@ -54,6 +55,10 @@ namespace mars {
       virtual ~NodeArraySensor(void);
       virtual int getAsciiData(char* data) const ;
       virtual int getSensorData(interfaces::sReal **data) const ;
+      virtual int getHistory(double since, std::vector<double> *times,
+                             std::vector<double> *data) const;
+      virtual bool getSensorDataAt(double time,
+                                   std::vector<double> *data) const;
       virtual void receiveData(const data_broker::DataInfo &info,
                                const data_broker::DataPackage &package,
                                int callbackParam) {}
@@ -66,6 +71,7 @@ namespace mars {
       std::string typeName;
       int countIDs;
       std::vector<double> doubleArray;
+      SensorHistory *history;
       IDListConfig config;
     };
 
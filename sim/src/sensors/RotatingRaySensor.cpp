@@ -79,7 +79,6 @@ namespace mars {
 
       std::string groupName, dataName;
       drawStruct draw;
-      draw_item item;
       Vector tmp;
       update_available = false;
 
@@ -131,36 +130,20 @@ namespace mars {
             Vector(1,0,0);
 
           directions.push_back(tmp);
-
-          // Add a drawing item for each ray regarding the initial sensor orientation.
-          if(config.draw_rays) {
-            draw.ptr_draw = (DrawInterface*)this;
-            item.id = 0;
-            item.type = DRAW_LINE;
-            item.draw_state = DRAW_STATE_CREATE;
-            item.point_size = 1;
-            item.myColor.r = 1;
-            item.myColor.g = 0;
-            item.myColor.b = 0;
-            item.myColor.a = 1;
-            item.texture = "";
-            item.t_width = item.t_height = 0;
-            item.get_light = 0.0;
-
-            // Initial vector length is set to 1.0
-            item.start = position;
-            item.end = orientation * tmp;
-            draw.drawItems.push_back(item);
-          }
         }
       }
 
       // Add sensor after everything has been initialized.
       control->nodes->addNodeSensor(this);
 
-      // GraphicsManager crashes if default constructor drawStruct is passed.
+      // The rays are drawn as debug geometry, the draw interface is only
+      // used to update them once per frame.
       if(config.draw_rays) {
+        char channel[64];
+        sprintf(channel, "sensors/%lu/rays", id);
+        rayChannel = channel;
         if(control->graphics) {
+          draw.ptr_draw = (DrawInterface*)this;
           control->graphics->addDrawItems(&draw);
         }
       }
@@ -169,8 +152,10 @@ namespace mars {
     }
 
     RotatingRaySensor::~RotatingRaySensor(void) {
-      if(control->graphics)
+      if(control->graphics) {
         control->graphics->removeDrawItems((DrawInterface*)this);
+        if(config.draw_rays) control->graphics->removeDebugDraw(rayChannel);
+      }
       if (control->dataBroker)
         control->dataBroker->unregisterTimedReceiver(this, "*", "*", "mars_sim/simTimer");
       closeThread = true;
@@ -240,25 +225,17 @@ namespace mars {
       // data[] contains all the measured distances according to the define directions.
       assert((int)data.size() == config.bands * config.lasers);
 
-      int i = 0; // data_counter
-      utils::Vector local_ray, tmpvec;
-      for(int b=0; b<config.bands; ++b) {
-        base::Orientation base_orientation;
-        base_orientation.x() = orientation_offset.x();
-        base_orientation.y() = orientation_offset.y();
-        base_orientation.z() = orientation_offset.z();
-        base_orientation.w() = orientation_offset.w();
-
-        // If min/max are exceeded distance will be ignored.
-        for(int l=0; l<config.lasers; ++l, ++i){
-          if (data[i] >= config.minDistance && data[i] < config.maxDistance-0.01) {
-            // Calculates the ray/vector within the sensor frame.
-            local_ray = orientation_offset * directions[i] * data[i];
-            // Gathers pointcloud in the world frame to prevent/reduce movement distortion.
-            // This necessitates a back-transformation (world2node) in getPointcloud().
-            tmpvec = current_pose * local_ray;
-            toCloud->push_back(tmpvec); // Scale normalized vector.
-          }
+      // Transforms the rays from the turned sensor frame into the world
+      // frame to prevent/reduce movement distortion. This necessitates a
+      // back-transformation (world2node) in run().
+      Eigen::Matrix3d rayToWorld = (current_pose.linear() *
+                                    orientation_offset.toRotationMatrix());
+      utils::Vector worldPosition = current_pose.translation();
+      // If min/max are exceeded distance will be ignored.
+      for(size_t i=0; i<data.size(); ++i) {
+        if (data[i] >= config.minDistance && data[i] < config.maxDistance-0.01) {
+          toCloud->push_back(rayToWorld * (directions[i] * data[i]) +
+                             worldPosition);
         }
       }
       num_points += data.size();
@@ -274,17 +251,16 @@ namespace mars {
         control->nodes->updateRay(attached_node);
         update_available = false;
       }
-      if(config.draw_rays) {
-        if(!(*drawItems)[0].draw_state) {
-          for(i=0; i<data.size(); i++) {
-            (*drawItems)[i].draw_state = DRAW_STATE_UPDATE;
-            // Updates the rays using the current sensor pose.
-            (*drawItems)[i].start = position;
-            (*drawItems)[i].end = (orientation * orientation_offset * directions[i]);
-            (*drawItems)[i].end *= data[i];
-            (*drawItems)[i].end += (*drawItems)[i].start;
-          }
+      if(config.draw_rays && control->graphics) {
+        // Updates the rays using the current sensor pose.
+        utils::Quaternion rayOrientation = orientation * orientation_offset;
+        rayDraw.clear();
+        for(i=0; i<data.size(); i++) {
+          rayDraw.addLine(position,
+                          position + (rayOrientation * directions[i])*data[i],
+                          utils::Color(1, 0, 0, 1));
         }
+        control->graphics->swapDebugDraw(rayChannel, &rayDraw);
       }
     }
 
@@ -355,19 +331,16 @@ namespace mars {
           rot.rotate(config.transf_sensor_rot_to_sensor);
           poseMutex.unlock();
 
+          // Transforms the pointcloud back from world to current node (see receiveDate()).
+          // In addition 'transf_sensor_rot_to_sensor' is applied which describes
+          // the orientation of the sensor in the unturned sensor frame.
+          Eigen::Affine3d worldToSensor = rot * current_pose2.inverse();
+
           // Copies current full pointcloud to pointcloud_full.
-          std::list<utils::Vector>::iterator it = fromCloud->begin();
           mutex_pointcloud.lock();
-          pointcloud_full.clear();
-          pointcloud_full.reserve(fromCloud->size());
-          base::Vector3d vec_local;
-
-          for(int i=0; it != fromCloud->end(); it++, i++) {
-            // Transforms the pointcloud back from world to current node (see receiveDate()).
-            // In addition 'transf_sensor_rot_to_sensor' is applied which describes
-            // the orientation of the sensor in the unturned sensor frame.
-            vec_local = rot * current_pose2.inverse() * (*it);
-            pointcloud_full.push_back(vec_local);
+          pointcloud_full.resize(fromCloud->size());
+          for(size_t i=0; i<fromCloud->size(); ++i) {
+            pointcloud_full[i] = worldToSensor * (*fromCloud)[i];
           }
           mutex_pointcloud.unlock();
           fromCloud->clear();
@@ -178,9 +178,10 @@ namespace mars {
       // TODO Storing the pointcloud four times is not very effective.
       // Maybe: Integrate distortion-prevention (use current sensor pose)
       // in mlls and only create the pointcloud on demand.
-      std::list<utils::Vector> pointcloud1; // TODO Replace with array with fix size.
-      std::list<utils::Vector> pointcloud2; // TODO Replace with array with fix size.
-      std::list<utils::Vector> *toCloud, *fromCloud; // TODO Replace with array with fix size.
+      // The clouds keep their capacity between scans.
+      std::vector<utils::Vector> pointcloud1;
+      std::vector<utils::Vector> pointcloud2;
+      std::vector<utils::Vector> *toCloud, *fromCloud;
       std::vector<utils::Vector> pointcloud_full; // Stores the full scan.
       bool convertPointCloud;
       int nextCloud;
@@ -198,6 +199,8 @@ namespace mars {
       Eigen::Affine3d current_pose;
       bool closeThread;
       unsigned int num_points;
+      interfaces::DebugDrawBuffer rayDraw;
+      std::string rayChannel;
     };
 
   } // end of namespace sim
@@ -0,0 +1,137 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "SensorHistory.h"
+
+#include <mars/interfaces/sim/ControlCenter.h>
+#include <mars/data_broker/DataBrokerInterface.h>
+#include <mars/data_broker/DataPackage.h>
+#include <mars/utils/MutexLocker.h>
+
+#include <cstdlib>
+
+namespace mars {
+  namespace sim {
+
+    using namespace utils;
+    using namespace interfaces;
+
+    SensorHistory::SensorHistory(ControlCenter *control, BaseSensor *sensor,
+                                 unsigned long capacity) :
+      control(control), sensor(sensor), capacity(capacity),
+      width(0), first(0), count(0) {
+      times.resize(capacity);
+      if(control->dataBroker) {
+        // the sim time of a step is pushed before the simTimer is stepped,
+        // in which the nodes and joints produce the data of the same step
+        control->dataBroker->registerTimedReceiver(this, "mars_sim", "simTime",
+                                                   "mars_sim/simTimer", 0);
+      }
+    }
+
+    SensorHistory::~SensorHistory() {
+      if(control->dataBroker) {
+        control->dataBroker->unregisterTimedReceiver(this, "mars_sim",
+                                                     "simTime",
+                                                     "mars_sim/simTimer");
+      }
+    }
+
+    void SensorHistory::receiveData(const data_broker::DataInfo &info,
+                                    const data_broker::DataPackage &package,
+                                    int callbackParam) {
+      double time;
+      sReal *data = NULL;
+      package.get(0, &time);
+      int n = sensor->getSensorData(&data);
+
+      MutexLocker locker(&mutex);
+      if(n != (int)width) {
+        // the layout of the sensor changed, the old samples don't fit
+        width = n;
+        samples.resize(capacity*width);
+        first = count = 0;
+      }
+      if(count && times[index(count-1)] >= time) {
+        // the simulation was reset
+        first = count = 0;
+      }
+      size_t i;
+      if(count < capacity) {
+        i = index(count++);
+      }
+      else {
+        i = first;
+        first = index(1);
+      }
+      times[i] = time;
+      for(size_t k=0; k<width; ++k) samples[i*width+k] = data[k];
+      free(data);
+    }
+
+    int SensorHistory::getSamples(double since, std::vector<double> *times,
+                                  std::vector<double> *data) const {
+      MutexLocker locker(&mutex);
+      // the samples are sorted by time, search the first new one
+      size_t lo = 0, hi = count;
+      while(lo < hi) {
+        size_t mid = (lo+hi)/2;
+        if(this->times[index(mid)] > since) hi = mid;
+        else lo = mid+1;
+      }
+      for(size_t i=lo; i<count; ++i) {
+        size_t s = index(i);
+        times->push_back(this->times[s]);
+        data->insert(data->end(), samples.begin()+s*width,
+                     samples.begin()+(s+1)*width);
+      }
+      return count-lo;
+    }
+
+    bool SensorHistory::getDataAt(double time,
+                                  std::vector<double> *data) const {
+      MutexLocker locker(&mutex);
+      if(!count || time < times[first] || time > times[index(count-1)]) {
+        return false;
+      }
+      // search the first sample at or after time
+      size_t lo = 0, hi = count-1;
+      while(lo < hi) {
+        size_t mid = (lo+hi)/2;
+        if(times[index(mid)] < time) lo = mid+1;
+        else hi = mid;
+      }
+      size_t s1 = index(lo);
+      data->resize(width);
+      if(lo == 0 || times[s1] == time) {
+        for(size_t k=0; k<width; ++k) (*data)[k] = samples[s1*width+k];
+        return true;
+      }
+      size_t s0 = index(lo-1);
+      double f = (time-times[s0]) / (times[s1]-times[s0]);
+      for(size_t k=0; k<width; ++k) {
+        (*data)[k] = samples[s0*width+k] + f*(samples[s1*width+k] -
+                                              samples[s0*width+k]);
+      }
+      return true;
+    }
+
+  } // end of namespace sim
+} // end of namespace mars
@@ -0,0 +1,88 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file SensorHistory.h
+ * \brief A ring buffer of time stamped sensor samples.
+ *
+ * The history registers for the simulation time on the simulation timer
+ * and stores the current data of its sensor once per physics step. It has
+ * to be created after the sensor registered its own timed receivers. Consumers that run at
+ * a different rate can read all samples since a given time or interpolate
+ * the sensor data at arbitrary times within the stored range.
+ */
+
+#ifndef MARS_SIM_SENSOR_HISTORY_H
+#define MARS_SIM_SENSOR_HISTORY_H
+
+#include <mars/interfaces/sensor_bases.h>
+#include <mars/data_broker/ReceiverInterface.h>
+#include <mars/utils/Mutex.h>
+
+#include <vector>
+
+namespace mars {
+  namespace interfaces {
+    class ControlCenter;
+  }
+
+  namespace sim {
+
+    class SensorHistory : public data_broker::ReceiverInterface {
+    public:
+      SensorHistory(interfaces::ControlCenter *control,
+                    interfaces::BaseSensor *sensor, unsigned long capacity);
+      ~SensorHistory();
+
+      virtual void receiveData(const data_broker::DataInfo &info,
+                               const data_broker::DataPackage &package,
+                               int callbackParam);
+
+      /**
+       * Appends all samples with a time stamp greater than \c since to
+       * \c times and \c data. The time stamps are given in ms of simulation
+       * time; each sample has the layout of BaseSensor::getSensorData.
+       * \return the number of samples appended.
+       */
+      int getSamples(double since, std::vector<double> *times,
+                     std::vector<double> *data) const;
+
+      /**
+       * Linearly interpolates the sensor data at \c time.
+       * \return false if \c time is outside of the stored range.
+       */
+      bool getDataAt(double time, std::vector<double> *data) const;
+
+    private:
+      interfaces::ControlCenter *control;
+      interfaces::BaseSensor *sensor;
+      unsigned long capacity;
+      size_t width, first, count;
+      std::vector<double> times;
+      std::vector<double> samples;
+      mutable utils::Mutex mutex;
+
+      size_t index(size_t i) const {return (first+i) % capacity;}
+    };
+
+  } // end of namespace sim
+} // end of namespace mars
+
+#endif // MARS_SIM_SENSOR_HISTORY_H
@@ -25,7 +25,6 @@
  */
 
 #include "SMURFLoader.h"
-#include "zipit.h"
 
 #include <QtXml>
 #include <QDomNodeList>
@@ -38,6 +37,7 @@
 #include <mars/interfaces/graphics/GraphicsManagerInterface.h>
 #include <mars/interfaces/GraphicData.h>
 #include <mars/sim/SimEntity.h>
+#include <mars/utils/SceneArchive.h>
 #include <mars/utils/misc.h>
 #include <mars/utils/mathUtils.h>
 
@@ -405,9 +405,9 @@ namespace mars {
       // need to unzip into a temporary directory
       if (file_extension == ".zsmurf" || file_extension == ".zsmurfs" || file_extension == ".zsmurfa") {
 	if (unzip(tmpPath, filename) == 0) {
-	  path = tmpPath;
 	  return 0;
 	}
+	path = tmpPath;
       }
 
       // read in the provided file - .smurfs / .smurf / .urdf
@@ -655,10 +655,12 @@ namespace mars {
       if (!utils::createDirectory(destinationDir))
 	return 0;
 
-      Zipit myZipFile(zipFilename);
+      // the urdf parser needs the files on disk, so the archive is still
+      // extracted
+      utils::SceneArchive archive;
       LOG_INFO("Load: unsmurfing zipped SMURF: %s", zipFilename.c_str());
 
-      if (!myZipFile.unpackWholeZipTo(destinationDir))
+      if (!archive.open(zipFilename) || !archive.extractAll(destinationDir))
 	return 0;
 
       return 1;
@@ -0,0 +1,325 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file KinematicTree.cpp
+ * \brief Forward kinematics of a loaded scene over contiguous arrays.
+ */
+
+#include "KinematicTree.h"
+
+#include <mars/interfaces/graphics/GraphicsManagerInterface.h>
+#include <mars/utils/mathUtils.h>
+#include <mars/utils/misc.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+namespace mars {
+  namespace viz {
+
+    using namespace utils;
+
+    void JointTrajectory::clear() {
+      names.clear();
+      times.clear();
+      values.clear();
+    }
+
+    void JointTrajectory::setJointNames(const std::vector<std::string> &names_) {
+      clear();
+      names = names_;
+    }
+
+    void JointTrajectory::addSample(double time, const double *values_) {
+      times.push_back(time);
+      values.insert(values.end(), values_, values_+names.size());
+    }
+
+    bool JointTrajectory::loadFile(const std::string &filename) {
+      std::ifstream file(filename.c_str());
+      if(!file.is_open()) {
+        fprintf(stderr, "JointTrajectory: could not open %s\n",
+                filename.c_str());
+        return false;
+      }
+
+      std::string line;
+      std::vector<std::string> columns;
+      std::vector<double> row;
+      bool header = true;
+      size_t lineNumber = 0;
+      clear();
+      while(std::getline(file, line)) {
+        ++lineNumber;
+        std::replace(line.begin(), line.end(), ',', ' ');
+        std::replace(line.begin(), line.end(), '\t', ' ');
+        line = trim(line);
+        if(line.empty()) continue;
+        if(header) {
+          if(line[0] == '#') line = trim(line.substr(1));
+          columns = explodeString(' ', line);
+          columns.erase(std::remove(columns.begin(), columns.end(),
+                                    std::string()), columns.end());
+          if(columns.size() < 2) {
+            fprintf(stderr, "JointTrajectory: no joints in %s\n",
+                    filename.c_str());
+            return false;
+          }
+          names.assign(columns.begin()+1, columns.end());
+          row.resize(columns.size());
+          header = false;
+          continue;
+        }
+        if(line[0] == '#') continue;
+
+        const char *p = line.c_str();
+        char *end;
+        size_t count = 0;
+        for(; count<row.size(); ++count) {
+          row[count] = strtod(p, &end);
+          if(end == p) break;
+          p = end;
+        }
+        if(count != row.size() || (!times.empty() && row[0] < times.back())) {
+          fprintf(stderr, "JointTrajectory: skip invalid line %lu in %s\n",
+                  (unsigned long)lineNumber, filename.c_str());
+          continue;
+        }
+        addSample(row[0], row.data()+1);
+      }
+      return !header;
+    }
+
+    size_t JointTrajectory::interpolate(double time, double *values_,
+                                        size_t hint) const {
+      size_t numJoints = names.size();
+      if(times.empty()) return 0;
+      if(time <= times.front()) {
+        std::copy(values.begin(), values.begin()+numJoints, values_);
+        return 0;
+      }
+      size_t last = times.size()-1;
+      if(time >= times.back()) {
+        std::copy(values.begin()+last*numJoints, values.end(), values_);
+        return last;
+      }
+
+      // find the sample with times[i] <= time < times[i+1], starting at
+      // the hint for sequential playback
+      size_t i = hint < last ? hint : 0;
+      if(times[i] > time) {
+        i = 0;
+      }
+      if(!(time < times[i+1])) {
+        if(i+2 <= last && time < times[i+2]) {
+          ++i;
+        }
+        else {
+          i = (std::upper_bound(times.begin(), times.end(), time) -
+               times.begin()) - 1;
+        }
+      }
+
+      double dt = times[i+1] - times[i];
+      double f = dt > 0.0 ? (time - times[i]) / dt : 0.0;
+      const double *a = &values[i*numJoints];
+      const double *b = a + numJoints;
+      for(size_t k=0; k<numJoints; ++k) {
+        values_[k] = a[k] + f*(b[k]-a[k]);
+      }
+      return i;
+    }
+
+    KinematicTree::KinematicTree() : changed(false) {
+    }
+
+    void KinematicTree::clear() {
+      drawIds.clear();
+      parents.clear();
+      types.clear();
+      pivots.clear();
+      anchors.clear();
+      relPositions.clear();
+      axes.clear();
+      restRotations.clear();
+      offsets.clear();
+      localPos.clear();
+      worldPos.clear();
+      localRot.clear();
+      worldRot.clear();
+      jointLinks.clear();
+      jointNames.clear();
+      jointValues.clear();
+      jointChanged.clear();
+      jointIndexByName.clear();
+      changed = false;
+    }
+
+    int KinematicTree::addLink(unsigned long drawId, int parent, int type,
+                               const Vector &pivot) {
+      assert(parent < (int)drawIds.size());
+      drawIds.push_back(drawId);
+      parents.push_back(parent);
+      types.push_back(type);
+      pivots.push_back(pivot);
+      anchors.push_back(Vector::Zero());
+      relPositions.push_back(Vector::Zero());
+      axes.push_back(Vector::UnitZ());
+      restRotations.push_back(Quaternion::Identity());
+      offsets.push_back(0.0);
+      localPos.push_back(Vector::Zero());
+      worldPos.push_back(Vector::Zero());
+      localRot.push_back(Quaternion::Identity());
+      worldRot.push_back(Quaternion::Identity());
+      return (int)drawIds.size()-1;
+    }
+
+    int KinematicTree::addFixedLink(unsigned long drawId, int parent,
+                                    const Vector &pivot,
+                                    const Vector &pos, const Quaternion &q) {
+      int link = addLink(drawId, parent, LINK_FIXED, pivot);
+      localPos[link] = pos;
+      localRot[link] = q;
+      changed = true;
+      return link;
+    }
+
+    int KinematicTree::addJointLink(unsigned long drawId, int parent,
+                                    const Vector &pivot,
+                                    const std::string &jointName,
+                                    LinkType type, const Vector &anchor,
+                                    const Vector &relPos, const Vector &axis,
+                                    const Quaternion &q, double offset,
+                                    double value) {
+      int link = addLink(drawId, parent, type, pivot);
+      anchors[link] = anchor;
+      relPositions[link] = relPos;
+      axes[link] = axis;
+      restRotations[link] = q;
+      offsets[link] = offset;
+      localPos[link] = anchor + relPos;
+      localRot[link] = q;
+
+      int joint = (int)jointLinks.size();
+      jointLinks.push_back(link);
+      jointNames.push_back(jointName);
+      jointValues.push_back(value);
+      jointChanged.push_back(0);
+      jointIndexByName[jointName] = joint;
+      changed = true;
+      return link;
+    }
+
+    int KinematicTree::getJointIndex(const std::string &name) const {
+      std::map<std::string, int>::const_iterator it;
+      it = jointIndexByName.find(name);
+      return it == jointIndexByName.end() ? -1 : it->second;
+    }
+
+    std::vector<int> KinematicTree::mapJoints(const std::vector<std::string> &names) const {
+      std::vector<int> indices(names.size());
+      for(size_t i=0; i<names.size(); ++i) {
+        indices[i] = getJointIndex(names[i]);
+      }
+      return indices;
+    }
+
+    void KinematicTree::setJointValue(size_t joint, double value) {
+      assert(joint < jointValues.size());
+      jointValues[joint] = value;
+      jointChanged[joint] = 1;
+      changed = true;
+    }
+
+    void KinematicTree::setJointValues(const double *values, size_t count) {
+      count = std::min(count, jointValues.size());
+      for(size_t i=0; i<count; ++i) {
+        jointValues[i] = values[i];
+        jointChanged[i] = 1;
+      }
+      if(count) changed = true;
+    }
+
+    void KinematicTree::setJointValues(const std::vector<int> &indices,
+                                       const double *values) {
+      for(size_t i=0; i<indices.size(); ++i) {
+        if(indices[i] < 0) continue;
+        jointValues[indices[i]] = values[i];
+        jointChanged[indices[i]] = 1;
+        changed = true;
+      }
+    }
+
+    bool KinematicTree::update(interfaces::GraphicsManagerInterface *graphics) {
+      if(!changed) return false;
+      changed = false;
+      commitIds.clear();
+      commitPos.clear();
+      commitRot.clear();
+
+      // the joint links only change their local pose
+      for(size_t joint=0; joint<jointLinks.size(); ++joint) {
+        if(!jointChanged[joint]) continue;
+        jointChanged[joint] = 0;
+        int link = jointLinks[joint];
+        double value = jointValues[joint];
+        if(types[link] == LINK_PRISMATIC) {
+          localPos[link] = anchors[link] + axes[link]*value + relPositions[link];
+          localRot[link] = restRotations[link];
+        }
+        else {
+          Quaternion q = angleAxisToQuaternion(value+offsets[link], axes[link]);
+          localPos[link] = anchors[link] + q*relPositions[link];
+          localRot[link] = q*restRotations[link];
+        }
+        commitIds.push_back(drawIds[link]);
+        commitPos.push_back(localPos[link]);
+        commitRot.push_back(localRot[link]);
+      }
+
+      // the parents are stored before their children
+      for(size_t link=0; link<drawIds.size(); ++link) {
+        int parent = parents[link];
+        if(parent < 0) {
+          worldPos[link] = localPos[link];
+          worldRot[link] = localRot[link];
+        }
+        else {
+          const Quaternion &r = worldRot[parent];
+          worldPos[link] = (worldPos[parent] - r*pivots[parent] +
+                            r*localPos[link]);
+          worldRot[link] = r*localRot[link];
+        }
+      }
+
+      // the scene graph composes the local poses of the draw objects
+      if(graphics && !commitIds.empty()) {
+        graphics->setDrawObjectPoses(commitIds.size(), commitIds.data(),
+                                     commitPos.data(), commitRot.data());
+      }
+      return true;
+    }
+
+  } // end of namespace viz
+} // end of namespace mars
@@ -0,0 +1,183 @@
+/*
+ *  Copyright 2026, DFKI GmbH Robotics Innovation Center
+ *
+ *  This file is part of the MARS simulation framework.
+ *
+ *  MARS is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation, either version 3
+ *  of the License, or (at your option) any later version.
+ *
+ *  MARS is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with MARS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * \file KinematicTree.h
+ * \brief Forward kinematics of a loaded scene over contiguous arrays.
+ *
+ * The links are stored in topological order, every parent before its
+ * children. Setting joint values only stores them, update() evaluates the
+ * whole tree in one pass and commits the poses of all changed links to the
+ * graphics with a single setDrawObjectPoses call.
+ */
+
+#ifndef MARS_VIZ_KINEMATIC_TREE_H
+#define MARS_VIZ_KINEMATIC_TREE_H
+
+#ifdef _PRINT_HEADER_
+  #warning "KinematicTree.h"
+#endif
+
+#include <mars/utils/Vector.h>
+#include <mars/utils/Quaternion.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace mars {
+  namespace interfaces {
+    class GraphicsManagerInterface;
+  }
+
+  namespace viz {
+
+    /**
+     * Recorded joint values over time. The values of one sample are stored
+     * contiguously in the order of getJointNames().
+     *
+     * A log file is a text file with a header line "time name1 name2 ..."
+     * followed by one line per sample. The time is given in seconds and
+     * the columns are separated by spaces, tabs or commas.
+     */
+    class JointTrajectory {
+    public:
+      JointTrajectory() {}
+
+      void clear();
+      void setJointNames(const std::vector<std::string> &names);
+      const std::vector<std::string>& getJointNames() const {return names;}
+      /** The times have to be increasing. */
+      void addSample(double time, const double *values);
+      bool loadFile(const std::string &filename);
+
+      size_t size() const {return times.size();}
+      bool empty() const {return times.empty();}
+      double getStartTime() const {return times.empty() ? 0.0 : times.front();}
+      double getEndTime() const {return times.empty() ? 0.0 : times.back();}
+
+      /**
+       * \brief Linearly interpolates the sample at \a time.
+       * \param hint The sample index returned by the previous call, which
+       *             makes sequential playback constant time.
+       * \return The index of the sample before \a time.
+       */
+      size_t interpolate(double time, double *values, size_t hint=0) const;
+
+    private:
+      std::vector<std::string> names;
+      std::vector<double> times;
+      std::vector<double> values;
+    };
+
+    class KinematicTree {
+    public:
+      enum LinkType {
+        LINK_FIXED,
+        LINK_REVOLUTE,
+        LINK_PRISMATIC,
+      };
+
+      KinematicTree();
+
+      void clear();
+
+      /**
+       * \brief Adds a link that is not moved by a joint.
+       * \param parent The index of the parent link or -1 for a root link,
+       *               whose pose is given in world coordinates.
+       * \param pivot The offset of the draw object origin, needed to
+       *              express the poses of the children.
+       */
+      int addFixedLink(unsigned long drawId, int parent,
+                       const utils::Vector &pivot,
+                       const utils::Vector &pos, const utils::Quaternion &q);
+      /**
+       * \brief Adds a link that is moved by a joint. The joint parameters are
+       *        given in the frame of the parent link.
+       * \return The index of the link. The joint gets the next joint index.
+       */
+      int addJointLink(unsigned long drawId, int parent,
+                       const utils::Vector &pivot, const std::string &jointName,
+                       LinkType type, const utils::Vector &anchor,
+                       const utils::Vector &relPos, const utils::Vector &axis,
+                       const utils::Quaternion &q, double offset,
+                       double value);
+
+      size_t getNumLinks() const {return drawIds.size();}
+      size_t getNumJoints() const {return jointLinks.size();}
+      /** \return The joint index or -1. */
+      int getJointIndex(const std::string &name) const;
+      const std::vector<std::string>& getJointNames() const {return jointNames;}
+      /** \return The joint indices of \a names, -1 for unknown joints. */
+      std::vector<int> mapJoints(const std::vector<std::string> &names) const;
+
+      void setJointValue(size_t joint, double value);
+      /** \brief Sets the values of all joints in joint index order. */
+      void setJointValues(const double *values, size_t count);
+      /** \brief Sets the joints of \a indices, negative indices are skipped. */
+      void setJointValues(const std::vector<int> &indices, const double *values);
+      double getJointValue(size_t joint) const {return jointValues[joint];}
+
+      /**
+       * \brief Evaluates the tree and commits the changed link poses.
+       * \return false if no joint changed since the last update.
+       */
+      bool update(interfaces::GraphicsManagerInterface *graphics);
+
+      /** \brief The world pose of a link as of the last update. */
+      const utils::Vector& getLinkPosition(size_t link) const {return worldPos[link];}
+      const utils::Quaternion& getLinkOrientation(size_t link) const {return worldRot[link];}
+
+    private:
+      // per link, in topological order
+      std::vector<unsigned long> drawIds;
+      std::vector<int> parents;
+      std::vector<int> types;
+      std::vector<utils::Vector> pivots;
+      std::vector<utils::Vector> anchors;
+      std::vector<utils::Vector> relPositions;
+      std::vector<utils::Vector> axes;
+      std::vector<utils::Quaternion> restRotations;
+      std::vector<double> offsets;
+      std::vector<utils::Vector> localPos, worldPos;
+      std::vector<utils::Quaternion> localRot, worldRot;
+
+      // per joint
+      std::vector<int> jointLinks;
+      std::vector<std::string> jointNames;
+      std::vector<double> jointValues;
+      std::vector<char> jointChanged;
+      std::map<std::string, int> jointIndexByName;
+      bool changed;
+
+      // buffers of the batched graphics update
+      std::vector<unsigned long> commitIds;
+      std::vector<utils::Vector> commitPos;
+      std::vector<utils::Quaternion> commitRot;
+
+      int addLink(unsigned long drawId, int parent, int type,
+                  const utils::Vector &pivot);
+    };
+
+  } // end of namespace viz
+} // end of namespace mars
+
+#endif // MARS_VIZ_KINEMATIC_TREE_H
@@ -38,7 +38,9 @@
 #include <mars/interfaces/ControllerData.h>
 #include <mars/interfaces/terrainStruct.h>
 #include <mars/utils/mathUtils.h>
+#include <mars/utils/MutexLocker.h>
 #include <QWidget>
+#include <cmath>
 #include <mars/main_gui/MainGUI.h>
 
 #ifdef WIN32
@@ -71,7 +73,9 @@ namespace mars {
     }
 
     Viz::Viz() : lib_manager::LibInterface(new lib_manager::LibManager()),
-                 configDir(".") {
+                 configDir("."), updateRegistered(false), jointLogSample(0),
+                 playing(false), loopPlayback(false), playbackSpeed(1.0),
+                 playbackOffset(0.0), playbackStart(0) {
 #ifdef WIN32
       // request a scheduler of 1ms
       timeBeginPeriod(1);
@@ -79,7 +83,14 @@ namespace mars {
     }
 
     Viz::Viz(lib_manager::LibManager *theManager) : lib_manager::LibInterface(theManager),
-                                                    configDir("."){
+                                                    configDir("."),
+                                                    updateRegistered(false),
+                                                    jointLogSample(0),
+                                                    playing(false),
+                                                    loopPlayback(false),
+                                                    playbackSpeed(1.0),
+                                                    playbackOffset(0.0),
+                                                    playbackStart(0) {
 #ifdef WIN32
       // request a scheduler of 1ms
       timeBeginPeriod(1);
@@ -90,6 +101,7 @@ namespace mars {
       //! close simulation
       exit_main(0);
 
+      if(updateRegistered) graphics->removeGraphicsUpdateInterface(this);
       libManager->releaseLibrary("mars_graphics");
       libManager->releaseLibrary("cfg_manager");
 
@@ -189,7 +201,9 @@ namespace mars {
       load.prepareLoad();
       load.parseScene();
 
-      std::map<std::string, ForwardTransform> jointsI;
+      // link of the kinematic tree by scene node id
+      std::map<unsigned long, int> linkByNode;
+      std::map<unsigned long, int> jointIndexById;
       std::map<unsigned long, NodeData> nodeMapI;
       std::map<unsigned long, NodeData> nodeMapReady;
       std::map<unsigned long, NodeData>::iterator it1;
@@ -279,6 +293,12 @@ namespace mars {
       nodeMapReady.clear();
       it1 = nodeMapI.find(1);
       if(it1!=nodeMapI.end()) {
+        kinematicsMutex.lock();
+        linkByNode[it1->first] = kinematics.addFixedLink(it1->second.index, -1,
+                                                         it1->second.pivot,
+                                                         it1->second.pos,
+                                                         it1->second.rot);
+        kinematicsMutex.unlock();
         nodeMapReady[it1->first] = it1->second;
         nodeMapI.erase(it1);
 
@@ -298,6 +318,13 @@ namespace mars {
                 graphics->makeChild(it1->second.index, it2->second.index);
                 graphics->setDrawObjectPos(node.index, node.pos);
                 graphics->setDrawObjectRot(node.index, node.rot);
+                kinematicsMutex.lock();
+                linkByNode[it2->first] = kinematics.addFixedLink(node.index,
+                                                                 linkByNode[it1->first],
+                                                                 node.pivot,
+                                                                 node.pos,
+                                                                 node.rot);
+                kinematicsMutex.unlock();
 
                 nodeMapReady[it2->first] = it2->second;
                 nodeMapI.erase(it2++);
@@ -331,47 +358,44 @@ namespace mars {
                   // ToDo: - handle second axis for hing2 and universal
                   //       - handle if we have to invert the axis depending on
                   //         on the node order
-                  ForwardTransform ft;
-                  ft.name = jointIt->name;
+                  utils::Vector anchor;
                   if(jointIt->anchorPos == ANCHOR_NODE1) {
-                    ft.anchor = it1->second.pos;
+                    anchor = it1->second.pos;
                   }
                   else if(jointIt->anchorPos == ANCHOR_NODE2) {
-                    ft.anchor = it2->second.pos;
+                    anchor = it2->second.pos;
                   }
                   else if(jointIt->anchorPos == ANCHOR_CENTER) {
-                    ft.anchor = (it1->second.pos + it2->second.pos) * 0.5;
+                    anchor = (it1->second.pos + it2->second.pos) * 0.5;
                   }
                   else {
-                    ft.anchor = jointIt->anchor;
+                    anchor = jointIt->anchor;
                   }
 
-                  ft.anchor = it1->second.rot.inverse() * (ft.anchor - v);
-                  ft.relPos = node.pos - ft.anchor;
-                  ft.axis = it1->second.rot.inverse() * jointIt->axis1;
-                  ft.axis.normalize();
-                  ft.q = node.rot;
+                  anchor = it1->second.rot.inverse() * (anchor - v);
+                  utils::Vector axis = it1->second.rot.inverse() * jointIt->axis1;
+                  axis.normalize();
+                  double offset = jointIt->angle1_offset;
                   if(invert) {
-                    ft.axis *= -1;
-                    ft.value = -jointIt->angle1_offset;
-                    ft.offset = -jointIt->angle1_offset;
+                    axis *= -1;
+                    offset = -offset;
                   }
-                  else {
-                    ft.value = jointIt->angle1_offset;
-                    ft.offset = jointIt->angle1_offset;
-                  }
-                  ft.id = node.index;
-                  ft.jointId = jointIt->index;
+                  KinematicTree::LinkType type = KinematicTree::LINK_REVOLUTE;
                   if(jointIt->type == JOINT_TYPE_SLIDER) {
-                    ft.linear = true;
-                  }
-                  else {
-                    ft.linear = false;
+                    type = KinematicTree::LINK_PRISMATIC;
                   }
 
-                  jointMapByName[jointIt->name] = ft;
-                  jointMapById[ft.jointId] = &jointMapByName[jointIt->name];
-                  jointMapByNodeId[ft.id] = &jointMapByName[jointIt->name];
+                  kinematicsMutex.lock();
+                  int link = kinematics.addJointLink(node.index,
+                                                     linkByNode[it1->first],
+                                                     node.pivot, jointIt->name,
+                                                     type, anchor,
+                                                     node.pos - anchor, axis,
+                                                     node.rot, offset, offset);
+                  int jointIndex = (int)kinematics.getNumJoints()-1;
+                  kinematicsMutex.unlock();
+                  linkByNode[it2->first] = link;
+                  jointIndexById[jointIt->index] = jointIndex;
                   graphics->makeChild(it1->second.index, it2->second.index);
                   graphics->setDrawObjectPos(node.index, node.pos);
                   graphics->setDrawObjectRot(node.index, node.rot);
@@ -390,7 +414,7 @@ namespace mars {
                                                   data_broker::DATA_PACKAGE_READ_WRITE_FLAG);
                     control->dataBroker->registerSyncReceiver(this, "viz",
                                                               packageName,
-                                                              ft.id);
+                                                              jointIndex);
                   }
 
                   nodeMapReady[it2->first] = it2->second;
@@ -412,10 +436,16 @@ namespace mars {
           ControllerData controller;
           controller.fromConfigMap(&load.controllerList[0], tmpPath, NULL);
           for(unsigned int i=0; i<controller.motors.size(); ++i) {
-            jointByControllerIdx.push_back(jointMapById[motorMapById[controller.motors[i]].jointIndex]);
+            std::map<unsigned long, int>::iterator it;
+            it = jointIndexById.find(motorMapById[controller.motors[i]].jointIndex);
+            jointByControllerIdx.push_back(it == jointIndexById.end() ? -1 : it->second);
           }
         }
       }
+      if(!updateRegistered) {
+        graphics->addGraphicsUpdateInterface(this);
+        updateRegistered = true;
+      }
 
       for(it1=nodeMapI.begin(); it1!=nodeMapI.end(); ++it1) {
         nodeMapById[it1->second.index] = it1->second;
@@ -425,31 +455,102 @@ namespace mars {
 
 
     void Viz::setJointValue(std::string jointName, double value) {
-      std::map<std::string, ForwardTransform>::iterator it;
-      it = jointMapByName.find(jointName);
-      if(it!=jointMapByName.end()) {
-        setJointValue(&jointMapByName[jointName], value);
+      utils::MutexLocker locker(&kinematicsMutex);
+      int joint = kinematics.getJointIndex(jointName);
+      if(joint >= 0) {
+        kinematics.setJointValue(joint, value);
       }
     }
 
     void Viz::setJointValue(unsigned int controllerIdx, double value) {
       assert(controllerIdx < jointByControllerIdx.size());
-      setJointValue(jointByControllerIdx[controllerIdx], value);
+      int joint = jointByControllerIdx[controllerIdx];
+      if(joint < 0) return;
+      utils::MutexLocker locker(&kinematicsMutex);
+      kinematics.setJointValue(joint, value);
+    }
+
+    void Viz::setJointValues(const std::vector<double> &values) {
+      utils::MutexLocker locker(&kinematicsMutex);
+      kinematics.setJointValues(values.data(), values.size());
     }
 
-    void Viz::setJointValue(ForwardTransform *joint, double value) {
-      joint->value = value;
-      if(joint->linear) {
-        utils::Vector v = joint->axis*joint->value + joint->relPos;
-        graphics->setDrawObjectPos(joint->id, joint->anchor+v);
+    void Viz::updateKinematics() {
+      utils::MutexLocker locker(&kinematicsMutex);
+      kinematics.update(graphics);
+    }
+
+    bool Viz::loadJointLog(const std::string &filename) {
+      utils::MutexLocker locker(&kinematicsMutex);
+      playing = false;
+      if(!jointLog.loadFile(filename)) {
+        jointLog.clear();
+        return false;
       }
-      else {
-        utils::Quaternion q = utils::angleAxisToQuaternion(joint->value+joint->offset,
-                                                           joint->axis);
-        utils::Vector v = q * joint->relPos;
-        graphics->setDrawObjectPos(joint->id, joint->anchor+v);
-        graphics->setDrawObjectRot(joint->id, q * joint->q);
+      jointLogIndices = kinematics.mapJoints(jointLog.getJointNames());
+      for(size_t i=0; i<jointLogIndices.size(); ++i) {
+        if(jointLogIndices[i] < 0) {
+          fprintf(stderr, "Viz: joint \"%s\" of the joint log is not part of the scene\n",
+                  jointLog.getJointNames()[i].c_str());
+        }
       }
+      jointLogValues.resize(jointLogIndices.size());
+      jointLogSample = 0;
+      applyJointLog(jointLog.getStartTime());
+      return true;
+    }
+
+    void Viz::playJointLog(double speed, bool loop) {
+      utils::MutexLocker locker(&kinematicsMutex);
+      if(jointLog.empty()) return;
+      playbackSpeed = speed;
+      loopPlayback = loop;
+      playbackOffset = jointLog.getStartTime();
+      playbackStart = utils::getTime();
+      jointLogSample = 0;
+      playing = true;
+    }
+
+    void Viz::stopJointLog() {
+      utils::MutexLocker locker(&kinematicsMutex);
+      playing = false;
+    }
+
+    void Viz::seekJointLog(double time) {
+      utils::MutexLocker locker(&kinematicsMutex);
+      if(jointLog.empty()) return;
+      if(playing) {
+        playbackOffset = time;
+        playbackStart = utils::getTime();
+      }
+      applyJointLog(time);
+    }
+
+    void Viz::applyJointLog(double time) {
+      jointLogSample = jointLog.interpolate(time, jointLogValues.data(),
+                                            jointLogSample);
+      kinematics.setJointValues(jointLogIndices, jointLogValues.data());
+    }
+
+    void Viz::preGraphicsUpdate(void) {
+      utils::MutexLocker locker(&kinematicsMutex);
+      if(playing) {
+        double time = (playbackOffset +
+                       utils::getTimeDiff(playbackStart)*0.001*playbackSpeed);
+        double duration = jointLog.getEndTime() - jointLog.getStartTime();
+        if(time > jointLog.getEndTime()) {
+          if(loopPlayback && duration > 0.0) {
+            time = (jointLog.getStartTime() +
+                    fmod(time - jointLog.getStartTime(), duration));
+          }
+          else {
+            time = jointLog.getEndTime();
+            playing = false;
+          }
+        }
+        applyJointLog(time);
+      }
+      kinematics.update(graphics);
     }
 
     void Viz::setNodePosition(const std::string &nodeName, const utils::Vector &pos) {
@@ -481,7 +582,11 @@ namespace mars {
                           int id) {
       double value;
       package.get(0, &value);
-      setJointValue(jointMapByNodeId[id], value);
+      // the callback parameter is the joint index
+      utils::MutexLocker locker(&kinematicsMutex);
+      if(id >= 0 && id < (int)kinematics.getNumJoints()) {
+        kinematics.setJointValue(id, value);
+      }
       // package.get("force1/x", force);
     }
 
@@ -32,31 +32,29 @@
   #warning "Viz.h"
 #endif
 
+#include "KinematicTree.h"
+
 #include <lib_manager/LibInterface.hpp>
 #include <mars/interfaces/sim/ControlCenter.h>
 #include <mars/interfaces/NodeData.h>
+#include <mars/interfaces/graphics/GraphicsUpdateInterface.h>
 #include <mars/data_broker/ReceiverInterface.h>
+#include <mars/utils/Mutex.h>
 
 namespace mars {
 
   namespace viz {
 
-    struct ForwardTransform {
-      utils::Vector anchor;
-      utils::Vector relPos;
-      utils::Vector axis;
-      utils::Quaternion q;
-      double value, offset;
-      unsigned long id;
-      unsigned long jointId;
-      bool linear;
-      std::string name;
-    };
-
     void exit_main(int signal);
 
+    /**
+     * Joint values are only stored when they are set. The kinematic tree is
+     * evaluated and committed to the graphics once per frame in
+     * preGraphicsUpdate or by calling updateKinematics.
+     */
     class Viz : public lib_manager::LibInterface,
-                public data_broker::ReceiverInterface {
+                public data_broker::ReceiverInterface,
+                public interfaces::GraphicsUpdateInterface {
     public:
       Viz();
       Viz(lib_manager::LibManager *theManager);
@@ -74,6 +72,19 @@ namespace mars {
       void loadScene(std::string filename, std::string robotname="");
       void setJointValue(std::string jointName, double value);
       void setJointValue(unsigned int controllerIdx, double value);
+      /** \brief Sets all joints in the order of getJointNames. */
+      void setJointValues(const std::vector<double> &values);
+      const std::vector<std::string>& getJointNames() const
+      { return kinematics.getJointNames(); }
+      /** \brief Commits the joint values set since the last frame. */
+      void updateKinematics();
+
+      /** \brief Loads a joint log, see JointTrajectory for the format. */
+      bool loadJointLog(const std::string &filename);
+      void playJointLog(double speed=1.0, bool loop=false);
+      void stopJointLog();
+      /** \brief Shows the logged joint values at \a time in seconds. */
+      void seekJointLog(double time);
       void setNodePosition(const std::string &nodeName,
                            const utils::Vector &pos);
       void setNodePosition(const unsigned long &id, const utils::Vector &pos);
@@ -88,19 +99,32 @@ namespace mars {
                                const data_broker::DataPackage &package,
                                int callbackParam);
 
+      // GraphicsUpdateInterface
+      virtual void preGraphicsUpdate(void);
+
 
     private:
       std::string configDir;
 
       std::map<unsigned long, interfaces::NodeData> nodeMapById;
       std::map<std::string, interfaces::NodeData> nodeMapByName;
-      std::map<std::string, ForwardTransform> jointMapByName;
-      std::map<unsigned long, ForwardTransform*> jointMapById;
-      std::map<unsigned long, ForwardTransform*> jointMapByNodeId;
-      std::vector<ForwardTransform*> jointByControllerIdx;
+      std::vector<int> jointByControllerIdx;
       interfaces::ControlCenter *control;
 
-      void setJointValue(ForwardTransform *joint, double value);
+      // guards the joint values, they are set from the DataBroker
+      utils::Mutex kinematicsMutex;
+      KinematicTree kinematics;
+      bool updateRegistered;
+
+      JointTrajectory jointLog;
+      std::vector<int> jointLogIndices;
+      std::vector<double> jointLogValues;
+      size_t jointLogSample;
+      bool playing, loopPlayback;
+      double playbackSpeed, playbackOffset;
+      long long playbackStart;
+
+      void applyJointLog(double time);
 
     };
 